@@ -0,0 +1,280 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "bench.h"
+#include "config.h"
+#include "psx_bitbang.h"
+#include "shared_state.h"
+#include "button_input.h"
+#include "socd.h"
+#include "log_queue.h"
+#include "psx_device.h"
+#include "hardware/clocks.h"
+#include "hardware/structs/systick.h"
+#include "hardware/sync.h"
+#include "pico/multicore.h"
+#include "pico/stdlib.h"
+#include <stdio.h>
+
+// External Core1 entry point
+extern void core1_entry(void);
+extern void core1_stop(void);
+
+// ============================================================================
+// Benchmark Cases
+// ============================================================================
+
+// Results are stored so calls are not optimised away
+static volatile uint32_t sink;
+
+static void case_empty(void)
+{
+}
+
+static void case_wait_clk_rising(void)
+{
+    // CLK idles HIGH: returns on the first check
+    sink = psx_wait_clk_rising(PSX_CLK_TIMEOUT_US);
+}
+
+static void case_wait_clk_falling(void)
+{
+    // One polling pass (timeout and SEL checks), then abort on SEL HIGH
+    sink = psx_wait_clk_falling(PSX_CLK_TIMEOUT_US);
+}
+
+static void case_transfer_byte(void)
+{
+    sink = psx_transfer_byte(PSX_ID_DIGITAL_HI);
+}
+
+static void case_send_ack(void)
+{
+    psx_send_ack();
+}
+
+static void case_shared_state_write(void)
+{
+    shared_state_write(0, 0xFF, 0xFF);
+}
+
+static void case_shared_state_read(void)
+{
+    uint8_t btn1, btn2;
+    shared_state_read(0, &btn1, &btn2);
+    sink = btn1 | (btn2 << 8);
+}
+
+static void case_button_read_byte1(void)
+{
+    sink = button_read_byte1();
+}
+
+static void case_button_read_byte2(void)
+{
+    sink = button_read_byte2();
+}
+
+static void case_socd_apply(void)
+{
+    // LEFT+RIGHT and UP+DOWN held: every call resolves both axes
+    static uint32_t now = 0;
+    uint8_t btn1 = (uint8_t)~((1u << PSX_BTN_LEFT) | (1u << PSX_BTN_RIGHT) |
+                              (1u << PSX_BTN_UP) | (1u << PSX_BTN_DOWN));
+    sink = socd_apply(btn1, now += 1000);
+}
+
+static void case_socd_resolve_latched(void)
+{
+    uint8_t latched = (uint8_t)~((1u << PSX_BTN_LEFT) | (1u << PSX_BTN_RIGHT));
+    sink = socd_resolve_latched(latched, (uint8_t)~(1u << PSX_BTN_LEFT));
+}
+
+static void case_log_push(void)
+{
+    // Largest message: all arguments copied
+    LOG_PUSH(LOG_ACK_TUNE_BEST, 3, 1, 87, 5, 7, 8);
+}
+
+static void case_device_dispatch(void)
+{
+    // Next address each call, so the run covers every table entry
+    static uint8_t addr = 0;
+    sink = (uint32_t)(uintptr_t)psx_device_for(addr++);
+}
+
+typedef struct
+{
+    const char *name;
+    void (*run)(void);
+    bool idle_bus;       // Only measured while the console is not selecting us
+    void (*setup)(void); // Run before each measurement, not timed (optional)
+} bench_case_t;
+
+static const bench_case_t cases[] = {
+    {"psx_wait_clk_rising_idle", case_wait_clk_rising, true, NULL},
+    {"psx_wait_clk_falling_poll", case_wait_clk_falling, true, NULL},
+    {"psx_transfer_byte_abort", case_transfer_byte, true, NULL},
+    {"psx_send_ack", case_send_ack, true, NULL},
+    {"shared_state_write", case_shared_state_write, false, NULL},
+    {"shared_state_read", case_shared_state_read, false, NULL},
+    {"button_read_byte1", case_button_read_byte1, false, NULL},
+    {"button_read_byte2", case_button_read_byte2, false, NULL},
+    {"socd_apply", case_socd_apply, false, NULL},
+    {"socd_resolve_latched", case_socd_resolve_latched, false, NULL},
+    {"log_push", case_log_push, false, log_discard}, // Empty queue: the enqueue, not the drop path
+    {"psx_device_dispatch", case_device_dispatch, false, NULL},
+};
+
+// ============================================================================
+// Cycle Counter
+// ============================================================================
+
+static uint32_t saved_csr = 0;
+static uint32_t saved_rvr = 0;
+
+void bench_cycles_start(void)
+{
+    // SysTick from the processor clock, free running over the full 24 bits
+    saved_csr = systick_hw->csr;
+    saved_rvr = systick_hw->rvr;
+    systick_hw->rvr = 0x00FFFFFF;
+    systick_hw->cvr = 0;
+    systick_hw->csr = 0x5; // ENABLE | CLKSOURCE (processor clock)
+}
+
+void bench_cycles_stop(void)
+{
+    systick_hw->csr = saved_csr;
+    systick_hw->rvr = saved_rvr;
+}
+
+uint32_t __not_in_flash_func(bench_cycles_now)(void)
+{
+    return systick_hw->cvr;
+}
+
+// ============================================================================
+// Measurement
+// ============================================================================
+
+typedef struct
+{
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+    uint32_t count;
+} bench_result_t;
+
+static uint32_t __not_in_flash_func(measure)(void (*run)(void))
+{
+    uint32_t ints = save_and_disable_interrupts();
+    uint32_t start = systick_hw->cvr;
+    run();
+    uint32_t end = systick_hw->cvr;
+    restore_interrupts(ints);
+    return bench_cycles_between(start, end);
+}
+
+static void run_case(const bench_case_t *bench, uint32_t overhead, bench_result_t *result)
+{
+    result->min = UINT32_MAX;
+    result->max = 0;
+    result->total = 0;
+    result->count = 0;
+
+    for (int i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        if (bench->idle_bus && !psx_read_sel())
+        {
+            continue; // Console is talking - never touch the bus mid-transaction
+        }
+
+        if (bench->setup)
+        {
+            bench->setup();
+        }
+
+        uint32_t cycles = measure(bench->run);
+        cycles = cycles > overhead ? cycles - overhead : 0;
+
+        if (cycles < result->min)
+        {
+            result->min = cycles;
+        }
+        if (cycles > result->max)
+        {
+            result->max = cycles;
+        }
+        result->total += cycles;
+        result->count++;
+    }
+}
+
+void bench_run(void)
+{
+    uint32_t clk_hz = clock_get_hz(clk_sys);
+
+    // Core 1 owns the bus and the consumer side of the shared state
+    core1_stop();
+    psx_release_bus();
+
+    // Print what Core 1 queued before the log_push case discards it
+    log_flush(LOG_QUEUE_SIZE);
+
+    bench_cycles_start();
+
+    // Cost of the measurement itself (call through pointer, SysTick reads)
+    uint32_t overhead = UINT32_MAX;
+    for (int i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        uint32_t cycles = measure(case_empty);
+        if (cycles < overhead)
+        {
+            overhead = cycles;
+        }
+    }
+
+    printf("\nBENCH,clk_sys,%lu\n", clk_hz);
+    printf("BENCH,case,iterations,min_cycles,avg_cycles,max_cycles,avg_ns\n");
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        bench_result_t result;
+        run_case(&cases[i], overhead, &result);
+
+        if (result.count == 0)
+        {
+            printf("BENCH,%s,0,,,,\n", cases[i].name);
+            continue;
+        }
+
+        uint32_t avg = (uint32_t)(result.total / result.count);
+        uint32_t avg_ns = (uint32_t)((uint64_t)avg * 1000000000ull / clk_hz);
+        printf("BENCH,%s,%lu,%lu,%lu,%lu,%lu\n",
+               cases[i].name, result.count, result.min, avg, result.max, avg_ns);
+    }
+    printf("\n");
+
+    bench_cycles_stop();
+
+    // Entries pushed by the log_push case are not real messages
+    log_discard();
+
+    // Shared state may have been consumed by the benchmark - republished on the next sample
+    multicore_launch_core1(core1_entry);
+}
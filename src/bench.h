@@ -0,0 +1,64 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+
+// ============================================================================
+// Hot-Path Micro-Benchmarks
+// ============================================================================
+
+// Each case is timed with the SysTick counter running at clk_sys, one call
+// per measurement with interrupts disabled; the cost of an empty call is
+// subtracted. Core 1 is stopped for the run and relaunched afterwards.
+//
+// Output is one CSV line per case so runs can be collected and compared:
+//   BENCH,<case>,<iterations>,<min cycles>,<avg cycles>,<max cycles>,<avg ns>
+// preceded by "BENCH,clk_sys,<Hz>".
+//
+// Bus functions run on the port 1 pins with the console idle (SEL HIGH),
+// so they measure the idle-bus paths: an edge wait that succeeds at once,
+// one polling pass of an edge wait, and a transfer aborted by SEL. The
+// per-bit cost under a running clock needs a clock source and is not covered.
+
+#define BENCH_ITERATIONS 1000
+
+// Core 0: Run all cases and print the results
+void bench_run(void);
+
+// ============================================================================
+// Cycle Counter
+// ============================================================================
+
+// SysTick as a free-running 24-bit down-counter at clk_sys (wraps every
+// ~134ms at 125MHz). Start/stop save and restore the previous SysTick setup.
+void bench_cycles_start(void);
+void bench_cycles_stop(void);
+
+// Current counter value
+uint32_t bench_cycles_now(void);
+
+// Cycles from `from` to `to` (both bench_cycles_now() values)
+static inline uint32_t bench_cycles_between(uint32_t from, uint32_t to)
+{
+    return (from - to) & 0x00FFFFFF;
+}
+
+#endif // BENCH_H
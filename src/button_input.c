@@ -19,111 +19,151 @@
 #include "button_input.h"
 #include "config.h"
 #include "hardware/gpio.h"
+#include <string.h>
 
 // ============================================================================
-// Button Input Implementation
+// Remap Table State
 // ============================================================================
 
-void button_input_init(void)
-{
-    // Initialize all button pins as inputs with pull-ups
-    // Buttons are active LOW (pressed = LOW)
+// Default layout generated from config.h at compile time
+const button_map_t button_map_default = {{
+    [PSX_BTN_SELECT] = BTN_SELECT,
+    [PSX_BTN_L3] = BTN_L3,
+    [PSX_BTN_R3] = BTN_R3,
+    [PSX_BTN_START] = BTN_START,
+    [PSX_BTN_UP] = BTN_UP,
+    [PSX_BTN_RIGHT] = BTN_RIGHT,
+    [PSX_BTN_DOWN] = BTN_DOWN,
+    [PSX_BTN_LEFT] = BTN_LEFT,
+    [PSX_BTN_L2] = BTN_L2,
+    [PSX_BTN_R2] = BTN_R2,
+    [PSX_BTN_L1] = BTN_L1,
+    [PSX_BTN_R1] = BTN_R1,
+    [PSX_BTN_TRIANGLE] = BTN_TRIANGLE,
+    [PSX_BTN_CIRCLE] = BTN_CIRCLE,
+    [PSX_BTN_CROSS] = BTN_CROSS,
+    [PSX_BTN_SQUARE] = BTN_SQUARE,
+}};
 
-    // Face buttons
-    gpio_init(BTN_CIRCLE);
-    gpio_set_dir(BTN_CIRCLE, GPIO_IN);
-    gpio_pull_up(BTN_CIRCLE);
+static button_map_t profiles[BUTTON_MAP_PROFILE_COUNT];
+static uint8_t active_profile = 0;
 
-    gpio_init(BTN_CROSS);
-    gpio_set_dir(BTN_CROSS, GPIO_IN);
-    gpio_pull_up(BTN_CROSS);
+// GPIO mask per PSX bit for the active profile (0 = unassigned)
+// Rebuilt whenever the active map changes so reading is a pure table transform
+static uint32_t gpio_masks[PSX_BTN_COUNT];
 
-    gpio_init(BTN_TRIANGLE);
-    gpio_set_dir(BTN_TRIANGLE, GPIO_IN);
-    gpio_pull_up(BTN_TRIANGLE);
+// GPIOs currently configured as button inputs (union of gpio_masks)
+static uint32_t configured_pins = 0;
+
+static const char *const button_names[PSX_BTN_COUNT] = {
+    "select", "l3", "r3", "start", "up", "right", "down", "left",
+    "l2", "r2", "l1", "r1", "triangle", "circle", "cross", "square",
+};
+
+// ============================================================================
+// Internal Functions
+// ============================================================================
 
-    gpio_init(BTN_SQUARE);
-    gpio_set_dir(BTN_SQUARE, GPIO_IN);
-    gpio_pull_up(BTN_SQUARE);
+static void button_gpio_init(uint8_t gpio)
+{
+    // Buttons are active LOW (pressed = LOW) with internal pull-ups
+    gpio_init(gpio);
+    gpio_set_dir(gpio, GPIO_IN);
+    gpio_pull_up(gpio);
+}
 
-    // Shoulder buttons
-    gpio_init(BTN_L1);
-    gpio_set_dir(BTN_L1, GPIO_IN);
-    gpio_pull_up(BTN_L1);
+static void button_gpio_deinit(uint8_t gpio)
+{
+    // Hand the pin back without its pull-up (it may be wired to something else)
+    gpio_disable_pulls(gpio);
+    gpio_deinit(gpio);
+}
 
-    gpio_init(BTN_R1);
-    gpio_set_dir(BTN_R1, GPIO_IN);
-    gpio_pull_up(BTN_R1);
+static void apply_active_map(void)
+{
+    const button_map_t *map = &profiles[active_profile];
+    uint32_t pins = 0;
 
-    gpio_init(BTN_L2);
-    gpio_set_dir(BTN_L2, GPIO_IN);
-    gpio_pull_up(BTN_L2);
+    for (int i = 0; i < PSX_BTN_COUNT; i++)
+    {
+        uint8_t gpio = map->gpio[i];
+        if (gpio == BTN_UNASSIGNED)
+        {
+            gpio_masks[i] = 0;
+        }
+        else
+        {
+            // Newly assigned pins need their pull-up configured
+            if (!(configured_pins & (1u << gpio)))
+            {
+                button_gpio_init(gpio);
+            }
+            gpio_masks[i] = 1u << gpio;
+            pins |= 1u << gpio;
+        }
+    }
 
-    gpio_init(BTN_R2);
-    gpio_set_dir(BTN_R2, GPIO_IN);
-    gpio_pull_up(BTN_R2);
+    // Release pins the previous map used and this one doesn't
+    uint32_t dropped = configured_pins & ~pins;
+    for (uint8_t gpio = 0; gpio < NUM_BANK0_GPIOS; gpio++)
+    {
+        if (dropped & (1u << gpio))
+        {
+            button_gpio_deinit(gpio);
+        }
+    }
+    configured_pins = pins;
+}
 
-    // D-pad
-    gpio_init(BTN_UP);
-    gpio_set_dir(BTN_UP, GPIO_IN);
-    gpio_pull_up(BTN_UP);
+// ============================================================================
+// Button Input Implementation
+// ============================================================================
 
-    gpio_init(BTN_DOWN);
-    gpio_set_dir(BTN_DOWN, GPIO_IN);
-    gpio_pull_up(BTN_DOWN);
+void button_input_init(void)
+{
+    // All profiles start as the config.h layout
+    for (int p = 0; p < BUTTON_MAP_PROFILE_COUNT; p++)
+    {
+        profiles[p] = button_map_default;
+    }
+    active_profile = 0;
 
-    gpio_init(BTN_LEFT);
-    gpio_set_dir(BTN_LEFT, GPIO_IN);
-    gpio_pull_up(BTN_LEFT);
+    // Initialize all button pins as inputs with pull-ups
+    configured_pins = 0;
+    apply_active_map();
+}
 
-    gpio_init(BTN_RIGHT);
-    gpio_set_dir(BTN_RIGHT, GPIO_IN);
-    gpio_pull_up(BTN_RIGHT);
+uint16_t button_read_all(void)
+{
+    // Button pressed = LOW (0) on GPIO
+    // PSX protocol: pressed = 0, released = 1
+    // Read the whole bank once, then map each PSX bit through its GPIO mask
+    uint32_t pressed = ~gpio_get_all();
+    uint16_t state = 0xFFFF; // Start with all released
 
-    // System buttons
-    gpio_init(BTN_START);
-    gpio_set_dir(BTN_START, GPIO_IN);
-    gpio_pull_up(BTN_START);
+    for (int i = 0; i < PSX_BTN_COUNT; i++)
+    {
+        if (pressed & gpio_masks[i])
+        {
+            state &= ~(1u << i);
+        }
+    }
 
-    gpio_init(BTN_SELECT);
-    gpio_set_dir(BTN_SELECT, GPIO_IN);
-    gpio_pull_up(BTN_SELECT);
+    return state;
 }
 
 uint8_t button_read_byte1(void)
 {
     // PSX format byte 1:
     // bit 0 = SELECT
-    // bit 1 = L3 (not used in digital mode, always 1)
-    // bit 2 = R3 (not used in digital mode, always 1)
+    // bit 1 = L3 (BTN_UNASSIGNED by default, always 1)
+    // bit 2 = R3 (BTN_UNASSIGNED by default, always 1)
     // bit 3 = START
     // bit 4 = UP
     // bit 5 = RIGHT
     // bit 6 = DOWN
     // bit 7 = LEFT
-    //
-    // Button pressed = LOW (0) on GPIO
-    // PSX protocol: pressed = 0, released = 1
-    // So we can read GPIO directly (inverted logic matches)
-
-    uint8_t byte1 = 0xFF; // Start with all released
-
-    // Read buttons and clear corresponding bits if pressed
-    if (!gpio_get(BTN_SELECT))
-        byte1 &= ~(1 << 0);
-    // L3 and R3 not implemented (bits 1 and 2 stay 1)
-    if (!gpio_get(BTN_START))
-        byte1 &= ~(1 << 3);
-    if (!gpio_get(BTN_UP))
-        byte1 &= ~(1 << 4);
-    if (!gpio_get(BTN_RIGHT))
-        byte1 &= ~(1 << 5);
-    if (!gpio_get(BTN_DOWN))
-        byte1 &= ~(1 << 6);
-    if (!gpio_get(BTN_LEFT))
-        byte1 &= ~(1 << 7);
-
-    return byte1;
+    return (uint8_t)(button_read_all() & 0xFF);
 }
 
 uint8_t button_read_byte2(void)
@@ -137,26 +177,152 @@ uint8_t button_read_byte2(void)
     // bit 5 = Circle
     // bit 6 = Cross
     // bit 7 = Square
+    return (uint8_t)(button_read_all() >> 8);
+}
 
-    uint8_t byte2 = 0xFF; // Start with all released
-
-    // Read buttons and clear corresponding bits if pressed
-    if (!gpio_get(BTN_L2))
-        byte2 &= ~(1 << 0);
-    if (!gpio_get(BTN_R2))
-        byte2 &= ~(1 << 1);
-    if (!gpio_get(BTN_L1))
-        byte2 &= ~(1 << 2);
-    if (!gpio_get(BTN_R1))
-        byte2 &= ~(1 << 3);
-    if (!gpio_get(BTN_TRIANGLE))
-        byte2 &= ~(1 << 4);
-    if (!gpio_get(BTN_CIRCLE))
-        byte2 &= ~(1 << 5);
-    if (!gpio_get(BTN_CROSS))
-        byte2 &= ~(1 << 6);
-    if (!gpio_get(BTN_SQUARE))
-        byte2 &= ~(1 << 7);
-
-    return byte2;
+// ============================================================================
+// Remap Profiles
+// ============================================================================
+
+bool button_gpio_valid(uint8_t gpio)
+{
+    if (gpio == BTN_UNASSIGNED)
+    {
+        return true;
+    }
+    if (gpio >= NUM_BANK0_GPIOS)
+    {
+        return false;
+    }
+
+    // Never take over PSX bus lines or the status LED
+    switch (gpio)
+    {
+    case PIN_DAT:
+    case PIN_CMD:
+    case PIN_SEL:
+    case PIN_CLK:
+    case PIN_ACK:
+    case LED_PIN:
+        return false;
+    default:
+        break;
+    }
+
+#if PSX_PORT_COUNT > 1
+    switch (gpio)
+    {
+    case PIN2_DAT:
+    case PIN2_CMD:
+    case PIN2_SEL:
+    case PIN2_CLK:
+    case PIN2_ACK:
+        return false;
+    default:
+        break;
+    }
+#else
+    // Self-test jumpers (their pins belong to port 2 when it is enabled)
+    switch (gpio)
+    {
+    case SELFTEST_PIN_SEL:
+    case SELFTEST_PIN_CLK:
+    case SELFTEST_PIN_CMD:
+    case SELFTEST_PIN_DAT:
+    case SELFTEST_PIN_ACK:
+        return false;
+    default:
+        break;
+    }
+#endif
+
+    return true;
+}
+
+const button_map_t *button_map_get(uint8_t profile)
+{
+    if (profile >= BUTTON_MAP_PROFILE_COUNT)
+    {
+        return NULL;
+    }
+    return &profiles[profile];
+}
+
+bool button_map_load(uint8_t profile, const button_map_t *map)
+{
+    if (profile >= BUTTON_MAP_PROFILE_COUNT)
+    {
+        return false;
+    }
+    for (int i = 0; i < PSX_BTN_COUNT; i++)
+    {
+        if (!button_gpio_valid(map->gpio[i]))
+        {
+            return false;
+        }
+    }
+
+    profiles[profile] = *map;
+    if (profile == active_profile)
+    {
+        apply_active_map();
+    }
+    return true;
+}
+
+bool button_map_set(uint8_t profile, psx_button_t button, uint8_t gpio)
+{
+    if (profile >= BUTTON_MAP_PROFILE_COUNT || button >= PSX_BTN_COUNT || !button_gpio_valid(gpio))
+    {
+        return false;
+    }
+
+    profiles[profile].gpio[button] = gpio;
+    if (profile == active_profile)
+    {
+        apply_active_map();
+    }
+    return true;
+}
+
+void button_map_reset(uint8_t profile)
+{
+    button_map_load(profile, &button_map_default);
+}
+
+bool button_map_select(uint8_t profile)
+{
+    if (profile >= BUTTON_MAP_PROFILE_COUNT)
+    {
+        return false;
+    }
+    active_profile = profile;
+    apply_active_map();
+    return true;
+}
+
+uint8_t button_map_active(void)
+{
+    return active_profile;
+}
+
+const char *button_name(psx_button_t button)
+{
+    if (button >= PSX_BTN_COUNT)
+    {
+        return "?";
+    }
+    return button_names[button];
+}
+
+psx_button_t button_parse_name(const char *name)
+{
+    for (int i = 0; i < PSX_BTN_COUNT; i++)
+    {
+        if (strcmp(name, button_names[i]) == 0)
+        {
+            return (psx_button_t)i;
+        }
+    }
+    return PSX_BTN_COUNT;
 }
@@ -20,14 +20,61 @@
 #define BUTTON_INPUT_H
 
 #include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+
+// ============================================================================
+// PSX Button Bits
+// ============================================================================
+
+// Bit positions in the 16-bit button word
+// Low byte = PSX byte 1 (buttons1), high byte = PSX byte 2 (buttons2)
+// PSX protocol: pressed = 0, released = 1
+typedef enum
+{
+    PSX_BTN_SELECT = 0,
+    PSX_BTN_L3,
+    PSX_BTN_R3,
+    PSX_BTN_START,
+    PSX_BTN_UP,
+    PSX_BTN_RIGHT,
+    PSX_BTN_DOWN,
+    PSX_BTN_LEFT,
+    PSX_BTN_L2,
+    PSX_BTN_R2,
+    PSX_BTN_L1,
+    PSX_BTN_R1,
+    PSX_BTN_TRIANGLE,
+    PSX_BTN_CIRCLE,
+    PSX_BTN_CROSS,
+    PSX_BTN_SQUARE,
+    PSX_BTN_COUNT
+} psx_button_t;
+
+// ============================================================================
+// Button Remap Table
+// ============================================================================
+
+// Physical GPIO for each PSX button (BTN_UNASSIGNED = never pressed)
+typedef struct
+{
+    uint8_t gpio[PSX_BTN_COUNT];
+} button_map_t;
+
+// Default layout built from the BTN_* definitions in config.h
+extern const button_map_t button_map_default;
 
 // ============================================================================
 // Button Input Management
 // ============================================================================
 
-// Initialize all button GPIO pins
+// Initialize all button GPIO pins and reset every profile to the default map
 void button_input_init(void);
 
+// Read all buttons through the active remap table
+// Returns 16-bit button word (low byte = byte 1, high byte = byte 2)
+uint16_t button_read_all(void);
+
 // Read all buttons and return PSX format byte 1
 // bit 0 = SELECT
 // bit 1 = L3 (not used in digital mode, always 1)
@@ -50,4 +97,38 @@ uint8_t button_read_byte1(void);
 // bit 7 = Square
 uint8_t button_read_byte2(void);
 
+// ============================================================================
+// Remap Profiles
+// ============================================================================
+
+// Get a profile's map (NULL if index is out of range)
+const button_map_t *button_map_get(uint8_t profile);
+
+// Replace a whole profile (e.g. loaded from flash)
+// Returns false if the map contains a GPIO that cannot be used as a button
+bool button_map_load(uint8_t profile, const button_map_t *map);
+
+// Assign a GPIO (or BTN_UNASSIGNED) to one PSX button in a profile
+// Returns false if the profile or GPIO is invalid
+bool button_map_set(uint8_t profile, psx_button_t button, uint8_t gpio);
+
+// Reset a profile to the config.h default layout
+void button_map_reset(uint8_t profile);
+
+// Select the active profile used by button_read_all()
+bool button_map_select(uint8_t profile);
+
+// Get the active profile index
+uint8_t button_map_active(void);
+
+// Check whether a GPIO can be used as a button input
+// (bus, self-test and LED pins are rejected)
+bool button_gpio_valid(uint8_t gpio);
+
+// Button names for the serial console ("select", "up", "cross", ...)
+const char *button_name(psx_button_t button);
+
+// Parse a button name, returns PSX_BTN_COUNT if unknown
+psx_button_t button_parse_name(const char *name);
+
 #endif // BUTTON_INPUT_H
@@ -31,6 +31,31 @@
 #define PIN_CLK 6  // Clock (Input from PSX, ~250kHz)
 #define PIN_ACK 7  // Acknowledge (Open-drain output to PSX)
 
+// Number of console ports served (1 or 2)
+// Port 2 is a second controller on its own pin set; it may be the second
+// port of the same console or a different console. Both ports are served by
+// the Core 1 bus loop, one transaction at a time.
+#ifndef PSX_PORT_COUNT
+#define PSX_PORT_COUNT 1
+#endif
+
+// Port 2 pin set (only used when PSX_PORT_COUNT is 2)
+#define PIN2_DAT 2  // Data line (Open-drain, bidirectional)
+#define PIN2_CMD 5  // Command line (Input from PSX)
+#define PIN2_SEL 9  // Select/Chip Select (Input from PSX, Active LOW)
+#define PIN2_CLK 8  // Clock (Input from PSX)
+#define PIN2_ACK 28 // Acknowledge (Open-drain output to PSX)
+
+// Loopback self-test: Core 0 plays the console on these spare pins
+// Jumper each one to the port 1 bus pin named in the comment.
+// They overlap the port 2 pin set, so the self-test is unavailable
+// when PSX_PORT_COUNT is 2.
+#define SELFTEST_PIN_SEL 0 // -> PIN_SEL (output)
+#define SELFTEST_PIN_CLK 1 // -> PIN_CLK (output)
+#define SELFTEST_PIN_CMD 2 // -> PIN_CMD (output)
+#define SELFTEST_PIN_DAT 5 // <- PIN_DAT (input, pull-up)
+#define SELFTEST_PIN_ACK 8 // <- PIN_ACK (input, pull-up)
+
 // ============================================================================
 // Button Input GPIO Pin Definitions 
 // ============================================================================
@@ -57,12 +82,35 @@
 #define BTN_START 26
 #define BTN_SELECT 27
 
+// Stick buttons (not wired by default, assign a GPIO to enable)
+#define BTN_L3 BTN_UNASSIGNED
+#define BTN_R3 BTN_UNASSIGNED
+
+// Marker for a PSX button with no physical input
+#define BTN_UNASSIGNED 0xFF
+
+// Number of runtime button map profiles (profile 0 starts as the layout above)
+#define BUTTON_MAP_PROFILE_COUNT 4
+
 // ============================================================================
 // Status LED
 // ============================================================================
 
 #define LED_PIN PICO_DEFAULT_LED_PIN // GPIO 25
 
+// ============================================================================
+// System Clock
+// ============================================================================
+
+// clk_sys in kHz, set before USB/stdio start. 125000 = SDK default.
+// 200000-250000 shortens Core 1's reaction to CLK edges at PS2 bus speeds;
+// use "selftest sysclk" to compare the edge-to-DAT latency per clock.
+// The bus delays run on the 1MHz timer and are not affected by the clock.
+#define SYS_CLOCK_KHZ 125000
+
+// Core voltage used above 133MHz (and during the self-test clock sweep)
+#define SYS_CLOCK_VREG_VOLTAGE VREG_VOLTAGE_1_20
+
 // ============================================================================
 // Timing Constants
 // ============================================================================
@@ -73,6 +121,32 @@
 #define PSX_BYTE_TIMEOUT_US 200  // Timeout for byte reception
 #define PSX_CLK_TIMEOUT_US 200   // Timeout for individual clock edge - increased from 50µs
 
+// Bus speed detection
+// The CLK period is measured on every address byte and a timing profile
+// (edge timeout, pre-ACK delay, ACK width, post-ACK wait) is picked to match:
+// PS1 ~250kHz, PS2 ~500kHz, or faster. PSX_CLK_TIMEOUT_US applies to the PS1 profile.
+#define PSX_TIMING_CONFIRM 4           // Consecutive address bytes needed to switch profile
+#define PSX_TIMING_HYSTERESIS_KHZ 100 // A profile is left downwards only this far below its min_khz
+
+// Adaptive edge timeouts (capped by the profile's edge timeout)
+// Inside a byte: measured clock period x PSX_TIMEOUT_INTRA_PERIODS + slack
+// Before each following byte: running gap estimate x PSX_TIMEOUT_INTER_FACTOR + slack
+// A timeout while SEL is still LOW resets the gap estimate to the profile limit.
+#define PSX_TIMEOUT_INTRA_PERIODS 4
+#define PSX_TIMEOUT_INTER_FACTOR 2
+#define PSX_TIMEOUT_SLACK_US 4
+
+// Core 1 idle between transactions
+// 1: sleep with WFE, woken by a SEL falling-edge IRQ (default)
+// 0: spin on SEL (full power)
+#define PSX_IDLE_WFE 1
+#define PSX_SEL_SETTLE_NS 1000 // SEL must stay LOW this long before the address byte; wake latency counts towards it
+#define PSX_IDLE_CORE_MA 8     // Rough current of one busy core at 125MHz, for the power estimate only
+
+// Core 0 stops Core 1 (flash write, bench, sniffer) only between transactions;
+// a memory card frame is the longest it has to wait for
+#define PSX_PARK_TIMEOUT_US 20000
+
 // ============================================================================
 // ACK Timing Configuration
 // ============================================================================
@@ -97,11 +171,16 @@
 #define ACK_TUNE_TIMEOUT_US 10000000       // Max wait time per setting (10 seconds)
 #define ACK_TUNE_CMD_SUCCESS_THRESHOLD 0.5 // Command success rate threshold (50%)
 #define ACK_TUNE_IDLE_TIMEOUT_US 5000000   // Reset tuning if no transaction for 5 seconds
+#define ACK_PRE_DELAY_US 5                 // Wait before asserting ACK (5µs)
 #else
-// Fixed ACK timing (when auto-tune is disabled)
+#define ACK_PRE_DELAY_US ACK_PULSE_WIDTH_US // Wait before asserting ACK
+#endif
+
+// Fixed ACK timing: the PS1 profile. With auto-tune disabled, ACK timing
+// comes from the detected bus speed profile; with it enabled, the profile
+// is where tuning starts.
 #define ACK_PULSE_WIDTH_US 3 // ACK pulse width (3µs)
 #define ACK_POST_WAIT_US 50  // Wait after ACK (50µs)
-#endif
 
 // ============================================================================
 // Button Polling Configuration
@@ -109,11 +188,46 @@
 
 #define BUTTON_POLL_INTERVAL_US 1000 // Button sampling rate: 1000µs = 1kHz
 
+// Core 0 scheduler periods (button sampling runs at BUTTON_POLL_INTERVAL_US)
+#define SCHED_PSYNC_PERIOD_US 50   // Phase-locked sample check (sample timing resolution)
+#define SCHED_SERIAL_PERIOD_US 250 // Serial console / host link
+#define SCHED_LED_PERIOD_US 1000   // LED status
+#define SCHED_LOG_PERIOD_US 1000   // Core 1 log queue output
+
+// Phase-locked sampling: take one extra sample this long before each
+// expected console poll (learned from Core 1 poll timestamps), 0 = off.
+// The sample is taken by the psync task, so it lands 0 - SCHED_PSYNC_PERIOD_US
+// after the due time: a margin below the task period can miss the poll.
+#define POLL_SYNC_MARGIN_US 50
+
 // Button input mode
 // 0: Direct mode - PSX reads current button state (may miss brief inputs)
 // 1: Latching mode - Button presses are held until PSX reads them (guarantees detection)
 #define BUTTON_LATCHING_MODE 1
 
+// Debounce / glitch filter window (samples of BUTTON_POLL_INTERVAL_US)
+// A button change must persist this many consecutive samples to be accepted
+// 0 or 1 = no filtering (default), 2 = reject single-sample glitches, max 15
+// Can be set per button at runtime with the "debounce" command
+#define DEBOUNCE_DEFAULT_WINDOW 0
+
+// Turbo (rapid-fire), synchronised to console polls
+// Turbo buttons alternate pressed/released every TURBO_DEFAULT_RATE polls
+// (2 polls at 60 Hz = 15 presses per second)
+// Configure at runtime with the "turbo" command
+#define TURBO_DEFAULT_RATE 2
+#define TURBO_DEFAULT_MASK 0x0000 // Bit = PSX button bit (0 = no turbo buttons)
+
+// SOCD resolution mode (can be changed at runtime with the "socd" command)
+// SOCD_MODE_OFF, SOCD_MODE_NEUTRAL, SOCD_MODE_LAST_WIN,
+// SOCD_MODE_FIRST_WIN, SOCD_MODE_UP_PRIORITY
+#define SOCD_DEFAULT_MODE SOCD_MODE_NEUTRAL
+
+// Controller persona at startup (PERSONA_DIGITAL, PERSONA_MOUSE, PERSONA_NEGCON)
+// Switch at runtime with the "persona" command
+#define PERSONA_DEFAULT PERSONA_DIGITAL
+#define PERSONA_MOUSE_DPAD_STEP 4 // Mouse motion per poll while a D-pad direction is held
+
 // ============================================================================
 // PSX Protocol Constants
 // ============================================================================
@@ -146,6 +260,18 @@
 
 #define DEBUG_ENABLED 0 // Default debug mode (can be toggled at runtime)
 
+// Bus invariant checks on every transaction (counted in the stats, see README)
+// 1: enabled (a few register reads per transaction)
+// 0: disabled
+#ifndef PSX_INVARIANT_CHECKS
+#define PSX_INVARIANT_CHECKS 1
+#endif
+
+// Core 1 messages (bus speed, ACK tuning) are queued and printed by Core 0,
+// never with printf on Core 1. A full queue drops messages (counted).
+#define LOG_QUEUE_SIZE 32 // Entries (power of 2)
+#define LOG_FLUSH_BURST 4 // Messages printed per scheduler run
+
 // ============================================================================
 // LED Status Modes
 // ============================================================================
@@ -0,0 +1,167 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "debounce.h"
+#include "config.h"
+
+// ============================================================================
+// Filter State (Core 0 only)
+// ============================================================================
+
+#define COUNTER_BITS 4
+
+// Accepted (filtered) button word, 0 = pressed
+static uint16_t filtered_state = 0xFFFF;
+
+// Bit-sliced counters: bit n of counter[k] is bit k of button n's count
+// of consecutive samples disagreeing with filtered_state
+static uint16_t counter[COUNTER_BITS];
+
+// Bit-sliced per-button acceptance thresholds (same layout as counter)
+static uint16_t threshold[COUNTER_BITS];
+
+static uint8_t windows[PSX_BTN_COUNT];
+static uint16_t unfiltered = 0; // Buttons with window 0/1
+static uint32_t glitch_count = 0;
+
+// ============================================================================
+// Internal Functions
+// ============================================================================
+
+static void set_threshold(psx_button_t button, uint8_t samples)
+{
+    // A window of 0 behaves like 1 (accept on first differing sample)
+    uint8_t value = samples == 0 ? 1 : samples;
+
+    if (value == 1)
+    {
+        unfiltered |= (uint16_t)(1u << button);
+    }
+    else
+    {
+        unfiltered &= (uint16_t)~(1u << button);
+    }
+
+    for (int k = 0; k < COUNTER_BITS; k++)
+    {
+        if (value & (1u << k))
+        {
+            threshold[k] |= (uint16_t)(1u << button);
+        }
+        else
+        {
+            threshold[k] &= (uint16_t)~(1u << button);
+        }
+    }
+}
+
+// ============================================================================
+// Public Functions
+// ============================================================================
+
+void debounce_init(void)
+{
+    filtered_state = 0xFFFF;
+    glitch_count = 0;
+    for (int k = 0; k < COUNTER_BITS; k++)
+    {
+        counter[k] = 0;
+        threshold[k] = 0;
+    }
+    for (int i = 0; i < PSX_BTN_COUNT; i++)
+    {
+        debounce_set_window((psx_button_t)i, DEBOUNCE_DEFAULT_WINDOW);
+    }
+}
+
+uint16_t debounce_update(uint16_t raw)
+{
+    // Buttons whose raw input differs from the accepted state
+    uint16_t differs = raw ^ filtered_state;
+
+    // Buttons that went back before reaching their window are glitches
+    uint16_t pending = counter[0] | counter[1] | counter[2] | counter[3];
+    uint16_t glitches = pending & ~differs;
+    if (glitches)
+    {
+        glitch_count += __builtin_popcount(glitches);
+    }
+
+    // Clear counters of agreeing buttons, increment the others (ripple carry)
+    uint16_t carry = differs;
+    for (int k = 0; k < COUNTER_BITS; k++)
+    {
+        counter[k] &= differs;
+        uint16_t next_carry = counter[k] & carry;
+        counter[k] ^= carry;
+        carry = next_carry;
+    }
+
+    // Accept changes whose counter has reached the threshold
+    uint16_t accept = differs;
+    for (int k = 0; k < COUNTER_BITS; k++)
+    {
+        accept &= ~(counter[k] ^ threshold[k]);
+    }
+
+    filtered_state ^= accept;
+    for (int k = 0; k < COUNTER_BITS; k++)
+    {
+        counter[k] &= ~accept;
+    }
+
+    return filtered_state;
+}
+
+uint16_t debounce_peek(uint16_t raw)
+{
+    return (uint16_t)((filtered_state & ~unfiltered) | (raw & unfiltered));
+}
+
+bool debounce_set_window(psx_button_t button, uint8_t samples)
+{
+    if (button >= PSX_BTN_COUNT || samples > DEBOUNCE_WINDOW_MAX)
+    {
+        return false;
+    }
+
+    windows[button] = samples;
+    set_threshold(button, samples);
+
+    // Restart any pending change of this button against the new window
+    for (int k = 0; k < COUNTER_BITS; k++)
+    {
+        counter[k] &= (uint16_t)~(1u << button);
+    }
+    return true;
+}
+
+uint8_t debounce_get_window(psx_button_t button)
+{
+    if (button >= PSX_BTN_COUNT)
+    {
+        return 0;
+    }
+    return windows[button];
+}
+
+uint32_t debounce_get_glitch_count(void)
+{
+    return glitch_count;
+}
@@ -0,0 +1,58 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef DEBOUNCE_H
+#define DEBOUNCE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "button_input.h"
+
+// ============================================================================
+// Per-Button Debounce / Glitch Filter
+// ============================================================================
+
+// A button change is accepted once the raw input has disagreed with the
+// accepted state for `window` consecutive samples (0 or 1 = no filtering).
+// Shorter disagreements are dropped and counted as glitches.
+// All 16 buttons are updated together with bit-sliced counters.
+
+#define DEBOUNCE_WINDOW_MAX 15 // 4-bit counters (samples, 1 sample = BUTTON_POLL_INTERVAL_US)
+
+// Initialize filter state, all windows set to DEBOUNCE_DEFAULT_WINDOW
+void debounce_init(void);
+
+// Core 0: Feed one raw sample (16-bit button word), returns filtered word
+uint16_t debounce_update(uint16_t raw);
+
+// Core 0: Filtered word for an extra sample between regular ones, without
+// touching the filter: unfiltered buttons (window 0/1) follow raw, the
+// others keep their accepted state (windows count regular samples only)
+uint16_t debounce_peek(uint16_t raw);
+
+// Set the window of one button in samples (0 - DEBOUNCE_WINDOW_MAX)
+bool debounce_set_window(psx_button_t button, uint8_t samples);
+
+// Get the window of one button in samples
+uint8_t debounce_get_window(psx_button_t button);
+
+// Number of input changes rejected as glitches since boot
+uint32_t debounce_get_glitch_count(void);
+
+#endif // DEBOUNCE_H
@@ -23,6 +23,7 @@
 #include "pico/multicore.h"
 #include <string.h>
 #include <stdio.h>
+#include <stddef.h>
 
 // ============================================================================
 // Flash Configuration Constants
@@ -39,6 +40,15 @@
 // Get pointer to config in flash (XIP mapped address)
 #define FLASH_CONFIG_ADDR (XIP_BASE + FLASH_CONFIG_OFFSET)
 
+// Macro storage uses the sector just below the config sector
+#define MACRO_MAGIC 0x5053584D  // "PSXM" in ASCII
+#define FLASH_MACRO_OFFSET (FLASH_CONFIG_OFFSET - FLASH_SECTOR_SIZE)
+#define FLASH_MACRO_ADDR (XIP_BASE + FLASH_MACRO_OFFSET)
+
+// The config must fit in the single page written by flash_config_save()
+_Static_assert(sizeof(flash_config_t) <= FLASH_PAGE_SIZE, "flash_config_t exceeds one flash page");
+_Static_assert(sizeof(flash_macro_t) <= FLASH_SECTOR_SIZE, "flash_macro_t exceeds one flash sector");
+
 // ============================================================================
 // Internal Functions
 // ============================================================================
@@ -46,11 +56,14 @@
 // Calculate simple checksum
 static uint32_t calculate_checksum(const flash_config_t *config)
 {
-    uint32_t sum = 0;
-    sum += config->magic;
-    sum += config->debug_mode;
-    sum += config->latching_mode;
-    // Don't include checksum field itself
+    uint32_t sum = config->magic;
+    const uint8_t *bytes = (const uint8_t *)config;
+
+    // Sum every byte after the magic, up to (not including) the checksum field
+    for (size_t i = sizeof(config->magic); i < offsetof(flash_config_t, checksum); i++)
+    {
+        sum += bytes[i];
+    }
     return sum;
 }
 
@@ -63,7 +76,7 @@ void flash_config_init(void)
     // Nothing to do - flash is memory mapped and ready to read
 }
 
-bool flash_config_load(bool *debug_mode, bool *latching_mode)
+bool flash_config_load(flash_config_t *config)
 {
     // Read config from flash (memory mapped, no special read needed)
     const flash_config_t *stored_config = (const flash_config_t *)FLASH_CONFIG_ADDR;
@@ -73,6 +86,11 @@ bool flash_config_load(bool *debug_mode, bool *latching_mode)
         return false;  // No valid config found
     }
     
+    // Validate layout version
+    if (stored_config->version != FLASH_CONFIG_VERSION) {
+        return false;  // Saved by an older firmware
+    }
+    
     // Validate checksum
     uint32_t expected_checksum = calculate_checksum(stored_config);
     if (stored_config->checksum != expected_checksum) {
@@ -80,45 +98,40 @@ bool flash_config_load(bool *debug_mode, bool *latching_mode)
     }
     
     // Load values
-    *debug_mode = stored_config->debug_mode ? true : false;
-    *latching_mode = stored_config->latching_mode ? true : false;
+    *config = *stored_config;
     
     return true;
 }
 
 // External Core1 entry point
 extern void core1_entry(void);
+extern void core1_stop(void);
 
-void flash_config_save(bool debug_mode, bool latching_mode)
+// Erase one sector and program `len` bytes (padded to whole pages)
+// Core1 is stopped for the duration and relaunched afterwards
+static void write_sector(uint32_t offset, const void *data, size_t len)
 {
-    // Prepare config structure in RAM (not on stack during flash ops)
-    static flash_config_t config;
-    config.magic = CONFIG_MAGIC;
-    config.debug_mode = debug_mode ? 1 : 0;
-    config.latching_mode = latching_mode ? 1 : 0;
-    config.reserved[0] = 0;
-    config.reserved[1] = 0;
-    config.checksum = calculate_checksum(&config);
+    // Page-aligned staging buffer (static - not on stack during flash ops)
+    static uint8_t buffer[FLASH_SECTOR_SIZE];
+    size_t program_len = (len + FLASH_PAGE_SIZE - 1) & ~(size_t)(FLASH_PAGE_SIZE - 1);
+
+    memset(buffer, 0xFF, program_len);
+    memcpy(buffer, data, len);
     
     printf("Saving to flash (this will take ~400ms)...\n");
     
     // CRITICAL: Stop Core1 before flash operations
     // Flash erase/write freezes the XIP bus, breaking code execution from flash
-    multicore_reset_core1();
-    
-    // Give Core1 time to stop
-    sleep_ms(10);
+    core1_stop();
     
     // Flash operations require interrupts to be disabled
     uint32_t ints = save_and_disable_interrupts();
     
     // Erase the sector (4KB) - takes ~400ms
-    flash_range_erase(FLASH_CONFIG_OFFSET, FLASH_SECTOR_SIZE);
+    flash_range_erase(offset, FLASH_SECTOR_SIZE);
     
-    // Write the config - align to 256 bytes as required
-    uint8_t buffer[FLASH_PAGE_SIZE] = {0};  // 256 bytes
-    memcpy(buffer, &config, sizeof(flash_config_t));
-    flash_range_program(FLASH_CONFIG_OFFSET, buffer, FLASH_PAGE_SIZE);
+    // Write the data - align to 256 bytes as required
+    flash_range_program(offset, buffer, program_len);
     
     // Re-enable interrupts
     restore_interrupts(ints);
@@ -127,6 +140,66 @@ void flash_config_save(bool debug_mode, bool latching_mode)
     
     // Restart Core1
     multicore_launch_core1(core1_entry);
+}
+
+void flash_config_save(const flash_config_t *new_config)
+{
+    // Prepare config structure in RAM (not on stack during flash ops)
+    static flash_config_t config;
+    config = *new_config;
+    config.magic = CONFIG_MAGIC;
+    config.version = FLASH_CONFIG_VERSION;
+    config.checksum = calculate_checksum(&config);
+    
+    write_sector(FLASH_CONFIG_OFFSET, &config, sizeof(config));
     
     printf("Settings saved successfully\n");
 }
+
+// ============================================================================
+// Macro Storage
+// ============================================================================
+
+// Calculate macro checksum over header fields and all stored runs
+static uint32_t calculate_macro_checksum(const flash_macro_t *macro)
+{
+    uint32_t sum = macro->magic + macro->count;
+    for (uint16_t i = 0; i < macro->count && i < MACRO_MAX_ENTRIES; i++)
+    {
+        sum += macro->entries[i].buttons;
+        sum += macro->entries[i].polls;
+    }
+    return sum;
+}
+
+bool flash_config_load_macro(void)
+{
+    const flash_macro_t *stored = (const flash_macro_t *)FLASH_MACRO_ADDR;
+
+    if (stored->magic != MACRO_MAGIC || stored->count > MACRO_MAX_ENTRIES) {
+        return false;  // No valid macro found
+    }
+    if (stored->checksum != calculate_macro_checksum(stored)) {
+        return false;  // Corrupted macro
+    }
+
+    return macro_load(stored->entries, stored->count);
+}
+
+void flash_config_save_macro(void)
+{
+    static flash_macro_t macro;
+    uint16_t count;
+    const macro_entry_t *entries = macro_get_entries(&count);
+
+    macro.magic = MACRO_MAGIC;
+    macro.count = count;
+    macro.reserved = 0;
+    memcpy(macro.entries, entries, count * sizeof(macro_entry_t));
+    macro.checksum = calculate_macro_checksum(&macro);
+
+    // Only the used part of the entry table is programmed
+    write_sector(FLASH_MACRO_OFFSET, &macro, offsetof(flash_macro_t, entries) + count * sizeof(macro_entry_t));
+
+    printf("Macro saved successfully (%u runs)\n", count);
+}
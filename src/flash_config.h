@@ -21,28 +21,60 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "config.h"
+#include "button_input.h"
+#include "macro.h"
 
 // ============================================================================
 // Flash Configuration Storage
 // ============================================================================
 
+// Layout version - bump whenever flash_config_t changes
+// Configs with a different version are ignored and defaults are used
+#define FLASH_CONFIG_VERSION 7
+
 // Configuration structure (stored in Flash)
 typedef struct {
     uint32_t magic;           // Magic number to validate config (0x50535843 = "PSXC")
+    uint8_t version;          // Layout version (FLASH_CONFIG_VERSION)
     uint8_t debug_mode;       // Debug mode: 0=OFF, 1=ON
     uint8_t latching_mode;    // Latching mode: 0=OFF, 1=ON
-    uint8_t reserved[2];      // Reserved for future use
+    uint8_t button_profile;   // Active button map profile
+    uint8_t socd_mode;        // SOCD resolution mode (socd_mode_t)
+    uint8_t turbo_rate;       // Turbo polls per pressed/released phase
+    uint16_t turbo_mask;      // Turbo-enabled PSX buttons (bit = PSX button bit)
+    uint8_t macro_trigger;    // Macro playback trigger button (PSX_BTN_COUNT = none)
+    uint8_t personas;         // Persona per port (persona_id_t, port 1 in bits 0-3, port 2 in bits 4-7)
+    uint16_t poll_sync_margin; // Phase-locked sample margin before each poll (µs, 0 = off)
+    button_map_t button_maps[BUTTON_MAP_PROFILE_COUNT]; // Button remap profiles
+    uint8_t debounce_windows[PSX_BTN_COUNT]; // Debounce window per PSX button (samples)
     uint32_t checksum;        // Simple checksum for validation
 } flash_config_t;
 
+// Macro storage (own sector, header + used runs only)
+typedef struct {
+    uint32_t magic;           // Magic number to validate macro (0x5053584D = "PSXM")
+    uint16_t count;           // Number of runs
+    uint16_t reserved;        // Reserved for future use
+    uint32_t checksum;        // Simple checksum for validation
+    macro_entry_t entries[MACRO_MAX_ENTRIES];
+} flash_macro_t;
+
 // Initialize flash configuration system
 void flash_config_init(void);
 
 // Load configuration from flash
 // Returns true if valid config found, false otherwise
-bool flash_config_load(bool *debug_mode, bool *latching_mode);
+bool flash_config_load(flash_config_t *config);
+
+// Save configuration to flash (magic, version and checksum are filled in)
+void flash_config_save(const flash_config_t *config);
+
+// Load the stored macro into the recorder
+// Returns true if a valid macro was found
+bool flash_config_load_macro(void);
 
-// Save current configuration to flash
-void flash_config_save(bool debug_mode, bool latching_mode);
+// Save the recorder's current macro to flash
+void flash_config_save_macro(void);
 
 #endif // FLASH_CONFIG_H
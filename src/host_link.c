@@ -0,0 +1,369 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "host_link.h"
+#include "config.h"
+#include "inject.h"
+#include "persona.h"
+#include "pico/stdlib.h"
+#include <stdio.h>
+
+// ============================================================================
+// Parser State (Core 0 only)
+// ============================================================================
+
+// Frame is assembled in place - header fields are decoded straight from it
+static uint8_t frame[HOST_LINK_HEADER_LEN + HOST_LINK_MAX_PAYLOAD + 1];
+static uint8_t frame_pos = 0; // 0 = waiting for sync
+static uint8_t frame_len = 0; // Total frame length once known
+static uint32_t last_byte_time = 0;
+
+static bool have_seq = false;
+static uint16_t last_seq = 0;
+static uint32_t last_seq_time = 0;
+
+static uint16_t host_buttons[PSX_PORT_COUNT] = {
+    0xFFFF,
+#if PSX_PORT_COUNT > 1
+    0xFFFF,
+#endif
+};
+static uint32_t host_input_time[PSX_PORT_COUNT] = {0};
+static uint8_t host_axes[PSX_PORT_COUNT][PERSONA_AXES];
+static bool host_axes_valid[PSX_PORT_COUNT] = {false};
+static uint32_t host_axes_time[PSX_PORT_COUNT] = {0};
+static bool input_pending = false;
+
+static host_link_stats_t stats = {0};
+
+// Device -> host
+static uint16_t tx_seq = 0;
+static bool poll_events = false;
+
+// ============================================================================
+// Internal Functions
+// ============================================================================
+
+static uint8_t crc8(const uint8_t *data, uint8_t len)
+{
+    uint8_t crc = 0;
+    for (uint8_t i = 0; i < len; i++)
+    {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static inline uint16_t read_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t read_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void write_u32(uint8_t *p, uint32_t value)
+{
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+}
+
+// Ordering check: accept only frames newer than the last accepted one.
+// After HOST_INPUT_TIMEOUT_US without one, any number starts a new stream
+// (host tool restarted from 0) instead of being stale until it passes the old one.
+static bool accept_sequence(uint16_t seq)
+{
+    uint32_t now = time_us_32();
+    if (have_seq && (now - last_seq_time) > HOST_INPUT_TIMEOUT_US)
+    {
+        have_seq = false;
+    }
+
+    if (have_seq)
+    {
+        int16_t delta = (int16_t)(seq - last_seq);
+        if (delta <= 0)
+        {
+            stats.frames_stale++;
+            return false;
+        }
+        stats.frames_lost += (uint32_t)(delta - 1);
+    }
+
+    have_seq = true;
+    last_seq = seq;
+    last_seq_time = now;
+    stats.last_seq = seq;
+    return true;
+}
+
+static void dispatch_frame(void)
+{
+    uint8_t type = frame[1];
+    uint8_t payload_len = frame[2];
+    const uint8_t *payload = &frame[HOST_LINK_HEADER_LEN];
+
+    if (crc8(&frame[1], frame_len - 2) != frame[frame_len - 1])
+    {
+        stats.crc_errors++;
+        return;
+    }
+
+    switch (type)
+    {
+    case HOST_FRAME_INPUT:
+    {
+        // Optional third byte selects the console port (default port 1)
+        uint8_t port = (payload_len == 3) ? payload[2] : 0;
+        if ((payload_len != 2 && payload_len != 3) || port >= PSX_PORT_COUNT)
+        {
+            stats.bad_frames++;
+            return;
+        }
+        if (!accept_sequence(read_u16(&frame[3])))
+        {
+            return;
+        }
+        host_buttons[port] = read_u16(payload);
+        host_input_time[port] = time_us_32();
+        input_pending = true;
+        break;
+    }
+
+    case HOST_FRAME_INJECT:
+        if (payload_len != 6)
+        {
+            stats.bad_frames++;
+            return;
+        }
+        if (!accept_sequence(read_u16(&frame[3])))
+        {
+            return;
+        }
+        // Queue full is counted by the injection layer
+        inject_push(read_u32(payload), read_u16(&payload[4]));
+        break;
+
+    case HOST_FRAME_AXES:
+    {
+        uint8_t port = (payload_len == PERSONA_AXES + 1) ? payload[PERSONA_AXES] : 0;
+        if ((payload_len != PERSONA_AXES && payload_len != PERSONA_AXES + 1) || port >= PSX_PORT_COUNT)
+        {
+            stats.bad_frames++;
+            return;
+        }
+        if (!accept_sequence(read_u16(&frame[3])))
+        {
+            return;
+        }
+        for (int i = 0; i < PERSONA_AXES; i++)
+        {
+            host_axes[port][i] = payload[i];
+        }
+        host_axes_valid[port] = true;
+        host_axes_time[port] = time_us_32();
+        input_pending = true;
+        break;
+    }
+
+    case HOST_FRAME_MOTION:
+    {
+        uint8_t port = (payload_len == 5) ? payload[4] : 0;
+        if ((payload_len != 4 && payload_len != 5) || port >= PSX_PORT_COUNT)
+        {
+            stats.bad_frames++;
+            return;
+        }
+        if (!accept_sequence(read_u16(&frame[3])))
+        {
+            return;
+        }
+        // Relative: goes straight to the accumulators, reported over the next polls
+        persona_add_motion(port, (int16_t)read_u16(payload), (int16_t)read_u16(&payload[2]));
+        break;
+    }
+
+    default:
+        stats.bad_frames++;
+        return;
+    }
+
+    stats.frames_accepted++;
+}
+
+// ============================================================================
+// Public Functions
+// ============================================================================
+
+bool host_link_feed(uint8_t byte)
+{
+    uint32_t now = time_us_32();
+
+    // A frame interrupted mid-way is abandoned so text commands keep working
+    if (frame_pos != 0 && (now - last_byte_time) > HOST_LINK_FRAME_TIMEOUT_US)
+    {
+        stats.bad_frames++;
+        frame_pos = 0;
+    }
+    last_byte_time = now;
+
+    if (frame_pos == 0)
+    {
+        if (byte != HOST_LINK_SYNC)
+        {
+            return false; // Text console byte
+        }
+        frame[frame_pos++] = byte;
+        return true;
+    }
+
+    frame[frame_pos++] = byte;
+
+    if (frame_pos == 3)
+    {
+        // Length byte received - validate before collecting the payload
+        if (byte > HOST_LINK_MAX_PAYLOAD)
+        {
+            stats.bad_frames++;
+            frame_pos = 0;
+            return true;
+        }
+        frame_len = HOST_LINK_HEADER_LEN + byte + 1;
+    }
+    else if (frame_pos > 3 && frame_pos == frame_len)
+    {
+        dispatch_frame();
+        frame_pos = 0;
+    }
+
+    return true;
+}
+
+bool host_link_take_input(void)
+{
+    bool pending = input_pending;
+    input_pending = false;
+    return pending;
+}
+
+uint16_t host_link_buttons(uint8_t port, uint32_t now_us)
+{
+    // Release everything if the host stopped sending
+    if (host_buttons[port] != 0xFFFF && (now_us - host_input_time[port]) > HOST_INPUT_TIMEOUT_US)
+    {
+        host_buttons[port] = 0xFFFF;
+    }
+    return host_buttons[port];
+}
+
+bool host_link_axes(uint8_t port, uint32_t now_us, uint8_t *axes)
+{
+    // Back to the rest values if the host stopped sending
+    if (host_axes_valid[port] && (now_us - host_axes_time[port]) > HOST_INPUT_TIMEOUT_US)
+    {
+        host_axes_valid[port] = false;
+    }
+    if (!host_axes_valid[port])
+    {
+        return false;
+    }
+
+    for (int i = 0; i < PERSONA_AXES; i++)
+    {
+        axes[i] = host_axes[port][i];
+    }
+    return true;
+}
+
+void host_link_get_stats(host_link_stats_t *stats_out)
+{
+    if (stats_out)
+    {
+        *stats_out = stats;
+    }
+}
+
+void host_link_send(uint8_t type, const uint8_t *payload, uint8_t len)
+{
+    uint8_t out[HOST_LINK_HEADER_LEN + HOST_LINK_MAX_PAYLOAD + 1];
+
+    if (len > HOST_LINK_MAX_PAYLOAD)
+    {
+        return;
+    }
+
+    out[0] = HOST_LINK_SYNC;
+    out[1] = type;
+    out[2] = len;
+    out[3] = (uint8_t)tx_seq;
+    out[4] = (uint8_t)(tx_seq >> 8);
+    write_u32(&out[5], time_us_32());
+    for (uint8_t i = 0; i < len; i++)
+    {
+        out[HOST_LINK_HEADER_LEN + i] = payload[i];
+    }
+    out[HOST_LINK_HEADER_LEN + len] = crc8(&out[1], HOST_LINK_HEADER_LEN - 1 + len);
+    tx_seq++;
+
+    // Raw output - binary frames must not get CR/LF translation
+    for (uint8_t i = 0; i < HOST_LINK_HEADER_LEN + len + 1; i++)
+    {
+        putchar_raw(out[i]);
+    }
+}
+
+void host_link_set_poll_events(bool enabled)
+{
+    poll_events = enabled;
+}
+
+bool host_link_poll_events_enabled(void)
+{
+    return poll_events;
+}
+
+void host_link_task(void)
+{
+    uint32_t poll;
+    uint32_t poll_time;
+    bool injected;
+
+    if (!poll_events || !inject_poll_event(&poll, &poll_time, &injected))
+    {
+        return;
+    }
+
+    inject_stats_t inject;
+    inject_get_stats(&inject);
+
+    uint8_t payload[10];
+    write_u32(&payload[0], poll);
+    write_u32(&payload[4], poll_time);
+    payload[8] = injected ? HOST_POLL_FLAG_INJECTED : 0;
+    payload[9] = (uint8_t)(INJECT_QUEUE_SIZE - inject.queued);
+    host_link_send(HOST_FRAME_POLL_EVENT, payload, sizeof(payload));
+}
@@ -0,0 +1,101 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef HOST_LINK_H
+#define HOST_LINK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ============================================================================
+// Binary Host Link (packed frames over the USB CDC serial link)
+// ============================================================================
+
+// Frame layout (little-endian):
+//   [0]     HOST_LINK_SYNC (0xA5, never part of a text command)
+//   [1]     type
+//   [2]     payload length (0 - HOST_LINK_MAX_PAYLOAD)
+//   [3..4]  sequence number (wraps at 65536)
+//   [5..8]  host timestamp (µs, informational)
+//   [9..]   payload
+//   [last]  CRC-8 (poly 0x07, init 0x00) over bytes [1] .. end of payload
+//
+// Frames whose sequence number is not newer than the last accepted frame
+// are dropped as stale; forward jumps are counted as lost frames. After
+// HOST_INPUT_TIMEOUT_US without an accepted frame the sequence restarts at
+// whatever number comes next.
+
+#define HOST_LINK_SYNC 0xA5
+#define HOST_LINK_HEADER_LEN 9
+#define HOST_LINK_MAX_PAYLOAD 64
+#define HOST_LINK_RX_BURST 64            // Max serial bytes drained per main loop iteration
+#define HOST_LINK_FRAME_TIMEOUT_US 10000 // Max gap between bytes of one frame
+
+// Frame types (host -> device)
+#define HOST_FRAME_INPUT 0x01  // payload: buttons u16 (PSX button word, 0 = pressed) [, port u8]
+#define HOST_FRAME_INJECT 0x02 // payload: poll u32, buttons u16 (send on that 0x42 poll)
+#define HOST_FRAME_AXES 0x03   // payload: 4 axes u8 [, port u8] (persona analog inputs, e.g. NeGcon twist/I/II/L)
+#define HOST_FRAME_MOTION 0x04 // payload: dx i16, dy i16 [, port u8] (added to the mouse motion)
+
+// Frame types (device -> host), same layout with the device's own sequence
+#define HOST_FRAME_POLL_EVENT 0x81 // payload: poll u32, poll time u32 (µs), flags u8, queue free u8
+#define HOST_POLL_FLAG_INJECTED 0x01 // Poll sent an injected button word
+#define HOST_FRAME_SNIFF 0x82      // payload: 1-8 sniffer records (time u32, cmd u8, dat u8, ack delay u8, flags u8)
+
+// Host input (buttons, axes) is released if no frame arrives within this time
+#define HOST_INPUT_TIMEOUT_US 100000
+
+typedef struct
+{
+    uint32_t frames_accepted; // Valid frames applied
+    uint32_t frames_stale;    // Dropped: old or duplicate sequence number
+    uint32_t frames_lost;     // Sequence numbers skipped by the host/link
+    uint32_t crc_errors;      // Dropped: CRC mismatch
+    uint32_t bad_frames;      // Dropped: unknown type or bad length
+    uint16_t last_seq;        // Sequence number of last accepted frame
+} host_link_stats_t;
+
+// Core 0: Feed one received serial byte
+// Returns true if the byte was consumed by the binary frame parser
+bool host_link_feed(uint8_t byte);
+
+// Core 0: Returns true once after each newly accepted input frame
+bool host_link_take_input(void);
+
+// Core 0: Current host button word for a port (0xFFFF if no recent input frame)
+uint16_t host_link_buttons(uint8_t port, uint32_t now_us);
+
+// Core 0: Current host axes for a port into axes[PERSONA_AXES]
+// Returns false if no recent axes frame (personas use their rest values)
+bool host_link_axes(uint8_t port, uint32_t now_us, uint8_t *axes);
+
+// Get link statistics
+void host_link_get_stats(host_link_stats_t *stats);
+
+// Core 0: Send one frame to the host (raw, no CR/LF translation)
+void host_link_send(uint8_t type, const uint8_t *payload, uint8_t len);
+
+// Enable/disable per-poll notification frames to the host
+void host_link_set_poll_events(bool enabled);
+bool host_link_poll_events_enabled(void);
+
+// Core 0: Send a poll notification if a new poll happened (when enabled)
+void host_link_task(void);
+
+#endif // HOST_LINK_H
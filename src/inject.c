@@ -0,0 +1,203 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "inject.h"
+#include "config.h"
+#include "seqlock.h"
+#include "hardware/sync.h"
+
+// ============================================================================
+// Injection Queue (single producer Core 0, single consumer Core 1)
+// ============================================================================
+
+typedef struct
+{
+    uint32_t poll;    // Target poll number
+    uint16_t buttons; // Button word to send on that poll
+} inject_entry_t;
+
+static inject_entry_t queue[INJECT_QUEUE_SIZE];
+static volatile uint32_t queue_head = 0; // Written by Core 0
+static volatile uint32_t queue_tail = 0; // Written by Core 1
+
+// Poll publication (written by Core 1, read by Core 0)
+// poll_seq is odd while the fields below are being updated
+static volatile uint32_t poll_seq = 0;
+static volatile uint32_t poll_count = 0;
+static volatile uint32_t poll_time = 0;
+static volatile bool poll_injected = false;
+
+// Counters owned by Core 1
+static volatile uint32_t delivered_count = 0;
+static volatile uint32_t late_count = 0;
+
+// Poll in flight between inject_on_poll() and inject_poll_done() (Core 1 only)
+static bool pending = false;
+static bool pending_injected = false; // Entry at queue_tail was sent
+static uint32_t pending_time = 0;
+
+// Counters owned by Core 0
+static uint32_t overflow_count = 0;
+static uint32_t last_reported_poll = 0;
+
+// ============================================================================
+// Core 0 Functions
+// ============================================================================
+
+void inject_init(void)
+{
+    queue_head = 0;
+    queue_tail = 0;
+    poll_seq = 0;
+    poll_count = 0;
+    poll_time = 0;
+    poll_injected = false;
+    delivered_count = 0;
+    late_count = 0;
+    pending = false;
+    overflow_count = 0;
+    last_reported_poll = 0;
+}
+
+bool inject_push(uint32_t poll, uint16_t buttons)
+{
+    uint32_t head = queue_head;
+    if (head - queue_tail >= INJECT_QUEUE_SIZE)
+    {
+        overflow_count++;
+        return false;
+    }
+
+    queue[head & (INJECT_QUEUE_SIZE - 1)].poll = poll;
+    queue[head & (INJECT_QUEUE_SIZE - 1)].buttons = buttons;
+
+    // Entry must be complete before Core 1 can see it
+    __dmb();
+    queue_head = head + 1;
+    return true;
+}
+
+void inject_read_last_poll(uint32_t *poll, uint32_t *time_us, bool *injected)
+{
+    uint32_t seq;
+
+    // Retry until a consistent snapshot is read
+    do
+    {
+        seq = seqlock_read_begin(&poll_seq);
+        *poll = poll_count;
+        *time_us = poll_time;
+        *injected = poll_injected;
+    } while (seqlock_read_retry(&poll_seq, seq));
+}
+
+bool inject_poll_event(uint32_t *poll, uint32_t *time_us, bool *injected)
+{
+    inject_read_last_poll(poll, time_us, injected);
+
+    uint32_t count = *poll;
+    if (count == last_reported_poll)
+    {
+        return false;
+    }
+    last_reported_poll = count;
+    return true;
+}
+
+void inject_get_stats(inject_stats_t *stats)
+{
+    stats->polls = poll_count;
+    stats->delivered = delivered_count;
+    stats->late = late_count;
+    stats->overflows = overflow_count;
+    stats->queued = queue_head - queue_tail;
+}
+
+// ============================================================================
+// Core 1 Poll Hook
+// ============================================================================
+
+void inject_core1_start(void)
+{
+    seqlock_recover(&poll_seq);
+    pending = false;
+}
+
+uint16_t __time_critical_func(inject_on_poll)(uint16_t buttons)
+{
+    uint32_t poll = poll_count + 1;
+    uint32_t tail = queue_tail;
+    bool injected = false;
+
+    // Drop entries that missed their poll, then look at the one due now
+    while (tail != queue_head)
+    {
+        __dmb();
+        const inject_entry_t *entry = &queue[tail & (INJECT_QUEUE_SIZE - 1)];
+        int32_t delta = (int32_t)(entry->poll - poll);
+
+        if (delta > 0)
+        {
+            break; // Due on a later poll
+        }
+        if (delta == 0)
+        {
+            // Stays queued until the frame is out (inject_poll_done)
+            buttons = entry->buttons;
+            injected = true;
+            break;
+        }
+        tail++;
+        late_count++;
+    }
+    queue_tail = tail;
+
+    pending = true;
+    pending_injected = injected;
+    pending_time = time_us_32();
+    return buttons;
+}
+
+void __time_critical_func(inject_poll_done)(bool delivered)
+{
+    if (!pending)
+    {
+        return;
+    }
+    pending = false;
+
+    // Cut short: the poll is not counted and its entry is sent again
+    if (!delivered)
+    {
+        return;
+    }
+
+    if (pending_injected)
+    {
+        queue_tail = queue_tail + 1;
+        delivered_count++;
+    }
+
+    // Publish this poll for the host notification
+    seqlock_write_begin(&poll_seq);
+    poll_count = poll_count + 1;
+    poll_time = pending_time;
+    poll_injected = pending_injected;
+    seqlock_write_end(&poll_seq);
+}
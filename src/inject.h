@@ -0,0 +1,79 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef INJECT_H
+#define INJECT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ============================================================================
+// Poll-Synchronised Input Injection
+// ============================================================================
+
+// The host queues button words tagged with the 0x42 poll number on which
+// they must be sent. Core 1 takes at most one matching entry per poll, so an
+// injected state lands on exactly that frame. Entries whose poll has already
+// passed are dropped and counted as late.
+//
+// A poll is numbered and counted only once its frame is fully clocked out:
+// if the console cuts it short, the entry stays queued and the next poll
+// gets the same number.
+
+#define INJECT_QUEUE_SIZE 64 // Entries, must be a power of 2
+
+typedef struct
+{
+    uint32_t polls;      // 0x42 polls fully answered since boot
+    uint32_t delivered;  // Entries sent on their target poll
+    uint32_t late;       // Entries dropped because their poll had passed
+    uint32_t overflows;  // Entries rejected because the queue was full
+    uint32_t queued;     // Entries currently waiting
+} inject_stats_t;
+
+// Initialize queue and counters
+void inject_init(void);
+
+// Core 0: Queue a button word for a given poll number
+// Returns false if the queue is full
+bool inject_push(uint32_t poll, uint16_t buttons);
+
+// Core 0: Latest poll number and its time_us_32() timestamp
+// Returns true if a poll happened since the previous call
+bool inject_poll_event(uint32_t *poll, uint32_t *time_us, bool *injected);
+
+// Core 0: Consistent snapshot of the latest poll (no event bookkeeping)
+void inject_read_last_poll(uint32_t *poll, uint32_t *time_us, bool *injected);
+
+// Get injection statistics
+void inject_get_stats(inject_stats_t *stats);
+
+// Core 1: Called at Core 1 start, before the first poll
+// (a reset mid-publication may have left the poll snapshot odd)
+void inject_core1_start(void);
+
+// Core 1: Called exactly once per 0x42 poll with the outgoing button word
+// Returns the injected word if one is due on this poll
+uint16_t inject_on_poll(uint16_t buttons);
+
+// Core 1: Called after the poll's frame: delivered = all bytes clocked out
+// Takes the injected entry and publishes the poll only if delivered
+void inject_poll_done(bool delivered);
+
+#endif // INJECT_H
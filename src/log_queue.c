@@ -0,0 +1,129 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "log_queue.h"
+#include "config.h"
+#include "hardware/sync.h"
+#include "pico/stdlib.h"
+#include <stdio.h>
+
+#if (LOG_QUEUE_SIZE & (LOG_QUEUE_SIZE - 1)) != 0
+#error "LOG_QUEUE_SIZE must be a power of 2"
+#endif
+
+// ============================================================================
+// Message Formats
+// ============================================================================
+
+// Every argument is passed to printf, unused ones are ignored
+static const char *const log_formats[LOG_MSG_COUNT] = {
+    [LOG_TIMING_PROFILE] = "[TIMING] Port %lu: %s (~%lu kHz)\n",
+    [LOG_ACK_TUNE_IDLE] = "[ACK-TUNE] Idle timeout, resetting...\n",
+    [LOG_ACK_TUNE_START] = "[ACK-TUNE] Starting auto-tune...\n",
+    [LOG_ACK_TUNE_BEST] = "[ACK-TUNE] New best: PULSE=%lu, WAIT=%lu (%lu.%lu%%, %lu/%lu)\n",
+    [LOG_ACK_TUNE_LOCKED] = "[ACK-TUNE] LOCKED: PULSE=%lu us, WAIT=%lu us (%lu%%)\n",
+    [LOG_ACK_TUNE_RESTART] = "[ACK-TUNE] No good settings, restarting...\n",
+};
+
+// ============================================================================
+// Queue State
+// ============================================================================
+
+typedef struct
+{
+    uint8_t msg;
+    uint32_t args[LOG_ARGS];
+} log_entry_t;
+
+static log_entry_t entries[LOG_QUEUE_SIZE];
+
+// Free-running indices: head is only written by Core 1, tail only by Core 0
+static volatile uint32_t head = 0;
+static volatile uint32_t tail = 0;
+
+static volatile uint32_t dropped = 0; // Core 1
+static uint32_t dropped_reported = 0; // Core 0
+
+// ============================================================================
+// Producer (Core 1)
+// ============================================================================
+
+void __time_critical_func(log_push)(log_msg_t msg, const uint32_t args[LOG_ARGS])
+{
+    uint32_t index = head;
+    if (index - tail >= LOG_QUEUE_SIZE)
+    {
+        dropped++;
+        return;
+    }
+
+    log_entry_t *entry = &entries[index & (LOG_QUEUE_SIZE - 1)];
+    entry->msg = (uint8_t)msg;
+    for (int i = 0; i < LOG_ARGS; i++)
+    {
+        entry->args[i] = args[i];
+    }
+
+    // Entry complete before Core 0 can see it
+    __dmb();
+    head = index + 1;
+}
+
+// ============================================================================
+// Consumer (Core 0)
+// ============================================================================
+
+uint32_t log_flush(uint32_t max)
+{
+    uint32_t printed = 0;
+
+    while (printed < max && tail != head)
+    {
+        // Read the entry only after seeing the head that published it
+        __dmb();
+        log_entry_t entry = entries[tail & (LOG_QUEUE_SIZE - 1)];
+        __dmb();
+        tail++;
+
+        if (entry.msg < LOG_MSG_COUNT)
+        {
+            printf(log_formats[entry.msg], entry.args[0], entry.args[1], entry.args[2],
+                   entry.args[3], entry.args[4], entry.args[5]);
+        }
+        printed++;
+    }
+
+    uint32_t lost = dropped;
+    if (lost != dropped_reported)
+    {
+        printf("[LOG] %lu messages dropped (queue full)\n", lost - dropped_reported);
+        dropped_reported = lost;
+    }
+
+    return printed;
+}
+
+void log_discard(void)
+{
+    tail = head;
+}
+
+uint32_t log_get_dropped(void)
+{
+    return dropped;
+}
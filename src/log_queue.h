@@ -0,0 +1,65 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LOG_QUEUE_H
+#define LOG_QUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ============================================================================
+// Deferred Log Queue
+// ============================================================================
+
+// Core 1 must never block on USB CDC in the middle of a transaction, so it
+// only enqueues a message ID and a few integer arguments. Core 0 formats and
+// prints the entries later from its scheduler. Single producer (Core 1),
+// single consumer (Core 0), no locks; when the queue is full the message is
+// dropped and counted.
+
+typedef enum
+{
+    LOG_TIMING_PROFILE,   // port, profile name, clock kHz
+    LOG_ACK_TUNE_IDLE,    // -
+    LOG_ACK_TUNE_START,   // -
+    LOG_ACK_TUNE_BEST,    // pulse, wait, percent, percent tenths, successes, tests
+    LOG_ACK_TUNE_LOCKED,  // pulse, wait, percent
+    LOG_ACK_TUNE_RESTART, // -
+    LOG_MSG_COUNT
+} log_msg_t;
+
+#define LOG_ARGS 6
+
+// Core 1: Enqueue a message (never blocks). String arguments must be static
+// (e.g. profile names) and are passed as their address.
+void log_push(log_msg_t msg, const uint32_t args[LOG_ARGS]);
+
+// Enqueue with up to LOG_ARGS arguments; messages without any pass 0
+#define LOG_PUSH(msg, ...) log_push((msg), (const uint32_t[LOG_ARGS]){__VA_ARGS__})
+
+// Core 0: Print up to max queued messages, and a note if any were dropped.
+// Returns the number of messages printed.
+uint32_t log_flush(uint32_t max);
+
+// Core 0: Drop everything queued (Core 1 stopped or not pushing)
+void log_discard(void);
+
+// Messages lost to a full queue since boot
+uint32_t log_get_dropped(void);
+
+#endif // LOG_QUEUE_H
@@ -0,0 +1,302 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "macro.h"
+#include "config.h"
+
+// ============================================================================
+// Macro State
+// ============================================================================
+
+// RLE buffer (written by Core 1 while recording, by Core 0 only while idle)
+static macro_entry_t entries[MACRO_MAX_ENTRIES];
+static volatile uint16_t entry_count = 0;
+
+// Recorder state (written by Core 1 only, once running)
+static volatile macro_state_t state = MACRO_IDLE;
+static volatile bool overflow = false;
+
+// Start/stop request from Core 0 as one word: sequence << 2 | command
+// Core 1 applies a new sequence number on the next poll, so the buffer and
+// playback position are only ever touched from the core that uses them
+typedef enum
+{
+    REQUEST_NONE = 0,
+    REQUEST_RECORD,
+    REQUEST_PLAY,
+    REQUEST_STOP
+} macro_request_t;
+
+#define REQUEST_CMD(word) ((macro_request_t)((word) & 3u))
+#define REQUEST_SEQ(word) ((word) >> 2)
+
+static volatile uint32_t request = 0;
+static volatile uint32_t request_applied = 0; // Last request word Core 1 acted on
+
+// Playback position (Core 1 only)
+static uint16_t play_index = 0;
+static uint16_t play_polls = 0;
+
+// Trigger handling (Core 0 only)
+static psx_button_t trigger = PSX_BTN_COUNT;
+static bool trigger_held = false;
+
+// ============================================================================
+// Core 0 Control
+// ============================================================================
+
+void macro_init(void)
+{
+    state = MACRO_IDLE;
+    entry_count = 0;
+    overflow = false;
+    request = 0;
+    request_applied = 0;
+    play_index = 0;
+    play_polls = 0;
+    trigger = PSX_BTN_COUNT;
+    trigger_held = false;
+}
+
+// Post a request; a later one replaces it if Core 1 has not polled yet
+static void post_request(macro_request_t cmd)
+{
+    uint32_t seq = REQUEST_SEQ(request) + 1;
+    request = (seq << 2) | (uint32_t)cmd;
+}
+
+// True while a request is waiting for the next poll
+static bool request_pending(void)
+{
+    return request != request_applied;
+}
+
+void macro_record_start(void)
+{
+    post_request(REQUEST_RECORD);
+}
+
+bool macro_play_start(void)
+{
+    if (macro_get_state() == MACRO_RECORDING || entry_count == 0)
+    {
+        return false;
+    }
+
+    post_request(REQUEST_PLAY);
+    return true;
+}
+
+void macro_stop(void)
+{
+    post_request(REQUEST_STOP);
+}
+
+macro_state_t macro_get_state(void)
+{
+    // A request not yet taken by Core 1 already decides the state reported
+    uint32_t word = request;
+    if (word != request_applied)
+    {
+        switch (REQUEST_CMD(word))
+        {
+        case REQUEST_RECORD:
+            return MACRO_RECORDING;
+        case REQUEST_PLAY:
+            return MACRO_PLAYING;
+        case REQUEST_STOP:
+            return MACRO_IDLE;
+        default:
+            break;
+        }
+    }
+    return state;
+}
+
+bool macro_overflowed(void)
+{
+    return overflow;
+}
+
+const macro_entry_t *macro_get_entries(uint16_t *count)
+{
+    *count = entry_count;
+    return entries;
+}
+
+uint32_t macro_get_length(void)
+{
+    uint32_t polls = 0;
+    for (uint16_t i = 0; i < entry_count; i++)
+    {
+        polls += entries[i].polls;
+    }
+    return polls;
+}
+
+bool macro_load(const macro_entry_t *src, uint16_t count)
+{
+    // Core 1 must be idle with nothing pending that could touch the buffer
+    if (request_pending() || state != MACRO_IDLE || count > MACRO_MAX_ENTRIES)
+    {
+        return false;
+    }
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        if (src[i].polls == 0)
+        {
+            return false; // Not a valid run
+        }
+        entries[i] = src[i];
+    }
+    entry_count = count;
+    overflow = false;
+    return true;
+}
+
+void macro_set_trigger(psx_button_t button)
+{
+    trigger = button > PSX_BTN_COUNT ? PSX_BTN_COUNT : button;
+    trigger_held = false;
+}
+
+psx_button_t macro_get_trigger(void)
+{
+    return trigger;
+}
+
+uint16_t macro_process_sample(uint16_t buttons)
+{
+    if (trigger == PSX_BTN_COUNT)
+    {
+        return buttons;
+    }
+
+    uint16_t bit = (uint16_t)(1u << trigger);
+    bool pressed = !(buttons & bit);
+
+    // Act on the press edge only
+    if (pressed && !trigger_held)
+    {
+        macro_state_t current = macro_get_state();
+        if (current == MACRO_PLAYING)
+        {
+            macro_stop();
+        }
+        else if (current == MACRO_IDLE)
+        {
+            macro_play_start();
+        }
+    }
+    trigger_held = pressed;
+
+    // The trigger is consumed here and never reaches the console
+    return buttons | bit;
+}
+
+// ============================================================================
+// Core 1 Poll Hook
+// ============================================================================
+
+// Apply a start/stop request posted by Core 0
+static void __time_critical_func(apply_request)(uint32_t word)
+{
+    switch (REQUEST_CMD(word))
+    {
+    case REQUEST_RECORD:
+        entry_count = 0;
+        overflow = false;
+        state = MACRO_RECORDING;
+        break;
+
+    case REQUEST_PLAY:
+        if (entry_count > 0)
+        {
+            play_index = 0;
+            play_polls = 0;
+            state = MACRO_PLAYING;
+        }
+        break;
+
+    case REQUEST_STOP:
+        state = MACRO_IDLE;
+        break;
+
+    default:
+        break;
+    }
+    request_applied = word;
+}
+
+uint16_t __time_critical_func(macro_on_poll)(uint16_t buttons)
+{
+    uint32_t word = request;
+    if (word != request_applied)
+    {
+        apply_request(word);
+    }
+
+    switch (state)
+    {
+    case MACRO_RECORDING:
+    {
+        uint16_t count = entry_count;
+        if (count > 0 && entries[count - 1].buttons == buttons && entries[count - 1].polls < 0xFFFF)
+        {
+            // Same state as the previous poll - extend the run
+            entries[count - 1].polls++;
+        }
+        else if (count < MACRO_MAX_ENTRIES)
+        {
+            entries[count].buttons = buttons;
+            entries[count].polls = 1;
+            entry_count = count + 1;
+        }
+        else
+        {
+            // Buffer full - keep what fits
+            overflow = true;
+            state = MACRO_IDLE;
+        }
+        return buttons;
+    }
+
+    case MACRO_PLAYING:
+    {
+        // Frame for this poll is the current run's button word
+        const macro_entry_t *entry = &entries[play_index];
+        uint16_t frame = entry->buttons;
+
+        if (++play_polls >= entry->polls)
+        {
+            play_polls = 0;
+            if (++play_index >= entry_count)
+            {
+                state = MACRO_IDLE;
+            }
+        }
+        return frame;
+    }
+
+    case MACRO_IDLE:
+    default:
+        return buttons;
+    }
+}
@@ -0,0 +1,92 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef MACRO_H
+#define MACRO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "button_input.h"
+
+// ============================================================================
+// Input Macro Recorder / Player (frame-exact, keyed to 0x42 polls)
+// ============================================================================
+
+// One run of identical polls: the button word sent for `polls` consecutive
+// 0x42 polls (run-length encoded)
+typedef struct
+{
+    uint16_t buttons; // PSX button word (low byte = byte 1, high byte = byte 2)
+    uint16_t polls;   // Number of consecutive polls with this state (1-65535)
+} macro_entry_t;
+
+#define MACRO_MAX_ENTRIES 1000 // Runs kept in RAM (fits one flash sector)
+
+typedef enum
+{
+    MACRO_IDLE = 0,
+    MACRO_RECORDING,
+    MACRO_PLAYING
+} macro_state_t;
+
+// Initialize recorder (empty macro, no trigger)
+void macro_init(void);
+
+// Start/stop requests are posted to Core 1 and take effect on the next 0x42
+// poll; a newer request replaces one Core 1 has not taken yet
+
+// Core 0: Start recording (clears the current macro)
+void macro_record_start(void);
+
+// Core 0: Start playback from the first poll, returns false if empty
+bool macro_play_start(void);
+
+// Core 0: Stop recording or playback
+void macro_stop(void);
+
+// Current recorder state (including a request still pending)
+macro_state_t macro_get_state(void);
+
+// True if the last recording stopped because the buffer was full
+bool macro_overflowed(void);
+
+// Recorded runs (only valid while not recording)
+const macro_entry_t *macro_get_entries(uint16_t *count);
+
+// Total polls covered by the recorded runs
+uint32_t macro_get_length(void);
+
+// Core 0: Replace the macro (e.g. loaded from flash), only while idle with
+// no request pending
+bool macro_load(const macro_entry_t *entries, uint16_t count);
+
+// Core 0: Trigger button (PSX_BTN_COUNT = none)
+void macro_set_trigger(psx_button_t button);
+psx_button_t macro_get_trigger(void);
+
+// Core 0: Handle the trigger button in a sampled button word
+// A press starts playback (or stops it if playing); the trigger bit is
+// released in the returned word so the game never sees it
+uint16_t macro_process_sample(uint16_t buttons);
+
+// Core 1: Called exactly once per 0x42 poll with the outgoing button word
+// Records it, or replaces it with the next recorded frame during playback
+uint16_t macro_on_poll(uint16_t buttons);
+
+#endif // MACRO_H
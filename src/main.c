@@ -18,16 +18,32 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <stdlib.h>
 #include "pico/stdlib.h"
 #include "pico/multicore.h"
 #include "hardware/gpio.h"
 #include "hardware/clocks.h"
+#include "hardware/vreg.h"
 
 #include "config.h"
 #include "shared_state.h"
 #include "button_input.h"
 #include "psx_protocol.h"
+#include "psx_bitbang.h"
 #include "flash_config.h"
+#include "socd.h"
+#include "debounce.h"
+#include "turbo.h"
+#include "macro.h"
+#include "host_link.h"
+#include "inject.h"
+#include "poll_sync.h"
+#include "sniffer.h"
+#include "bench.h"
+#include "selftest.h"
+#include "sched.h"
+#include "log_queue.h"
+#include "persona.h"
 
 // ============================================================================
 // LED Status Management
@@ -56,14 +72,522 @@ void print_startup_message(void)
     printf("Commands:\n");
     printf("  debug      - Toggle debug mode\n");
     printf("  latch      - Toggle latching mode\n");
+    printf("  map        - Show active button map\n");
+    printf("  map <button> <gpio|none> - Remap a PSX button\n");
+    printf("  map reset  - Reset active profile to default\n");
+    printf("  profile <n> - Select button map profile (0-%d)\n", BUTTON_MAP_PROFILE_COUNT - 1);
+    printf("  socd [off|neutral|last|first|up] - Show/set SOCD mode\n");
+    printf("  persona [digital|mouse|negcon] [port] - Show/set device type\n");
+    printf("  debounce [<button|all> <samples>] - Show/set debounce windows\n");
+    printf("  turbo [<button> on|off | rate <polls>] - Show/set turbo\n");
+    printf("  macro [rec|stop|play|save|trigger <button|none>] - Macro recorder\n");
+    printf("  psync [<margin_us>|off] - Show/set phase-locked sampling margin\n");
+    printf("  host       - Show binary host input link statistics\n");
+    printf("  host events on|off - Per-poll notification frames to the host\n");
+    printf("  sniff [on|off] - Passive bus capture streamed to the host\n");
+    printf("  bench      - Run hot-path micro-benchmarks (CSV output)\n");
+    printf("  selftest [khz] - Loopback self-test on jumpered spare pins\n");
+    printf("  selftest sysclk - Edge-to-DAT latency at each system clock\n");
+    printf("  sched [reset] - Core 0 task timing and overruns\n");
     printf("  save       - Save settings to flash\n");
     printf("  help / ?   - Show this message\n");
     printf("\nCurrent settings:\n");
     printf("  Debug mode:    %s\n", debug_mode ? "ON" : "OFF");
     printf("  Latching mode: %s\n", latching_mode ? "ON" : "OFF");
+    printf("  Button map:    profile %u\n", button_map_active());
+    printf("  SOCD mode:     %s\n", socd_mode_name(socd_get_mode()));
+    printf("  Persona:       %s", persona_name(persona_get(0)));
+#if PSX_PORT_COUNT > 1
+    printf(" / %s", persona_name(persona_get(1)));
+#endif
+    printf("\n");
+    printf("  System clock:  %lu MHz\n", clock_get_hz(clk_sys) / 1000000);
+    if (sniffer_is_enabled())
+    {
+        printf("  Sniffer:       ON (controller emulation stopped)\n");
+    }
+    printf("\n");
+}
+
+// ============================================================================
+// Command Arguments
+// ============================================================================
+
+// Parse a decimal argument within [min, max]
+// Rejects signs, trailing characters and out-of-range values
+static bool parse_number(const char *text, uint32_t min, uint32_t max, uint32_t *value)
+{
+    if (text[0] < '0' || text[0] > '9')
+    {
+        return false;
+    }
+
+    char *end;
+    unsigned long parsed = strtoul(text, &end, 10);
+    if (*end != '\0' || parsed < min || parsed > max)
+    {
+        return false;
+    }
+    *value = (uint32_t)parsed;
+    return true;
+}
+
+// Parse "on" or "off"
+static bool parse_on_off(const char *text, bool *on)
+{
+    if (strcmp(text, "on") == 0)
+    {
+        *on = true;
+        return true;
+    }
+    if (strcmp(text, "off") == 0)
+    {
+        *on = false;
+        return true;
+    }
+    return false;
+}
+
+// ============================================================================
+// Button Map Commands
+// ============================================================================
+
+void print_button_map(void)
+{
+    uint8_t profile = button_map_active();
+    const button_map_t *map = button_map_get(profile);
+
+    printf("\nButton map (profile %u):\n", profile);
+    for (int i = 0; i < PSX_BTN_COUNT; i++)
+    {
+        if (map->gpio[i] == BTN_UNASSIGNED)
+        {
+            printf("  %-9s -> none\n", button_name((psx_button_t)i));
+        }
+        else
+        {
+            printf("  %-9s -> GPIO %u\n", button_name((psx_button_t)i), map->gpio[i]);
+        }
+    }
     printf("\n");
 }
 
+// Handle "map" command arguments (argc/argv exclude the command itself)
+void handle_map_command(int argc, char **argv)
+{
+    uint8_t profile = button_map_active();
+
+    if (argc == 0)
+    {
+        print_button_map();
+    }
+    else if (argc == 1 && strcmp(argv[0], "reset") == 0)
+    {
+        button_map_reset(profile);
+        printf("\n>>> Button map profile %u reset to default\n\n", profile);
+    }
+    else if (argc == 2)
+    {
+        psx_button_t button = button_parse_name(argv[0]);
+        if (button == PSX_BTN_COUNT)
+        {
+            printf("\n>>> Unknown button: %s\n\n", argv[0]);
+            return;
+        }
+
+        uint8_t gpio = BTN_UNASSIGNED;
+        if (strcmp(argv[1], "none") != 0)
+        {
+            uint32_t value;
+            if (!parse_number(argv[1], 0, BTN_UNASSIGNED - 1, &value))
+            {
+                printf("\n>>> Invalid GPIO: %s\n\n", argv[1]);
+                return;
+            }
+            gpio = (uint8_t)value;
+        }
+
+        if (button_map_set(profile, button, gpio))
+        {
+            if (gpio == BTN_UNASSIGNED)
+            {
+                printf("\n>>> %s -> none\n\n", button_name(button));
+            }
+            else
+            {
+                printf("\n>>> %s -> GPIO %u\n\n", button_name(button), gpio);
+            }
+        }
+        else
+        {
+            printf("\n>>> GPIO %s cannot be used as a button\n\n", argv[1]);
+        }
+    }
+    else
+    {
+        printf("\n>>> Usage: map [reset | <button> <gpio|none>]\n\n");
+    }
+}
+
+// ============================================================================
+// Debounce Commands
+// ============================================================================
+
+// Handle "debounce" command arguments (argc/argv exclude the command itself)
+void handle_debounce_command(int argc, char **argv)
+{
+    if (argc == 2)
+    {
+        uint32_t samples;
+        if (!parse_number(argv[1], 0, DEBOUNCE_WINDOW_MAX, &samples))
+        {
+            printf("\n>>> Window must be 0-%d samples\n\n", DEBOUNCE_WINDOW_MAX);
+            return;
+        }
+
+        if (strcmp(argv[0], "all") == 0)
+        {
+            for (int i = 0; i < PSX_BTN_COUNT; i++)
+            {
+                debounce_set_window((psx_button_t)i, (uint8_t)samples);
+            }
+        }
+        else
+        {
+            psx_button_t button = button_parse_name(argv[0]);
+            if (button == PSX_BTN_COUNT)
+            {
+                printf("\n>>> Unknown button: %s\n\n", argv[0]);
+                return;
+            }
+            debounce_set_window(button, (uint8_t)samples);
+        }
+    }
+    else if (argc != 0)
+    {
+        printf("\n>>> Usage: debounce [<button|all> <samples>]\n\n");
+        return;
+    }
+
+    printf("\nDebounce windows (samples of %u us):\n", (unsigned)BUTTON_POLL_INTERVAL_US);
+    for (int i = 0; i < PSX_BTN_COUNT; i++)
+    {
+        printf("  %-9s %u\n", button_name((psx_button_t)i), debounce_get_window((psx_button_t)i));
+    }
+    printf("Glitches filtered: %lu\n\n", debounce_get_glitch_count());
+}
+
+// ============================================================================
+// Turbo Commands
+// ============================================================================
+
+// Handle "turbo" command arguments (argc/argv exclude the command itself)
+void handle_turbo_command(int argc, char **argv)
+{
+    if (argc == 2 && strcmp(argv[0], "rate") == 0)
+    {
+        uint32_t rate;
+        if (!parse_number(argv[1], TURBO_RATE_MIN, TURBO_RATE_MAX, &rate) || !turbo_set_rate((uint8_t)rate))
+        {
+            printf("\n>>> Rate must be %d-%d polls\n\n", TURBO_RATE_MIN, TURBO_RATE_MAX);
+            return;
+        }
+    }
+    else if (argc == 2)
+    {
+        psx_button_t button = button_parse_name(argv[0]);
+        if (button == PSX_BTN_COUNT)
+        {
+            printf("\n>>> Unknown button: %s\n\n", argv[0]);
+            return;
+        }
+        bool on;
+        if (!parse_on_off(argv[1], &on))
+        {
+            printf("\n>>> Usage: turbo <button> on|off\n\n");
+            return;
+        }
+        turbo_set_button(button, on);
+    }
+    else if (argc != 0)
+    {
+        printf("\n>>> Usage: turbo [<button> on|off | rate <polls>]\n\n");
+        return;
+    }
+
+    uint16_t mask = turbo_get_mask();
+    printf("\n>>> Turbo: %u polls pressed / %u polls released\n", turbo_get_rate(), turbo_get_rate());
+    printf(">>> Turbo buttons: ");
+    if (mask == 0)
+    {
+        printf("none");
+    }
+    for (int i = 0; i < PSX_BTN_COUNT; i++)
+    {
+        if (mask & (1u << i))
+        {
+            printf("%s ", button_name((psx_button_t)i));
+        }
+    }
+    printf("\n\n");
+}
+
+// ============================================================================
+// Macro Commands
+// ============================================================================
+
+// Handle "macro" command arguments (argc/argv exclude the command itself)
+void handle_macro_command(int argc, char **argv)
+{
+    if (argc == 1 && strcmp(argv[0], "rec") == 0)
+    {
+        macro_record_start();
+        printf("\n>>> Macro recording (one frame per 0x42 poll)...\n\n");
+        return;
+    }
+    else if (argc == 1 && strcmp(argv[0], "stop") == 0)
+    {
+        macro_stop();
+    }
+    else if (argc == 1 && strcmp(argv[0], "play") == 0)
+    {
+        if (!macro_play_start())
+        {
+            printf("\n>>> Nothing to play\n\n");
+            return;
+        }
+        printf("\n>>> Macro playing\n\n");
+        return;
+    }
+    else if (argc == 1 && strcmp(argv[0], "save") == 0)
+    {
+        macro_stop();
+        flash_config_save_macro();
+        printf("\n>>> Macro saved to flash\n\n");
+        return;
+    }
+    else if (argc == 2 && strcmp(argv[0], "trigger") == 0)
+    {
+        psx_button_t button = PSX_BTN_COUNT;
+        if (strcmp(argv[1], "none") != 0)
+        {
+            button = button_parse_name(argv[1]);
+            if (button == PSX_BTN_COUNT)
+            {
+                printf("\n>>> Unknown button: %s\n\n", argv[1]);
+                return;
+            }
+        }
+        macro_set_trigger(button);
+    }
+    else if (argc != 0)
+    {
+        printf("\n>>> Usage: macro [rec|stop|play|save|trigger <button|none>]\n\n");
+        return;
+    }
+
+    static const char *const state_names[] = {"idle", "recording", "playing"};
+    uint16_t count;
+    macro_get_entries(&count);
+    printf("\n>>> Macro: %s, %u runs, %lu polls%s\n", state_names[macro_get_state()],
+           count, macro_get_length(), macro_overflowed() ? " (buffer full)" : "");
+    printf(">>> Trigger: %s\n\n",
+           macro_get_trigger() == PSX_BTN_COUNT ? "none" : button_name(macro_get_trigger()));
+}
+
+// ============================================================================
+// Bus Statistics
+// ============================================================================
+
+// Print transaction, ACK tuning and poll interval statistics of one port
+void print_port_stats(uint8_t port)
+{
+    psx_stats_t stats;
+    psx_get_stats(port, &stats);
+
+#if PSX_PORT_COUNT > 1
+    printf("[Port %u]\n", port + 1);
+#endif
+    printf("Total Trans:  %llu\n", stats.total_transactions);
+    printf("Controller:   %llu\n", stats.controller_transactions);
+    printf("MemCard:      %llu\n", stats.memcard_transactions);
+    printf("Invalid:      %llu\n", stats.invalid_transactions);
+    printf("Timeout:      %llu\n", stats.timeout_errors);
+#if PSX_PORT_COUNT > 1
+    printf("Overlapped:   %llu\n", stats.overlapped_transactions);
+#endif
+#if PSX_INVARIANT_CHECKS
+    if (stats.invariant_violations > 0)
+    {
+        printf("Invariant:    %llu violations (last: %s)\n",
+               stats.invariant_violations, psx_invariant_name(stats.last_violation));
+    }
+#endif
+    if (stats.invalid_transactions > 0)
+    {
+        printf("Last Invalid Addr: 0x%02X\n", stats.last_invalid_addr);
+    }
+    if (stats.errors[PSX_ERROR_UNKNOWN_CMD] > 0)
+    {
+        printf("Last Invalid Cmd:  0x%02X\n", stats.last_invalid_cmd);
+    }
+
+    // Aborts by failure site (only sites that occurred)
+    printf("Errors:      ");
+    bool any_error = false;
+    for (int error = 0; error < PSX_ERROR_COUNT; error++)
+    {
+        if (stats.errors[error] > 0)
+        {
+            printf(" %s=%lu", psx_error_name((uint8_t)error), stats.errors[error]);
+            any_error = true;
+        }
+    }
+    printf(any_error ? "\n" : " none\n");
+
+    // Detected bus speed
+    printf("Bus Speed:    ~%lu kHz, profile %s (gap %lu us, %lu switches)\n",
+           psx_timing_get_clock_khz(port), psx_timing_get_profile(port)->name,
+           psx_timing_get_gap_us(port), psx_timing_get_switches(port));
+    printf("Edge Timeouts:");
+    for (int stage = 0; stage < PSX_TIMEOUT_STAGE_COUNT; stage++)
+    {
+        printf(" %s %lu (%lu us)%s", psx_timeout_stage_name((psx_timeout_stage_t)stage),
+               psx_timing_get_timeouts(port, (psx_timeout_stage_t)stage),
+               psx_timing_get_timeout_us(port, (psx_timeout_stage_t)stage),
+               stage + 1 < PSX_TIMEOUT_STAGE_COUNT ? "," : "\n");
+    }
+
+#if ACK_AUTO_TUNE_ENABLED
+    // ACK auto-tuning status
+    const char *status;
+    if (psx_ack_is_tuning_complete(port))
+    {
+        status = "LOCKED";
+    }
+    else if (psx_ack_is_tuning_started(port))
+    {
+        status = "tuning...";
+    }
+    else
+    {
+        status = "waiting...";
+    }
+    printf("ACK:          PULSE=%lu us, WAIT=%lu us (%s)\n",
+           psx_ack_get_pulse_width(port), psx_ack_get_post_wait(port), status);
+#endif
+
+    // Transaction interval statistics
+    if (stats.controller_transactions > 0)
+    {
+        printf("PSX Interval (us): Min=%lu, Max=%lu, Avg=%lu\n",
+               stats.min_interval_us, stats.max_interval_us, stats.avg_interval_us);
+        printf("PSX Polling Rate:  %.2f Hz\n", 1000000.0f / stats.avg_interval_us);
+    }
+}
+
+// ============================================================================
+// Host Link Commands
+// ============================================================================
+
+void print_host_link_stats(void)
+{
+    host_link_stats_t link;
+    host_link_get_stats(&link);
+
+    printf("\nHost link:\n");
+    printf("  Frames:      %lu accepted\n", link.frames_accepted);
+    printf("  Stale:       %lu dropped (old/duplicate sequence)\n", link.frames_stale);
+    printf("  Lost:        %lu (sequence gaps)\n", link.frames_lost);
+    printf("  CRC errors:  %lu\n", link.crc_errors);
+    printf("  Bad frames:  %lu (unknown type/length)\n", link.bad_frames);
+    printf("  Last seq:    %u\n", link.last_seq);
+
+    inject_stats_t inject;
+    inject_get_stats(&inject);
+    printf("  Polls:       %lu\n", inject.polls);
+    printf("  Injected:    %lu delivered, %lu late, %lu overflow, %lu queued\n",
+           inject.delivered, inject.late, inject.overflows, inject.queued);
+    printf("  Poll events: %s\n\n", host_link_poll_events_enabled() ? "ON" : "OFF");
+}
+
+// ============================================================================
+// Sniffer Commands
+// ============================================================================
+
+void print_sniffer_stats(void)
+{
+    sniffer_stats_t sniff;
+    sniffer_get_stats(&sniff);
+
+    printf("\nSniffer: %s\n", sniffer_is_enabled() ? "ON (controller emulation stopped)" : "OFF");
+    printf("  Bytes:        %lu\n", sniff.records);
+    printf("  Transactions: %lu\n", sniff.transactions);
+    printf("  Dropped:      %lu (ring full)\n", sniff.dropped);
+    printf("  Buffered:     %lu\n\n", sniff.buffered);
+}
+
+// ============================================================================
+// Flash Configuration
+// ============================================================================
+
+// Gather all runtime settings into a flash config image
+void collect_config(flash_config_t *config)
+{
+    memset(config, 0, sizeof(*config));
+    config->debug_mode = debug_mode ? 1 : 0;
+    config->latching_mode = latching_mode ? 1 : 0;
+    config->button_profile = button_map_active();
+    config->socd_mode = (uint8_t)socd_get_mode();
+    config->turbo_rate = turbo_get_rate();
+    config->turbo_mask = turbo_get_mask();
+    config->macro_trigger = (uint8_t)macro_get_trigger();
+    for (uint8_t port = 0; port < PSX_PORT_COUNT; port++)
+    {
+        config->personas |= (uint8_t)(persona_get(port) << (port * 4));
+    }
+    config->poll_sync_margin = (uint16_t)poll_sync_get_margin();
+    for (int i = 0; i < PSX_BTN_COUNT; i++)
+    {
+        config->debounce_windows[i] = debounce_get_window((psx_button_t)i);
+    }
+    for (int p = 0; p < BUTTON_MAP_PROFILE_COUNT; p++)
+    {
+        config->button_maps[p] = *button_map_get(p);
+    }
+}
+
+// Apply a loaded flash config to the runtime settings
+void apply_config(const flash_config_t *config)
+{
+    debug_mode = config->debug_mode ? true : false;
+    latching_mode = config->latching_mode ? true : false;
+    for (int p = 0; p < BUTTON_MAP_PROFILE_COUNT; p++)
+    {
+        if (!button_map_load(p, &config->button_maps[p]))
+        {
+            button_map_reset(p);
+        }
+    }
+    button_map_select(config->button_profile);
+    if (!socd_set_mode((socd_mode_t)config->socd_mode))
+    {
+        socd_init();
+    }
+    for (int i = 0; i < PSX_BTN_COUNT; i++)
+    {
+        debounce_set_window((psx_button_t)i, config->debounce_windows[i]);
+    }
+    turbo_set_mask(config->turbo_mask);
+    turbo_set_rate(config->turbo_rate);
+    macro_set_trigger((psx_button_t)config->macro_trigger);
+    for (uint8_t port = 0; port < PSX_PORT_COUNT; port++)
+    {
+        persona_set(port, (persona_id_t)((config->personas >> (port * 4)) & 0x0F));
+    }
+    poll_sync_set_margin(config->poll_sync_margin);
+}
+
 void led_init(void)
 {
     gpio_init(LED_PIN);
@@ -175,332 +699,691 @@ void led_update(void)
 }
 
 // ============================================================================
-// Core 1 Entry Point - PSX Communication Handler
+// Button Publishing
 // ============================================================================
 
-void core1_entry(void)
-{
-    // Initialize PSX protocol
-    psx_protocol_init();
-
-    // Run protocol task (never returns)
-    psx_protocol_task();
-}
+// Physical button word after debounce and macro trigger handling
+static uint16_t physical_buttons = 0xFFFF;
 
-// ============================================================================
-// Core 0 Main - Button Polling and System Management
-// ============================================================================
+// Last button word written to shared state
+static uint16_t published_buttons = 0xFFFF;
 
-int main(void)
+// Merge all input sources, resolve SOCD and hand the result to Core 1
+void publish_buttons(uint32_t now)
 {
-    // Initialize standard I/O (USB serial for debugging)
-    stdio_init_all();
+    // Sources combine active-LOW: a button is pressed if any source presses it
+    uint16_t buttons = physical_buttons & host_link_buttons(0, now);
 
-    // Small delay to allow USB to initialize
-    sleep_ms(100);
+    // Persona analog inputs from the host (the pad's buttons are the fallback)
+    uint8_t axes[PERSONA_AXES];
+    persona_set_axes(0, host_link_axes(0, now, axes) ? axes : NULL);
 
-    // Initialize flash configuration
-    flash_config_init();
-    
-    // Load saved configuration (if available)
-    if (flash_config_load(&debug_mode, &latching_mode)) {
-        // Configuration loaded from flash
-    } else {
-        // No saved config, use defaults from config.h
-        debug_mode = DEBUG_ENABLED;
-        latching_mode = BUTTON_LATCHING_MODE;
-    }
+    // Resolve opposite directions here so Core 1 only copies bytes
+    uint8_t btn1 = socd_apply((uint8_t)(buttons & 0xFF), now);
+    uint8_t btn2 = (uint8_t)(buttons >> 8);
 
-    // Initialize LED
-    led_init();
-    led_set_status(LED_READY);
+    published_buttons = (uint16_t)(btn1 | (btn2 << 8));
+    shared_state_write(0, btn1, btn2);
 
-    // Initialize button inputs
-    button_input_init();
+#if PSX_PORT_COUNT > 1
+    // Port 2 has no physical pad - it is driven by host input frames only
+    uint16_t port2 = host_link_buttons(1, now);
+    shared_state_write(1, (uint8_t)(port2 & 0xFF), (uint8_t)(port2 >> 8));
+    persona_set_axes(1, host_link_axes(1, now, axes) ? axes : NULL);
+#endif
+}
 
-    // Initialize shared state
-    shared_state_init();
+// Publish a filtered physical button word
+static void publish_sample(uint16_t buttons, uint32_t now)
+{
+    // Macro trigger button starts/stops playback and is not forwarded
+    physical_buttons = macro_process_sample(buttons);
 
+    // Write to shared state for Core 1
+    publish_buttons(now);
+    poll_sync_on_sample(now);
+}
 
-    // Launch Core 1 for PSX communication
-    multicore_launch_core1(core1_entry);
-
-    // Core 0 main loop - button polling
-    uint32_t last_stats_print = 0;
-
-    // Button sampling statistics
-    uint32_t sample_count = 0;
-    uint32_t last_sample_time = 0;
-    uint32_t min_sample_interval = 0;
-    uint32_t max_sample_interval = 0;
-    uint64_t total_sample_interval = 0;
-
-    // Time-based sampling control
-    uint32_t next_sample_time = time_us_32();
+// Read physical buttons and publish the result (fixed-rate sample)
+void sample_buttons(uint32_t now)
+{
+    // Read button states through the active remap table
+    // and drop changes shorter than each button's debounce window
+    publish_sample(debounce_update(button_read_all()), now);
+}
 
-    // Button state variables
-    uint8_t btn1 = 0xFF;
-    uint8_t btn2 = 0xFF;
+// ============================================================================
+// Serial Console
+// ============================================================================
 
-    // Print startup message
-    print_startup_message();
+// Execute one complete text command line
+void process_command(char *cmd_buffer)
+{
+    // Split into command and arguments
+    char *argv[4];
+    int argc = 0;
+    char *token = strtok(cmd_buffer, " ");
+    while (token != NULL && argc < 4)
+    {
+        argv[argc++] = token;
+        token = strtok(NULL, " ");
+    }
 
-    while (1)
+    // Check for "debug" command
+    if (strcmp(cmd_buffer, "debug") == 0)
     {
-        // Check for serial input (debug toggle command)
-        int ch = getchar_timeout_us(0); // Non-blocking read
-        if (ch != PICO_ERROR_TIMEOUT)
+        debug_mode = !debug_mode;
+        printf("\n>>> Debug mode: %s\n\n", debug_mode ? "ON" : "OFF");
+    }
+    // Check for "latch" command
+    else if (strcmp(cmd_buffer, "latch") == 0)
+    {
+        latching_mode = !latching_mode;
+        printf("\n>>> Latching mode: %s\n\n", latching_mode ? "ON" : "OFF");
+    }
+    // Check for "help" or "?" command
+    else if (strcmp(cmd_buffer, "help") == 0 || strcmp(cmd_buffer, "?") == 0)
+    {
+        print_startup_message();
+    }
+    // Check for "map" command
+    else if (strcmp(cmd_buffer, "map") == 0)
+    {
+        handle_map_command(argc - 1, &argv[1]);
+    }
+    // Check for "profile" command
+    else if (strcmp(cmd_buffer, "profile") == 0)
+    {
+        uint32_t profile;
+        if (argc == 2 && parse_number(argv[1], 0, BUTTON_MAP_PROFILE_COUNT - 1, &profile) &&
+            button_map_select((uint8_t)profile))
         {
-            static char cmd_buffer[32];
-            static uint8_t cmd_pos = 0;
-
-            if (ch == '\r' || ch == '\n')
+            printf("\n>>> Button map profile: %u\n\n", button_map_active());
+        }
+        else
+        {
+            printf("\n>>> Usage: profile <0-%d>\n\n", BUTTON_MAP_PROFILE_COUNT - 1);
+        }
+    }
+    // Check for "socd" command
+    else if (strcmp(cmd_buffer, "socd") == 0)
+    {
+        if (argc == 2)
+        {
+            socd_mode_t mode = socd_parse_mode(argv[1]);
+            if (mode == SOCD_MODE_COUNT)
             {
-                // Command complete
-                if (cmd_pos > 0)
-                {
-                    cmd_buffer[cmd_pos] = '\0';
-
-                    // Check for "debug" command
-                    if (strcmp(cmd_buffer, "debug") == 0)
-                    {
-                        debug_mode = !debug_mode;
-                        printf("\n>>> Debug mode: %s\n\n", debug_mode ? "ON" : "OFF");
-                    }
-                    // Check for "latch" command
-                    else if (strcmp(cmd_buffer, "latch") == 0)
-                    {
-                        latching_mode = !latching_mode;
-                        printf("\n>>> Latching mode: %s\n\n", latching_mode ? "ON" : "OFF");
-                    }
-                    // Check for "help" or "?" command
-                    else if (strcmp(cmd_buffer, "help") == 0 || strcmp(cmd_buffer, "?") == 0)
-                    {
-                        print_startup_message();
-                    }
-                    // Check for "save" command
-                    else if (strcmp(cmd_buffer, "save") == 0)
-                    {
-                        flash_config_save(debug_mode, latching_mode);
-                        printf("\n>>> Settings saved to flash\n\n");
-                    }
-
-                    cmd_pos = 0;
-                }
+                printf("\n>>> Unknown SOCD mode: %s\n\n", argv[1]);
             }
-            else if (ch >= 32 && ch < 127 && cmd_pos < sizeof(cmd_buffer) - 1)
+            else
             {
-                // Printable character
-                cmd_buffer[cmd_pos++] = ch;
+                socd_set_mode(mode);
             }
         }
-        // Check if it's time to sample buttons
-        uint32_t current_time = time_us_32();
-        if ((int32_t)(next_sample_time - current_time) <= 0)
+        printf("\n>>> SOCD mode: %s\n\n", socd_mode_name(socd_get_mode()));
+    }
+    // Check for "persona" command
+    else if (strcmp(cmd_buffer, "persona") == 0)
+    {
+        uint32_t port = 1;
+        if (argc == 2 || argc == 3)
         {
-            // Time to sample - read button states
-            btn1 = button_read_byte1();
-            btn2 = button_read_byte2();
-
-            // Calculate actual sampling interval
-            if (last_sample_time != 0)
+            persona_id_t persona = persona_parse(argv[1]);
+            if (persona == PERSONA_COUNT)
             {
-                uint32_t interval = current_time - last_sample_time;
-                if (min_sample_interval == 0 || interval < min_sample_interval)
-                {
-                    min_sample_interval = interval;
-                }
-                if (interval > max_sample_interval)
-                {
-                    max_sample_interval = interval;
-                }
-                total_sample_interval += interval;
-                sample_count++;
+                printf("\n>>> Unknown persona: %s\n\n", argv[1]);
             }
-            last_sample_time = current_time;
+            else if ((argc == 3 && !parse_number(argv[2], 1, PSX_PORT_COUNT, &port)) ||
+                     !persona_set((uint8_t)(port - 1), persona))
+            {
+                printf("\n>>> Usage: persona [digital|mouse|negcon] [1-%d]\n\n", PSX_PORT_COUNT);
+            }
+        }
+        for (uint8_t p = 0; p < PSX_PORT_COUNT; p++)
+        {
+            printf("\n>>> Port %u persona: %s", p + 1, persona_name(persona_get(p)));
+        }
+        printf("\n\n");
+    }
+    // Check for "debounce" command
+    else if (strcmp(cmd_buffer, "debounce") == 0)
+    {
+        handle_debounce_command(argc - 1, &argv[1]);
+    }
+    // Check for "turbo" command
+    else if (strcmp(cmd_buffer, "turbo") == 0)
+    {
+        handle_turbo_command(argc - 1, &argv[1]);
+    }
+    // Check for "macro" command
+    else if (strcmp(cmd_buffer, "macro") == 0)
+    {
+        handle_macro_command(argc - 1, &argv[1]);
+    }
+    // Check for "psync" command
+    else if (strcmp(cmd_buffer, "psync") == 0)
+    {
+        if (argc == 2)
+        {
+            uint32_t margin = 0;
+            if ((strcmp(argv[1], "off") != 0 && !parse_number(argv[1], 0, POLL_SYNC_MARGIN_MAX, &margin)) ||
+                !poll_sync_set_margin(margin))
+            {
+                printf("\n>>> Margin must be 0-%d us or off\n\n", POLL_SYNC_MARGIN_MAX);
+            }
+        }
+        if (poll_sync_get_margin() == 0)
+        {
+            printf("\n>>> Phase-locked sampling: OFF\n\n");
+        }
+        else
+        {
+            printf("\n>>> Phase-locked sampling: %lu us before each poll\n\n", poll_sync_get_margin());
+        }
+    }
+    // Check for "host" command
+    else if (strcmp(cmd_buffer, "host") == 0)
+    {
+        bool on;
+        if (argc == 3 && strcmp(argv[1], "events") == 0 && parse_on_off(argv[2], &on))
+        {
+            host_link_set_poll_events(on);
+        }
+        else if (argc != 1)
+        {
+            printf("\n>>> Usage: host [events on|off]\n\n");
+            return;
+        }
+        print_host_link_stats();
+    }
+    // Check for "sniff" command
+    else if (strcmp(cmd_buffer, "sniff") == 0)
+    {
+        bool on;
+        if (argc == 2 && parse_on_off(argv[1], &on))
+        {
+            sniffer_set_enabled(on);
+        }
+        else if (argc != 1)
+        {
+            printf("\n>>> Usage: sniff [on|off]\n\n");
+            return;
+        }
+        print_sniffer_stats();
+    }
+    // Check for "bench" command
+    else if (strcmp(cmd_buffer, "bench") == 0)
+    {
+        bench_run();
+    }
+    // Check for "selftest" command
+    else if (strcmp(cmd_buffer, "selftest") == 0)
+    {
+        if (sniffer_is_enabled())
+        {
+            printf("\n>>> Self-test needs controller emulation (sniff off)\n\n");
+        }
+        else if (argc == 2 && strcmp(argv[1], "sysclk") == 0)
+        {
+            selftest_clock_report();
+        }
+        else
+        {
+            uint32_t khz = 0;
+            if (argc == 2 && !parse_number(argv[1], 1, SELFTEST_CLOCK_KHZ_MAX, &khz))
+            {
+                printf("\n>>> Usage: selftest [<1-%d kHz>|sysclk]\n\n", SELFTEST_CLOCK_KHZ_MAX);
+                return;
+            }
+            selftest_report(khz);
+        }
+    }
+    // Check for "sched" command
+    else if (strcmp(cmd_buffer, "sched") == 0)
+    {
+        if (argc == 2 && strcmp(argv[1], "reset") == 0)
+        {
+            sched_reset_stats();
+            printf("\n>>> Task statistics cleared\n\n");
+        }
+        else
+        {
+            sched_print_stats();
+        }
+    }
+    // Check for "save" command
+    else if (strcmp(cmd_buffer, "save") == 0)
+    {
+        static flash_config_t config;
+        collect_config(&config);
+        flash_config_save(&config);
+        printf("\n>>> Settings saved to flash\n\n");
+    }
+}
+
+// ============================================================================
+// Core 1 Entry Point - PSX Communication Handler
+// ============================================================================
 
-            // Schedule next sample
-            next_sample_time += BUTTON_POLL_INTERVAL_US;
+void core1_entry(void)
+{
+    // Listen-only capture instead of controller emulation
+    if (sniffer_is_enabled())
+    {
+        sniffer_task();
+    }
 
-            // Write to shared state for Core 1
-            shared_state_write(btn1, btn2);
-        }
+    // Initialize PSX protocol and the poll-side state it drives
+    psx_protocol_init();
+    inject_core1_start();
 
-        // Update LED and statistics
-        static uint64_t last_trans_count = 0;
-        static uint32_t last_activity_time = 0;
-        static bool activity_initialized = false;
-        uint32_t now = time_us_32();
+    // Run protocol task (never returns)
+    psx_protocol_task();
+}
 
-        psx_stats_t stats;
-        psx_get_stats(&stats);
+// Stop Core 1 before Core 0 takes the bus or the flash. The protocol task is
+// parked between transactions first so no seqlock is left odd; the sniffer
+// loop publishes nothing Core 0 waits on and is reset directly.
+void core1_stop(void)
+{
+    if (!sniffer_is_enabled() && !psx_protocol_park(PSX_PARK_TIMEOUT_US))
+    {
+        printf("Core1 did not park, resetting anyway\n");
+    }
+    multicore_reset_core1();
+}
+
+// ============================================================================
+// Core 0 Tasks
+// ============================================================================
 
-        // Initialize activity time on first run
-        if (!activity_initialized)
+// Button sampling statistics (reset with every debug stats print)
+static uint32_t sample_count = 0;
+static uint32_t last_sample_time = 0;
+static uint32_t min_sample_interval = 0;
+static uint32_t max_sample_interval = 0;
+static uint64_t total_sample_interval = 0;
+
+// Fixed-rate button sampling
+static void task_sample(uint32_t now)
+{
+    sample_buttons(now);
+
+    // Calculate actual sampling interval
+    if (last_sample_time != 0)
+    {
+        uint32_t interval = now - last_sample_time;
+        if (min_sample_interval == 0 || interval < min_sample_interval)
         {
-            last_activity_time = now;
-            activity_initialized = true;
-            // Set initial state to READY (no transactions yet)
-            led_set_status(LED_READY);
+            min_sample_interval = interval;
         }
+        if (interval > max_sample_interval)
+        {
+            max_sample_interval = interval;
+        }
+        total_sample_interval += interval;
+        sample_count++;
+    }
+    last_sample_time = now;
+}
+
+// Phase-locked sample just before the next expected console poll
+// (extra sample - not counted in the fixed-rate interval statistics).
+// It lands on the first run of this task after the due time, so the
+// sample-to-poll lead is the margin minus 0 - SCHED_PSYNC_PERIOD_US.
+static void task_poll_sync(uint32_t now)
+{
+    uint32_t poll, poll_time;
+    bool injected;
+    inject_read_last_poll(&poll, &poll_time, &injected);
+    poll_sync_update(poll, poll_time);
+
+    if (poll_sync_sample_due(now))
+    {
+        // Debounce windows count fixed-rate samples: read through the filter
+        // without advancing it
+        publish_sample(debounce_peek(button_read_all()), now);
+    }
+}
 
-        // Check for controller transactions only (not memory card)
-        if (stats.controller_transactions > last_trans_count)
+// Serial console, binary host link and sniffer streaming
+static void task_serial(uint32_t now)
+{
+    (void)now;
+
+    // Drain serial input: binary host frames and text commands share the link
+    for (int n = 0; n < HOST_LINK_RX_BURST; n++)
+    {
+        int ch = getchar_timeout_us(0); // Non-blocking read
+        if (ch == PICO_ERROR_TIMEOUT)
         {
-            // Controller activity detected - POLL is happening
-            last_trans_count = stats.controller_transactions;
-            last_activity_time = now;
+            break;
+        }
 
-            // Set LED to POLLING state
-            led_set_status(LED_POLLING);
+        // Bytes belonging to a binary frame never reach the text parser
+        if (host_link_feed((uint8_t)ch))
+        {
+            continue;
         }
-        else
+
+        static char cmd_buffer[32];
+        static uint8_t cmd_pos = 0;
+
+        if (ch == '\r' || ch == '\n')
         {
-            if (debug_mode)
+            // Command complete
+            if (cmd_pos > 0)
             {
-                // Debug mode: Turn off LED quickly (1ms after last transaction)
-                if ((now - last_activity_time) > 1000)
-                {
-                    if (stats.invalid_transactions > 0 || stats.timeout_errors > 0)
-                    {
-                        led_set_status(LED_ERROR);
-                    }
-                    else
-                    {
-                        led_set_status(LED_READY);
-                    }
-                }
-            }
-            else
-            {
-                // Non-debug mode: Change state after 1 second of inactivity
-                if ((now - last_activity_time) > 1000000)
-                {
-                    if (stats.invalid_transactions > 0 || stats.timeout_errors > 0)
-                    {
-                        if (current_led_status != LED_ERROR)
-                        {
-                            led_set_status(LED_ERROR);
-                        }
-                    }
-                    else
-                    {
-                        if (current_led_status != LED_READY)
-                        {
-                            led_set_status(LED_READY);
-                        }
-                    }
-                }
+                cmd_buffer[cmd_pos] = '\0';
+                process_command(cmd_buffer);
+                cmd_pos = 0;
             }
         }
+        else if (ch >= 32 && ch < 127 && cmd_pos < sizeof(cmd_buffer) - 1)
+        {
+            // Printable character
+            cmd_buffer[cmd_pos++] = ch;
+        }
+    }
 
-        led_update();
+    // Host input frame received - publish it now instead of waiting for the next sample
+    if (host_link_take_input())
+    {
+        publish_buttons(time_us_32());
+    }
 
-        // Debug output every 2 seconds
+    // Tell the host about new polls (closed-loop injection)
+    host_link_task();
+    if (sniffer_is_enabled())
+    {
+        sniffer_stream_task();
+    }
+}
+
+// LED reflects activity and errors of all ports
+static void task_led(uint32_t now)
+{
+    static uint64_t last_trans_count = 0;
+    static uint32_t last_activity_time = 0;
+    static bool activity_initialized = false;
+
+    psx_stats_t stats = {0};
+    for (uint8_t port = 0; port < PSX_PORT_COUNT; port++)
+    {
+        psx_stats_t port_stats;
+        psx_get_stats(port, &port_stats);
+        stats.controller_transactions += port_stats.controller_transactions;
+        stats.invalid_transactions += port_stats.invalid_transactions;
+        stats.timeout_errors += port_stats.timeout_errors;
+    }
+
+    // Initialize activity time on first run
+    if (!activity_initialized)
+    {
+        last_activity_time = now;
+        activity_initialized = true;
+        // Set initial state to READY (no transactions yet)
+        led_set_status(LED_READY);
+    }
+
+    // Check for controller transactions only (not memory card)
+    if (stats.controller_transactions > last_trans_count)
+    {
+        // Controller activity detected - POLL is happening
+        last_trans_count = stats.controller_transactions;
+        last_activity_time = now;
+
+        // Set LED to POLLING state
+        led_set_status(LED_POLLING);
+    }
+    else
+    {
         if (debug_mode)
         {
-            static uint32_t stats_print_count = 0;
-            if ((now - last_stats_print) > 2000000)
+            // Debug mode: Turn off LED quickly (1ms after last transaction)
+            if ((now - last_activity_time) > 1000)
             {
-                stats_print_count++;
-                printf("\n=== Stats #%lu ===\n", stats_print_count);
-                printf("Total Trans:  %llu\n", stats.total_transactions);
-                printf("Controller:   %llu\n", stats.controller_transactions);
-                printf("MemCard:      %llu\n", stats.memcard_transactions);
-                printf("Invalid:      %llu\n", stats.invalid_transactions);
-                printf("Timeout:      %llu\n", stats.timeout_errors);
-                if (stats.invalid_transactions > 0)
+                if (stats.invalid_transactions > 0 || stats.timeout_errors > 0)
                 {
-                    printf("Last Invalid Addr: 0x%02X, Cmd: 0x%02X\n", stats.last_invalid_addr, stats.last_invalid_cmd);
+                    led_set_status(LED_ERROR);
                 }
-
-#if ACK_AUTO_TUNE_ENABLED
-                // ACK auto-tuning status
-                extern uint32_t psx_ack_get_pulse_width(void);
-                extern uint32_t psx_ack_get_post_wait(void);
-                extern bool psx_ack_is_tuning_complete(void);
-                extern bool psx_ack_is_tuning_started(void);
-
-                const char *status;
-                if (psx_ack_is_tuning_complete())
+                else
                 {
-                    status = "LOCKED";
+                    led_set_status(LED_READY);
                 }
-                else if (psx_ack_is_tuning_started())
+            }
+        }
+        else
+        {
+            // Non-debug mode: Change state after 1 second of inactivity
+            if ((now - last_activity_time) > 1000000)
+            {
+                if (stats.invalid_transactions > 0 || stats.timeout_errors > 0)
                 {
-                    status = "tuning...";
+                    if (current_led_status != LED_ERROR)
+                    {
+                        led_set_status(LED_ERROR);
+                    }
                 }
                 else
                 {
-                    status = "waiting...";
+                    if (current_led_status != LED_READY)
+                    {
+                        led_set_status(LED_READY);
+                    }
                 }
-                printf("ACK:          PULSE=%lu us, WAIT=%lu us (%s)\n",
-                       psx_ack_get_pulse_width(), psx_ack_get_post_wait(), status);
+            }
+        }
+    }
+
+    led_update();
+}
+
+// Messages queued by Core 1 (it never prints itself)
+static void task_log(uint32_t now)
+{
+    (void)now;
+    log_flush(LOG_FLUSH_BURST);
+}
+
+// Debug output every 2 seconds
+static void task_stats(uint32_t now)
+{
+    (void)now;
+
+    if (!debug_mode)
+    {
+        return;
+    }
+
+    static uint32_t stats_print_count = 0;
+    stats_print_count++;
+    printf("\n=== Stats #%lu ===\n", stats_print_count);
+    for (uint8_t port = 0; port < PSX_PORT_COUNT; port++)
+    {
+        print_port_stats(port);
+    }
+
+    // Button sampling statistics
+    printf("BTN Target Rate:   %.2f Hz (%lu us)\n",
+           1000000.0f / BUTTON_POLL_INTERVAL_US, (uint32_t)BUTTON_POLL_INTERVAL_US);
+    if (sample_count > 0)
+    {
+        uint32_t avg_sample_interval = (uint32_t)(total_sample_interval / sample_count);
+        printf("BTN Interval (us): Min=%lu, Max=%lu, Avg=%lu\n",
+               min_sample_interval, max_sample_interval, avg_sample_interval);
+        printf("BTN Sample Rate:   %.2f Hz (actual)\n", 1000000.0f / avg_sample_interval);
+    }
+
+    printf("BTN Glitches:      %lu (filtered)\n", debounce_get_glitch_count());
+
+    // Phase-locked sampling statistics
+    poll_sync_stats_t sync;
+    poll_sync_get_stats(&sync);
+    if (poll_sync_get_margin() == 0)
+    {
+        printf("Poll Sync:         OFF\n");
+    }
+    else
+    {
+        printf("Poll Sync:         %s, margin=%lu us, period=%lu.%02lu us, phase err avg=%lu max=%lu us\n",
+               sync.locked ? "LOCKED" : "learning...", poll_sync_get_margin(),
+               sync.period_q8 >> 8, ((sync.period_q8 & 0xFF) * 100) >> 8,
+               sync.phase_err_avg, sync.phase_err_max);
+    }
+    if (sync.age_count > 0)
+    {
+        printf("Sample Age (us):   Min=%lu, Max=%lu, Avg=%lu, StdDev=%lu\n",
+               sync.age_min, sync.age_max, sync.age_avg, sync.age_stddev);
+    }
+
+    // Core 1 idle time and wake-up latency
+    psx_idle_stats_t idle;
+    psx_get_idle_stats(&idle);
+    if (idle.elapsed_us > 0)
+    {
+        uint32_t idle_permille = (uint32_t)(idle.idle_us * 1000 / idle.elapsed_us);
+#if PSX_IDLE_WFE
+        // Estimate: a sleeping core draws next to nothing compared to a spinning one
+        uint32_t saved_ma_x10 = idle_permille * PSX_IDLE_CORE_MA * (clock_get_hz(clk_sys) / 1000000) / 12500;
+        printf("Core1 Idle:        %lu.%lu%% asleep (WFE), ~%lu.%lu mA saved (est.), %lu wakeups, %lu spurious\n",
+               idle_permille / 10, idle_permille % 10, saved_ma_x10 / 10, saved_ma_x10 % 10,
+               idle.wakeups, idle.spurious);
+        printf("Wake Latency (ns): Min=%lu, Max=%lu, <250:%lu <500:%lu <1000:%lu <2000:%lu >=2000:%lu\n",
+               idle.wake_min_ns, idle.wake_max_ns, idle.wake_hist[0], idle.wake_hist[1],
+               idle.wake_hist[2], idle.wake_hist[3], idle.wake_hist[4]);
+#else
+        printf("Core1 Idle:        %lu.%lu%% spinning (PSX_IDLE_WFE off)\n", idle_permille / 10, idle_permille % 10);
 #endif
+    }
 
-                // Transaction interval statistics
-                if (stats.controller_transactions > 0)
-                {
-                    printf("PSX Interval (us): Min=%lu, Max=%lu, Avg=%lu\n",
-                           stats.min_interval_us, stats.max_interval_us, stats.avg_interval_us);
-                    printf("PSX Polling Rate:  %.2f Hz\n", 1000000.0f / stats.avg_interval_us);
-                }
+    if (log_get_dropped() > 0)
+    {
+        printf("Log Queue:         %lu messages dropped\n", log_get_dropped());
+    }
 
-                // Button sampling statistics
-                printf("BTN Target Rate:   %.2f Hz (%lu us)\n",
-                       1000000.0f / BUTTON_POLL_INTERVAL_US, (uint32_t)BUTTON_POLL_INTERVAL_US);
-                if (sample_count > 0)
-                {
-                    uint32_t avg_sample_interval = (uint32_t)(total_sample_interval / sample_count);
-                    printf("BTN Interval (us): Min=%lu, Max=%lu, Avg=%lu\n",
-                           min_sample_interval, max_sample_interval, avg_sample_interval);
-                    printf("BTN Sample Rate:   %.2f Hz (actual)\n", 1000000.0f / avg_sample_interval);
-                }
+    uint8_t btn1 = (uint8_t)(published_buttons & 0xFF);
+    uint8_t btn2 = (uint8_t)(published_buttons >> 8);
+    printf("Buttons:      0x%02X 0x%02X\n", btn1, btn2);
 
-                printf("Buttons:      0x%02X 0x%02X\n", btn1, btn2);
-
-                // Show individual button states
-                printf("Pressed: ");
-                if (!(btn1 & 0x01))
-                    printf("SELECT ");
-                if (!(btn1 & 0x08))
-                    printf("START ");
-                if (!(btn1 & 0x10))
-                    printf("UP ");
-                if (!(btn1 & 0x20))
-                    printf("RIGHT ");
-                if (!(btn1 & 0x40))
-                    printf("DOWN ");
-                if (!(btn1 & 0x80))
-                    printf("LEFT ");
-                if (!(btn2 & 0x01))
-                    printf("L2 ");
-                if (!(btn2 & 0x02))
-                    printf("R2 ");
-                if (!(btn2 & 0x04))
-                    printf("L1 ");
-                if (!(btn2 & 0x08))
-                    printf("R1 ");
-                if (!(btn2 & 0x10))
-                    printf("△ ");
-                if (!(btn2 & 0x20))
-                    printf("○ ");
-                if (!(btn2 & 0x40))
-                    printf("☓ ");
-                if (!(btn2 & 0x80))
-                    printf("□ ");
-                printf("\n");
-
-                // Reset interval statistics for next period
-                psx_reset_interval_stats();
-                sample_count = 0;
-                min_sample_interval = 0;
-                max_sample_interval = 0;
-                total_sample_interval = 0;
-
-                last_stats_print = now;
-            }
-        }
+    // Show individual button states
+    printf("Pressed: ");
+    if (!(btn1 & 0x01))
+        printf("SELECT ");
+    if (!(btn1 & 0x08))
+        printf("START ");
+    if (!(btn1 & 0x10))
+        printf("UP ");
+    if (!(btn1 & 0x20))
+        printf("RIGHT ");
+    if (!(btn1 & 0x40))
+        printf("DOWN ");
+    if (!(btn1 & 0x80))
+        printf("LEFT ");
+    if (!(btn2 & 0x01))
+        printf("L2 ");
+    if (!(btn2 & 0x02))
+        printf("R2 ");
+    if (!(btn2 & 0x04))
+        printf("L1 ");
+    if (!(btn2 & 0x08))
+        printf("R1 ");
+    if (!(btn2 & 0x10))
+        printf("△ ");
+    if (!(btn2 & 0x20))
+        printf("○ ");
+    if (!(btn2 & 0x40))
+        printf("☓ ");
+    if (!(btn2 & 0x80))
+        printf("□ ");
+    printf("\n");
+
+    // Reset interval statistics for next period
+    psx_reset_interval_stats();
+    poll_sync_reset_stats();
+    sample_count = 0;
+    min_sample_interval = 0;
+    max_sample_interval = 0;
+    total_sample_interval = 0;
+}
+
+// Highest priority first; budgets only feed the overrun counters
+static sched_task_t core0_tasks[] = {
+    SCHED_TASK("sample", task_sample, BUTTON_POLL_INTERVAL_US, 100, 0),
+    SCHED_TASK("psync", task_poll_sync, SCHED_PSYNC_PERIOD_US, 50, 1),
+    SCHED_TASK("serial", task_serial, SCHED_SERIAL_PERIOD_US, 1000, 2),
+    SCHED_TASK("led", task_led, SCHED_LED_PERIOD_US, 100, 3),
+    SCHED_TASK("log", task_log, SCHED_LOG_PERIOD_US, 1000, 3),
+    SCHED_TASK("stats", task_stats, 2000000, 50000, 3),
+};
+
+// ============================================================================
+// Core 0 Main - Button Polling and System Management
+// ============================================================================
+
+int main(void)
+{
+    // Overclock before stdio so USB and UART come up on the final clocks
+#if SYS_CLOCK_KHZ > 133000
+    vreg_set_voltage(SYS_CLOCK_VREG_VOLTAGE);
+    busy_wait_us_32(10000); // Let the regulator settle
+#endif
+#if SYS_CLOCK_KHZ != 125000
+    set_sys_clock_khz(SYS_CLOCK_KHZ, true);
+#endif
+
+    // Initialize standard I/O (USB serial for debugging)
+    stdio_init_all();
+
+    // Small delay to allow USB to initialize
+    sleep_ms(100);
+
+    // Initialize button inputs (all map profiles start as the config.h layout)
+    button_input_init();
+    debounce_init();
+    socd_init();
+    persona_init();
+    turbo_init();
+    macro_init();
+    inject_init();
+    poll_sync_init();
+
+    // Initialize flash configuration
+    flash_config_init();
+    
+    // Load saved configuration (if available)
+    static flash_config_t saved_config;
+    if (flash_config_load(&saved_config)) {
+        // Configuration loaded from flash
+        apply_config(&saved_config);
+    } else {
+        // No saved config, use defaults from config.h
+        debug_mode = DEBUG_ENABLED;
+        latching_mode = BUTTON_LATCHING_MODE;
+    }
+
+    // Load recorded macro (if available)
+    flash_config_load_macro();
+
+    // Initialize LED
+    led_init();
+    led_set_status(LED_READY);
+
+    // Initialize shared state
+    shared_state_init();
+
+
+    // Launch Core 1 for PSX communication
+    multicore_launch_core1(core1_entry);
+
+    // Print startup message
+    print_startup_message();
+
+    // Core 0 main loop - deadline scheduler (sleeps between tasks)
+    sched_init(core0_tasks, sizeof(core0_tasks) / sizeof(core0_tasks[0]));
+    while (1)
+    {
+        sched_run();
     }
 
     return 0;
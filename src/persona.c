@@ -0,0 +1,333 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "persona.h"
+#include "psx_device.h"
+#include "seqlock.h"
+#include "hardware/sync.h"
+#include "pico/stdlib.h"
+#include <string.h>
+
+_Static_assert(1 + PERSONA_PAYLOAD_MAX <= PSX_DEVICE_FRAME_MAX, "persona frame exceeds PSX_DEVICE_FRAME_MAX");
+
+// ============================================================================
+// Descriptors
+// ============================================================================
+
+#define FILL_CONST(value) {.op = PERSONA_FILL_CONST, .arg = (value), .low = PERSONA_NO_BUTTON, .high = PERSONA_NO_BUTTON}
+#define FILL_BUTTONS_LO {.op = PERSONA_FILL_BUTTONS_LO, .low = PERSONA_NO_BUTTON, .high = PERSONA_NO_BUTTON}
+#define FILL_BUTTONS_HI {.op = PERSONA_FILL_BUTTONS_HI, .low = PERSONA_NO_BUTTON, .high = PERSONA_NO_BUTTON}
+#define FILL_AXIS(axis, rest_value, btn_low, btn_high) \
+    {.op = PERSONA_FILL_AXIS, .arg = (axis), .rest = (rest_value), .low = (btn_low), .high = (btn_high)}
+#define FILL_MOTION(axis, btn_low, btn_high) \
+    {.op = PERSONA_FILL_MOTION, .arg = (axis), .low = (btn_low), .high = (btn_high)}
+
+#define BTN(b) (1u << (b))
+
+static const persona_desc_t descriptors[PERSONA_COUNT] = {
+    [PERSONA_DIGITAL] = {
+        .name = "digital",
+        .type = 0x4,
+        .released_mask = 0,
+        .payload_len = 2,
+        .payload = {FILL_BUTTONS_LO, FILL_BUTTONS_HI},
+    },
+    [PERSONA_MOUSE] = {
+        .name = "mouse",
+        .type = 0x1,
+        .released_mask = (uint16_t)~(BTN(PSX_BTN_L1) | BTN(PSX_BTN_R1)),
+        .zero_mask = BTN(PSX_BTN_L2) | BTN(PSX_BTN_R2), // Idle byte 2 is 0xFC
+        .payload_len = 4,
+        .payload = {
+            FILL_BUTTONS_LO,
+            FILL_BUTTONS_HI,
+            FILL_MOTION(0, PSX_BTN_LEFT, PSX_BTN_RIGHT), // X, positive = right
+            FILL_MOTION(1, PSX_BTN_UP, PSX_BTN_DOWN),    // Y, positive = down
+        },
+    },
+    [PERSONA_NEGCON] = {
+        .name = "negcon",
+        .type = 0x2,
+        .released_mask = (uint16_t)~(BTN(PSX_BTN_START) | BTN(PSX_BTN_UP) | BTN(PSX_BTN_RIGHT) |
+                                     BTN(PSX_BTN_DOWN) | BTN(PSX_BTN_LEFT) | BTN(PSX_BTN_R1) |
+                                     BTN(PSX_BTN_TRIANGLE) | BTN(PSX_BTN_CIRCLE)),
+        .payload_len = 6,
+        .payload = {
+            FILL_BUTTONS_LO,
+            FILL_BUTTONS_HI,
+            FILL_AXIS(0, 0x80, PSX_BTN_L2, PSX_BTN_R2),            // Twist, 0x00 = left
+            FILL_AXIS(1, 0x00, PERSONA_NO_BUTTON, PSX_BTN_CROSS),  // I
+            FILL_AXIS(2, 0x00, PERSONA_NO_BUTTON, PSX_BTN_SQUARE), // II
+            FILL_AXIS(3, 0x00, PERSONA_NO_BUTTON, PSX_BTN_L1),     // L
+        },
+    },
+};
+
+// ============================================================================
+// Compiled Templates
+// ============================================================================
+
+// A payload byte that changes per poll
+typedef struct
+{
+    uint8_t index; // Position in the frame
+    persona_fill_t fill;
+} persona_slot_t;
+
+typedef struct
+{
+    uint8_t id;        // First response byte
+    uint8_t frame_len; // Bytes after the command byte
+    uint16_t released_mask;
+    uint16_t zero_mask;
+    uint8_t frame[1 + PERSONA_PAYLOAD_MAX]; // 0x5A and the constant bytes in place
+    bool uses_axes;                         // Has PERSONA_FILL_AXIS slots
+    bool uses_motion;                       // Has PERSONA_FILL_MOTION slots
+    uint8_t slot_count;
+    persona_slot_t slots[PERSONA_PAYLOAD_MAX];
+} persona_template_t;
+
+static persona_template_t templates[PERSONA_COUNT];
+
+// Core 0 writes the selection; Core 1 latches it per transaction
+static const persona_template_t *volatile selected[PSX_PORT_COUNT];
+static const persona_template_t *current[PSX_PORT_COUNT];
+
+// Host analog inputs (Core 0 writes, Core 1 copies all of them under the
+// sequence lock so one frame never mixes two updates)
+static volatile uint8_t axes[PSX_PORT_COUNT][PERSONA_AXES];
+static volatile bool axes_valid[PSX_PORT_COUNT];
+static volatile uint32_t axes_seq[PSX_PORT_COUNT];
+
+// Relative motion: Core 0 only adds to the totals, Core 1 only to what it
+// has reported, so the pending amount is their difference without locking
+static volatile int32_t motion_total[PSX_PORT_COUNT][2];
+static int32_t motion_sent[PSX_PORT_COUNT][2];
+
+static void persona_compile(const persona_desc_t *desc, persona_template_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    out->id = (uint8_t)((desc->type << 4) | (desc->payload_len / 2));
+    out->frame_len = (uint8_t)(1 + desc->payload_len);
+    out->released_mask = desc->released_mask;
+    out->zero_mask = desc->zero_mask;
+    out->frame[0] = PSX_ID_DIGITAL_HI; // 0x5A for every device type
+
+    for (uint8_t i = 0; i < desc->payload_len; i++)
+    {
+        const persona_fill_t *fill = &desc->payload[i];
+        if (fill->op == PERSONA_FILL_CONST)
+        {
+            out->frame[1 + i] = fill->arg;
+        }
+        else
+        {
+            out->uses_axes |= fill->op == PERSONA_FILL_AXIS;
+            out->uses_motion |= fill->op == PERSONA_FILL_MOTION;
+            out->slots[out->slot_count].index = (uint8_t)(1 + i);
+            out->slots[out->slot_count].fill = *fill;
+            out->slot_count++;
+        }
+    }
+}
+
+// ============================================================================
+// Public Functions (Core 0)
+// ============================================================================
+
+void persona_init(void)
+{
+    for (int i = 0; i < PERSONA_COUNT; i++)
+    {
+        persona_compile(&descriptors[i], &templates[i]);
+    }
+
+    for (uint8_t port = 0; port < PSX_PORT_COUNT; port++)
+    {
+        selected[port] = &templates[PERSONA_DEFAULT];
+        current[port] = selected[port];
+        axes_valid[port] = false;
+    }
+}
+
+bool persona_set(uint8_t port, persona_id_t persona)
+{
+    if (port >= PSX_PORT_COUNT || persona >= PERSONA_COUNT)
+    {
+        return false;
+    }
+    selected[port] = &templates[persona];
+    return true;
+}
+
+persona_id_t persona_get(uint8_t port)
+{
+    return (persona_id_t)(selected[port] - templates);
+}
+
+const char *persona_name(persona_id_t persona)
+{
+    if (persona >= PERSONA_COUNT)
+    {
+        return "?";
+    }
+    return descriptors[persona].name;
+}
+
+persona_id_t persona_parse(const char *name)
+{
+    for (int i = 0; i < PERSONA_COUNT; i++)
+    {
+        if (strcmp(name, descriptors[i].name) == 0)
+        {
+            return (persona_id_t)i;
+        }
+    }
+    return PERSONA_COUNT;
+}
+
+void persona_set_axes(uint8_t port, const uint8_t *values)
+{
+    seqlock_write_begin(&axes_seq[port]);
+    if (values != NULL)
+    {
+        for (int i = 0; i < PERSONA_AXES; i++)
+        {
+            axes[port][i] = values[i];
+        }
+    }
+    axes_valid[port] = values != NULL;
+    seqlock_write_end(&axes_seq[port]);
+}
+
+void persona_add_motion(uint8_t port, int16_t dx, int16_t dy)
+{
+    motion_total[port][0] += dx;
+    motion_total[port][1] += dy;
+}
+
+// ============================================================================
+// Frame Building (Core 1)
+// ============================================================================
+
+static inline bool pressed(uint16_t buttons, uint8_t button)
+{
+    return button != PERSONA_NO_BUTTON && !(buttons & (1u << button));
+}
+
+static inline int32_t clamp_s8(int32_t value)
+{
+    return value < -128 ? -128 : (value > 127 ? 127 : value);
+}
+
+uint8_t __time_critical_func(persona_begin)(uint8_t port)
+{
+    const persona_template_t *persona = selected[port];
+    if (persona != current[port])
+    {
+        // Motion sent to another persona is not replayed after a switch
+        motion_sent[port][0] = motion_total[port][0];
+        motion_sent[port][1] = motion_total[port][1];
+        current[port] = persona;
+    }
+    return persona->id;
+}
+
+// Inputs of one poll frame, read once before the slots are filled
+typedef struct
+{
+    bool axes_valid;
+    uint8_t axes[PERSONA_AXES];
+    bool host_motion; // Host motion still to report on either axis
+} poll_inputs_t;
+
+static uint8_t __time_critical_func(fill_value)(uint8_t port, const persona_fill_t *fill, uint16_t buttons, uint16_t word,
+                                                const poll_inputs_t *in)
+{
+    switch (fill->op)
+    {
+    case PERSONA_FILL_BUTTONS_LO:
+        return (uint8_t)(word & 0xFF);
+    case PERSONA_FILL_BUTTONS_HI:
+        return (uint8_t)(word >> 8);
+    case PERSONA_FILL_AXIS:
+        if (pressed(buttons, fill->high))
+        {
+            return 0xFF;
+        }
+        if (pressed(buttons, fill->low))
+        {
+            return 0x00;
+        }
+        return in->axes_valid ? in->axes[fill->arg] : fill->rest;
+    case PERSONA_FILL_MOTION:
+    {
+        // Report what fits in one byte, the rest follows on later polls
+        if (in->host_motion)
+        {
+            int32_t part = clamp_s8(motion_total[port][fill->arg] - motion_sent[port][fill->arg]);
+            motion_sent[port][fill->arg] += part;
+            return (uint8_t)(int8_t)part;
+        }
+
+        // The D-pad moves the mouse only while the host has nothing to report
+        int32_t step = PERSONA_MOUSE_DPAD_STEP;
+        int32_t dpad = (pressed(buttons, fill->high) ? step : 0) - (pressed(buttons, fill->low) ? step : 0);
+        return (uint8_t)(int8_t)dpad;
+    }
+    default:
+        return fill->arg;
+    }
+}
+
+uint8_t __time_critical_func(persona_poll_frame)(uint8_t port, uint16_t buttons, uint8_t *frame)
+{
+    const persona_template_t *persona = current[port];
+
+    for (uint8_t i = 0; i < persona->frame_len; i++)
+    {
+        frame[i] = persona->frame[i];
+    }
+
+    poll_inputs_t in;
+    in.axes_valid = false;
+    if (persona->uses_axes)
+    {
+        uint32_t seq;
+        do
+        {
+            seq = seqlock_read_begin(&axes_seq[port]);
+            in.axes_valid = axes_valid[port];
+            for (int i = 0; i < PERSONA_AXES; i++)
+            {
+                in.axes[i] = axes[port][i];
+            }
+        } while (seqlock_read_retry(&axes_seq[port], seq));
+    }
+    in.host_motion = persona->uses_motion && (motion_total[port][0] != motion_sent[port][0] ||
+                                              motion_total[port][1] != motion_sent[port][1]);
+
+    uint16_t word = (buttons | persona->released_mask) & (uint16_t)~persona->zero_mask;
+    for (uint8_t i = 0; i < persona->slot_count; i++)
+    {
+        const persona_slot_t *slot = &persona->slots[i];
+        frame[slot->index] = fill_value(port, &slot->fill, buttons, word, &in);
+    }
+
+    return persona->frame_len;
+}
@@ -0,0 +1,119 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PERSONA_H
+#define PERSONA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+#include "button_input.h"
+
+// ============================================================================
+// Device Personas
+// ============================================================================
+
+// The controller device (address 0x01) answers the poll as one of several
+// device types. Each persona is a descriptor: device type, payload length and
+// where each payload byte comes from. At init every descriptor is compiled
+// into a response template (ID byte, constant bytes already in place, list of
+// the bytes to fill per poll), so switching persona is one pointer store.
+// Core 1 latches the pointer at the start of a transaction, so a switch only
+// takes effect at a transaction boundary.
+//
+//   digital  ID 0x41: buttons
+//   mouse    ID 0x12: buttons (R1 = left, L1 = right click), X, Y motion
+//   negcon   ID 0x23: buttons (Start, D-pad, R1 = R, Triangle = B, Circle = A),
+//                     twist, I, II, L
+//
+// Analog and motion values come from host link frames (see host_link.h) and
+// fall back to the pad: the mouse moves with the D-pad while no host motion
+// is pending, NeGcon twist follows L2/R2 and I, II, L go to full scale with
+// Cross, Square and L1.
+
+typedef enum
+{
+    PERSONA_DIGITAL = 0,
+    PERSONA_MOUSE,
+    PERSONA_NEGCON,
+    PERSONA_COUNT
+} persona_id_t;
+
+// Host analog inputs per port (meaning is up to the persona)
+#define PERSONA_AXES 4
+
+// Payload bytes after 0x5A (even: the ID counts halfwords)
+#define PERSONA_PAYLOAD_MAX 6
+
+// Marker for "no button" in a fill descriptor
+#define PERSONA_NO_BUTTON 0xFF
+
+typedef enum
+{
+    PERSONA_FILL_CONST,      // arg
+    PERSONA_FILL_BUTTONS_LO, // Button byte 1 (with the persona's unused bits released)
+    PERSONA_FILL_BUTTONS_HI, // Button byte 2
+    PERSONA_FILL_AXIS,       // Host axis arg, or rest without host input; low/high force 0x00/0xFF
+    PERSONA_FILL_MOTION,     // Relative motion arg (0 = X, 1 = Y) since the last poll; low/high step it
+} persona_fill_op_t;
+
+typedef struct
+{
+    uint8_t op;   // persona_fill_op_t
+    uint8_t arg;  // Constant, axis or motion index
+    uint8_t rest; // PERSONA_FILL_AXIS: value without host input
+    uint8_t low;  // Button (psx_button_t) driving the value down, PERSONA_NO_BUTTON if none
+    uint8_t high; // Button driving the value up
+} persona_fill_t;
+
+typedef struct
+{
+    const char *name;
+    uint8_t type;           // Device type, high nibble of the ID byte
+    uint16_t released_mask; // Button bits the device does not have (always released)
+    uint16_t zero_mask;     // Bits the device always reports as 0 (overrides released_mask)
+    uint8_t payload_len;
+    persona_fill_t payload[PERSONA_PAYLOAD_MAX];
+} persona_desc_t;
+
+// Compile every descriptor and select PERSONA_DEFAULT on all ports
+void persona_init(void);
+
+// Core 0: Switch a port's persona (takes effect with the next transaction)
+bool persona_set(uint8_t port, persona_id_t persona);
+persona_id_t persona_get(uint8_t port);
+
+const char *persona_name(persona_id_t persona);
+
+// Returns PERSONA_COUNT for an unknown name
+persona_id_t persona_parse(const char *name);
+
+// Core 0: Host analog inputs of a port (NULL = none, personas use their rest values)
+void persona_set_axes(uint8_t port, const uint8_t *axes);
+
+// Core 0: Add relative motion (reported over the following polls)
+void persona_add_motion(uint8_t port, int16_t dx, int16_t dy);
+
+// Core 1: Latch the port's persona for this transaction and return its ID byte
+uint8_t persona_begin(uint8_t port);
+
+// Core 1: Build the poll response after the command byte (0x5A + payload)
+// from the button word. Returns the number of bytes.
+uint8_t persona_poll_frame(uint8_t port, uint16_t buttons, uint8_t *frame);
+
+#endif // PERSONA_H
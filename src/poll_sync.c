@@ -0,0 +1,294 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "poll_sync.h"
+#include "config.h"
+
+// ============================================================================
+// Estimator State (Core 0 only)
+// ============================================================================
+
+#define SAMPLE_HISTORY 4 // Recent sample times kept for age measurement
+
+static uint32_t margin = POLL_SYNC_MARGIN_US;
+
+static bool have_anchor = false;
+static bool locked = false;
+static uint8_t consistent_polls = 0;
+static uint32_t last_poll = 0;      // Poll number of the anchor
+static uint32_t last_poll_time = 0; // Timestamp of the anchor poll
+static uint32_t period_q8 = 0;      // Poll period estimate (µs << 8)
+static uint32_t sampled_poll = 0;   // Poll number the last extra sample was taken for
+static uint32_t relocks = 0;
+
+static uint32_t sample_times[SAMPLE_HISTORY];
+static uint8_t sample_pos = 0;
+
+// Statistics since last reset
+static uint32_t phase_err_count = 0;
+static uint64_t phase_err_sum = 0;
+static uint32_t phase_err_max = 0;
+static uint32_t age_count = 0;
+static uint32_t age_min = 0;
+static uint32_t age_max = 0;
+static uint64_t age_sum = 0;
+static uint64_t age_sum_sq = 0;
+
+// ============================================================================
+// Internal Functions
+// ============================================================================
+
+// Age of the newest sample taken at or before poll_time
+static void record_sample_age(uint32_t poll_time)
+{
+    bool found = false;
+    uint32_t best = 0;
+
+    for (int i = 0; i < SAMPLE_HISTORY; i++)
+    {
+        int32_t age = (int32_t)(poll_time - sample_times[i]);
+        if (sample_times[i] != 0 && age >= 0 && (!found || (uint32_t)age < best))
+        {
+            best = (uint32_t)age;
+            found = true;
+        }
+    }
+    if (!found)
+    {
+        return;
+    }
+
+    if (age_count == 0 || best < age_min)
+    {
+        age_min = best;
+    }
+    if (best > age_max)
+    {
+        age_max = best;
+    }
+    age_sum += best;
+    age_sum_sq += (uint64_t)best * best;
+    age_count++;
+}
+
+static uint32_t isqrt64(uint64_t value)
+{
+    uint64_t root = 0;
+    uint64_t bit = 1ull << 62;
+
+    while (bit > value)
+    {
+        bit >>= 2;
+    }
+    while (bit != 0)
+    {
+        if (value >= root + bit)
+        {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)root;
+}
+
+// ============================================================================
+// Public Functions
+// ============================================================================
+
+void poll_sync_init(void)
+{
+    margin = POLL_SYNC_MARGIN_US;
+    have_anchor = false;
+    locked = false;
+    consistent_polls = 0;
+    period_q8 = 0;
+    relocks = 0;
+    for (int i = 0; i < SAMPLE_HISTORY; i++)
+    {
+        sample_times[i] = 0;
+    }
+    poll_sync_reset_stats();
+}
+
+bool poll_sync_set_margin(uint32_t margin_us)
+{
+    if (margin_us > POLL_SYNC_MARGIN_MAX)
+    {
+        return false;
+    }
+    margin = margin_us;
+    return true;
+}
+
+uint32_t poll_sync_get_margin(void)
+{
+    return margin;
+}
+
+void poll_sync_update(uint32_t poll, uint32_t poll_time)
+{
+    if (have_anchor && poll == last_poll)
+    {
+        return; // No new poll
+    }
+
+    record_sample_age(poll_time);
+
+    if (!have_anchor)
+    {
+        have_anchor = true;
+        last_poll = poll;
+        last_poll_time = poll_time;
+        return;
+    }
+
+    uint32_t polls = poll - last_poll;
+    uint32_t measured_q8 = (uint32_t)(((uint64_t)(poll_time - last_poll_time) << 8) / polls);
+
+    if (!locked)
+    {
+        // Lock once several consecutive periods agree within 1/16
+        uint32_t diff = measured_q8 > period_q8 ? measured_q8 - period_q8 : period_q8 - measured_q8;
+        if (period_q8 != 0 && diff < period_q8 / 16)
+        {
+            period_q8 = (period_q8 + measured_q8) / 2;
+            if (++consistent_polls >= POLL_SYNC_LOCK_POLLS)
+            {
+                locked = true;
+                relocks++;
+            }
+        }
+        else
+        {
+            period_q8 = measured_q8;
+            consistent_polls = 0;
+        }
+    }
+    else
+    {
+        // Compare against prediction and nudge the period (drift tracking)
+        uint32_t predicted = last_poll_time + (uint32_t)(((uint64_t)period_q8 * polls) >> 8);
+        int32_t error = (int32_t)(poll_time - predicted);
+        uint32_t abs_error = error < 0 ? (uint32_t)-error : (uint32_t)error;
+
+        if (abs_error > (period_q8 >> 8) / 8)
+        {
+            // Console changed rate or skipped polls irregularly - relearn
+            locked = false;
+            consistent_polls = 0;
+            period_q8 = measured_q8;
+        }
+        else
+        {
+            period_q8 += (int32_t)((error * 256) / (int32_t)(polls * 16));
+            phase_err_sum += abs_error;
+            phase_err_count++;
+            if (abs_error > phase_err_max)
+            {
+                phase_err_max = abs_error;
+            }
+        }
+    }
+
+    // Re-anchor the phase on every observed poll
+    last_poll = poll;
+    last_poll_time = poll_time;
+}
+
+void poll_sync_on_sample(uint32_t now)
+{
+    sample_times[sample_pos] = now;
+    sample_pos = (sample_pos + 1) % SAMPLE_HISTORY;
+}
+
+bool poll_sync_sample_due(uint32_t now)
+{
+    if (!locked || margin == 0)
+    {
+        return false;
+    }
+
+    uint32_t period = period_q8 >> 8;
+
+    // Console stopped polling - wait for it to come back and relearn
+    if ((now - last_poll_time) > period * 4)
+    {
+        locked = false;
+        consistent_polls = 0;
+        return false;
+    }
+
+    // Next expected poll after the anchor that is still ahead of the margin
+    uint32_t target_poll = last_poll + 1;
+    uint32_t expected = last_poll_time + period;
+
+    while ((int32_t)(now - expected) > 0)
+    {
+        // Poll not observed yet (Core 0 busy) - look at the following one
+        target_poll++;
+        expected += period;
+    }
+
+    if (target_poll == sampled_poll || (int32_t)(now - (expected - margin)) < 0)
+    {
+        return false;
+    }
+
+    sampled_poll = target_poll;
+    return true;
+}
+
+void poll_sync_get_stats(poll_sync_stats_t *stats)
+{
+    stats->locked = locked;
+    stats->period_q8 = period_q8;
+    stats->relocks = relocks;
+    stats->phase_err_avg = phase_err_count ? (uint32_t)(phase_err_sum / phase_err_count) : 0;
+    stats->phase_err_max = phase_err_max;
+    stats->age_count = age_count;
+    stats->age_min = age_min;
+    stats->age_max = age_max;
+    stats->age_avg = age_count ? (uint32_t)(age_sum / age_count) : 0;
+
+    uint64_t variance = 0;
+    if (age_count)
+    {
+        uint64_t mean = age_sum / age_count;
+        uint64_t mean_sq = age_sum_sq / age_count;
+        variance = mean_sq > mean * mean ? mean_sq - mean * mean : 0;
+    }
+    stats->age_stddev = isqrt64(variance);
+}
+
+void poll_sync_reset_stats(void)
+{
+    phase_err_count = 0;
+    phase_err_sum = 0;
+    phase_err_max = 0;
+    age_count = 0;
+    age_min = 0;
+    age_max = 0;
+    age_sum = 0;
+    age_sum_sq = 0;
+}
@@ -0,0 +1,74 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef POLL_SYNC_H
+#define POLL_SYNC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ============================================================================
+// Phase-Locked Button Sampling
+// ============================================================================
+
+// Learns the console's 0x42 poll period and phase from Core 1's poll
+// timestamps and requests one extra button sample `margin` µs before each
+// expected poll, so the state sent to the console is always fresh.
+// The period estimate tracks slow drift of the console's frame clock.
+
+#define POLL_SYNC_LOCK_POLLS 8     // Consistent polls needed before locking
+#define POLL_SYNC_MARGIN_MAX 5000  // Largest accepted margin (µs)
+
+typedef struct
+{
+    bool locked;             // Period/phase estimate is usable
+    uint32_t period_q8;      // Estimated poll period (µs, 24.8 fixed point)
+    uint32_t relocks;        // Times lock was lost and re-acquired
+    uint32_t phase_err_avg;  // Mean |predicted - actual| poll time (µs)
+    uint32_t phase_err_max;  // Max |predicted - actual| poll time (µs)
+    uint32_t age_count;      // Polls with a measured sample age
+    uint32_t age_min;        // Min sample age at poll time (µs)
+    uint32_t age_max;        // Max sample age at poll time (µs)
+    uint32_t age_avg;        // Mean sample age at poll time (µs)
+    uint32_t age_stddev;     // Standard deviation of sample age (µs)
+} poll_sync_stats_t;
+
+// Initialize estimator (margin = POLL_SYNC_MARGIN_US)
+void poll_sync_init(void);
+
+// Set margin before the expected poll (0 = phase-locked sampling off)
+bool poll_sync_set_margin(uint32_t margin_us);
+uint32_t poll_sync_get_margin(void);
+
+// Core 0: Feed the latest poll number and timestamp from Core 1
+void poll_sync_update(uint32_t poll, uint32_t poll_time);
+
+// Core 0: Record that a button sample was published at `now`
+void poll_sync_on_sample(uint32_t now);
+
+// Core 0: Returns true once per expected poll when the phase-locked sample is due
+bool poll_sync_sample_due(uint32_t now);
+
+// Get estimator and sample-age statistics
+void poll_sync_get_stats(poll_sync_stats_t *stats);
+
+// Reset sample-age and phase error statistics (estimate is kept)
+void poll_sync_reset_stats(void);
+
+#endif // POLL_SYNC_H
@@ -18,65 +18,291 @@
 
 #include "psx_bitbang.h"
 #include "config.h"
+#include "log_queue.h"
 #include "hardware/gpio.h"
 #include "hardware/structs/sio.h"
 #include "hardware/sync.h"
 #include "pico/time.h"
-#include <stdio.h>
 #include <stdlib.h>
 
+// Port currently on the bus
+static uint8_t active_port = 0;
+
+// ============================================================================
+// Bus Speed Detection
+// ============================================================================
+
+// Profiles ordered by clock; the last one whose min_khz fits the measurement wins
+static const psx_timing_profile_t timing_profiles[] = {
+    {"PS1 250k", 0, PSX_CLK_TIMEOUT_US, ACK_PRE_DELAY_US, ACK_PULSE_WIDTH_US, ACK_POST_WAIT_US},
+    {"PS2 500k", 375, 100, 3, 2, 1},
+    {"Fast 750k+", 750, 50, 2, 1, 0},
+};
+
+#define TIMING_PROFILE_COUNT (sizeof(timing_profiles) / sizeof(timing_profiles[0]))
+
+// Detection state, one per console port
+typedef struct
+{
+    const psx_timing_profile_t *profile;
+    volatile uint32_t clock_khz; // Clock measured on the last address byte
+    volatile uint32_t gap_us;    // Last gap between two bytes
+    volatile uint32_t switches;  // Profile changes since boot
+    uint8_t candidate;           // Profile the recent measurements point at
+    uint8_t candidate_count;     // Consecutive measurements for the candidate
+    uint32_t span_us;            // Bits 0..7 rising edges of the last address byte (7 periods)
+    uint32_t gap_avg_us;         // Running gap estimate (0 = not measured yet)
+    uint32_t intra_timeout_us;   // Edge timeout inside a byte
+    uint32_t inter_timeout_us;   // Timeout for the first edge of a byte
+    volatile uint32_t timeouts[PSX_TIMEOUT_STAGE_COUNT];
+} timing_state_t;
+
+#define TIMING_INITIAL_STATE                       \
+    {                                              \
+        .profile = &timing_profiles[0],            \
+        .intra_timeout_us = PSX_CLK_TIMEOUT_US,    \
+        .inter_timeout_us = PSX_CLK_TIMEOUT_US,    \
+    }
+
+static timing_state_t timing[PSX_PORT_COUNT] = {
+    TIMING_INITIAL_STATE,
+#if PSX_PORT_COUNT > 1
+    TIMING_INITIAL_STATE,
+#endif
+};
+
+// Detection state of the port currently on the bus
+static timing_state_t *speed = &timing[0];
+
+// Span of bits 0..7 rising edges of the last address byte (0 = not measured)
+static uint32_t addr_span_us = 0;
+
+// Time of the last rising edge of the previous byte
+static uint32_t byte_end_us = 0;
+
+// The clock is measured with 1µs resolution over 7 periods (750kHz reads as
+// 700 or 777kHz), so the current and slower profiles keep applying
+// PSX_TIMING_HYSTERESIS_KHZ below their min_khz
+static uint8_t timing_classify(uint32_t khz, uint8_t current)
+{
+    uint8_t index = 0;
+    for (uint8_t i = 1; i < TIMING_PROFILE_COUNT; i++)
+    {
+        uint32_t min_khz = timing_profiles[i].min_khz;
+        if (i <= current)
+        {
+            min_khz -= PSX_TIMING_HYSTERESIS_KHZ;
+        }
+        if (khz >= min_khz)
+        {
+            index = i;
+        }
+    }
+    return index;
+}
+
+static uint32_t timeout_limit(uint32_t timeout_us)
+{
+    uint32_t cap = speed->profile->clk_timeout_us;
+    return timeout_us < cap ? timeout_us : cap;
+}
+
+// Derive the edge timeouts from the running period and gap estimates.
+// Until a value has been measured the profile's timeout applies.
+static void timing_update_timeouts(void)
+{
+    uint32_t cap = speed->profile->clk_timeout_us;
+
+    speed->intra_timeout_us = speed->span_us == 0
+                                  ? cap
+                                  : timeout_limit((speed->span_us * PSX_TIMEOUT_INTRA_PERIODS + 6) / 7 + PSX_TIMEOUT_SLACK_US);
+    speed->inter_timeout_us = speed->gap_avg_us == 0
+                                  ? cap
+                                  : timeout_limit(speed->gap_avg_us * PSX_TIMEOUT_INTER_FACTOR + PSX_TIMEOUT_SLACK_US);
+}
+
+bool psx_timing_update(void)
+{
+    uint32_t span = addr_span_us;
+    addr_span_us = 0;
+    if (span == 0)
+    {
+        return false;
+    }
+
+    // 7 clock periods between the first and the last rising edge
+    speed->span_us = span;
+    speed->clock_khz = 7000 / span;
+
+    bool changed = false;
+    uint8_t current = (uint8_t)(speed->profile - timing_profiles);
+    uint8_t index = timing_classify(speed->clock_khz, current);
+    if (index == current)
+    {
+        speed->candidate_count = 0;
+    }
+    else
+    {
+        // Readings either side of a threshold still agree on the candidate
+        if (speed->candidate != current)
+        {
+            index = timing_classify(speed->clock_khz, speed->candidate);
+        }
+
+        // Require a few consecutive bytes before switching so one glitch can't flip the profile
+        if (index != speed->candidate)
+        {
+            speed->candidate = index;
+            speed->candidate_count = 0;
+        }
+        if (++speed->candidate_count >= PSX_TIMING_CONFIRM)
+        {
+            speed->profile = &timing_profiles[index];
+            speed->candidate_count = 0;
+            speed->switches++;
+            speed->gap_avg_us = 0; // Gaps of the old speed no longer apply
+            changed = true;
+            LOG_PUSH(LOG_TIMING_PROFILE, active_port, (uint32_t)(uintptr_t)speed->profile->name, speed->clock_khz);
+
+#if ACK_AUTO_TUNE_ENABLED
+            // Old tuning results belong to the previous speed; restart from the new profile
+            psx_ack_tune_reset();
+#endif
+        }
+    }
+
+    timing_update_timeouts();
+    return changed;
+}
+
+const psx_timing_profile_t *psx_timing_get_profile(uint8_t port)
+{
+    return timing[port].profile;
+}
+
+uint32_t psx_timing_get_clock_khz(uint8_t port)
+{
+    return timing[port].clock_khz;
+}
+
+uint32_t psx_timing_get_gap_us(uint8_t port)
+{
+    return timing[port].gap_us;
+}
+
+uint32_t psx_timing_get_switches(uint8_t port)
+{
+    return timing[port].switches;
+}
+
+uint32_t psx_timing_get_timeouts(uint8_t port, psx_timeout_stage_t stage)
+{
+    return timing[port].timeouts[stage];
+}
+
+uint32_t psx_timing_get_timeout_us(uint8_t port, psx_timeout_stage_t stage)
+{
+    switch (stage)
+    {
+    case PSX_TIMEOUT_INTER_BYTE:
+        return timing[port].inter_timeout_us;
+    case PSX_TIMEOUT_INTRA_BYTE:
+        return timing[port].intra_timeout_us;
+    default:
+        return timing[port].profile->clk_timeout_us;
+    }
+}
+
+const char *psx_timeout_stage_name(psx_timeout_stage_t stage)
+{
+    switch (stage)
+    {
+    case PSX_TIMEOUT_ADDRESS:
+        return "address";
+    case PSX_TIMEOUT_INTER_BYTE:
+        return "inter-byte";
+    case PSX_TIMEOUT_INTRA_BYTE:
+        return "intra-byte";
+    default:
+        return "?";
+    }
+}
+
 // ============================================================================
 // ACK Auto-Tuning State
 // ============================================================================
 
 #if ACK_AUTO_TUNE_ENABLED
-static volatile uint32_t current_ack_pulse_width = ACK_PULSE_WIDTH_MAX;
-static volatile uint32_t current_ack_post_wait = ACK_POST_WAIT_MIN; // Start from MIN (short WAIT first)
-static volatile uint32_t test_start_time = 0;
-static volatile uint32_t test_addr_count = 0;  // Address bytes received
-static volatile uint32_t test_cmd_success = 0; // Command bytes successfully received (not 0xFF)
-static volatile uint32_t best_pulse_width = ACK_PULSE_WIDTH_MAX;
-static volatile uint32_t best_post_wait = ACK_POST_WAIT_MIN;
-static volatile float best_cmd_success_rate = -1.0f; // Initialize to -1 so first valid result is always "NEW BEST"
-static volatile bool tuning_complete = false;
-static volatile bool tuning_started = false;        // Track if tuning has started
-static volatile uint32_t last_transaction_time = 0; // Time of last transaction
+// Tuning state, one per console port (each port may sit on a different console)
+typedef struct
+{
+    volatile uint32_t current_ack_pulse_width;
+    volatile uint32_t current_ack_post_wait; // Start from MIN (short WAIT first)
+    volatile uint32_t test_start_time;
+    volatile uint32_t test_addr_count;  // Address bytes received
+    volatile uint32_t test_cmd_success; // Command bytes successfully received (not 0xFF)
+    volatile uint32_t best_pulse_width;
+    volatile uint32_t best_post_wait;
+    volatile float best_cmd_success_rate; // Initialize to -1 so first valid result is always "NEW BEST"
+    volatile bool tuning_complete;
+    volatile bool tuning_started;            // Track if tuning has started
+    volatile uint32_t last_transaction_time; // Time of last transaction
+} ack_tune_state_t;
+
+#define ACK_TUNE_INITIAL_STATE                          \
+    {                                                   \
+        .current_ack_pulse_width = ACK_PULSE_WIDTH_MAX, \
+        .current_ack_post_wait = ACK_POST_WAIT_MIN,     \
+        .best_pulse_width = ACK_PULSE_WIDTH_MAX,        \
+        .best_post_wait = ACK_POST_WAIT_MIN,            \
+        .best_cmd_success_rate = -1.0f,                 \
+    }
+
+static ack_tune_state_t ack_tune[PSX_PORT_COUNT] = {
+    ACK_TUNE_INITIAL_STATE,
+#if PSX_PORT_COUNT > 1
+    ACK_TUNE_INITIAL_STATE,
+#endif
+};
+
+// Tuning state of the port currently on the bus
+static ack_tune_state_t *tune = &ack_tune[0];
 
 void psx_ack_tune_on_address(void)
 {
     uint32_t now = time_us_32();
 
     // Check for idle timeout - reset if no transaction for a while
-    if (last_transaction_time != 0 && (now - last_transaction_time) > ACK_TUNE_IDLE_TIMEOUT_US)
+    if (tune->last_transaction_time != 0 && (now - tune->last_transaction_time) > ACK_TUNE_IDLE_TIMEOUT_US)
     {
-        if (tuning_complete || tuning_started)
+        if (tune->tuning_complete || tune->tuning_started)
         {
-            printf("[ACK-TUNE] Idle timeout, resetting...\n");
+            LOG_PUSH(LOG_ACK_TUNE_IDLE, 0);
         }
         psx_ack_tune_reset();
         // Fall through to process this transaction as the first one after reset
     }
 
     // Update last transaction time
-    last_transaction_time = now;
+    tune->last_transaction_time = now;
 
-    if (tuning_complete)
+    if (tune->tuning_complete)
     {
         return;
     }
 
     // Start tuning on first transaction
-    if (!tuning_started)
+    if (!tune->tuning_started)
     {
-        tuning_started = true;
-        printf("[ACK-TUNE] Starting auto-tune...\n");
+        tune->tuning_started = true;
+        LOG_PUSH(LOG_ACK_TUNE_START, 0);
     }
 
-    test_addr_count++;
+    tune->test_addr_count++;
 
-    if (test_start_time == 0)
+    if (tune->test_start_time == 0)
     {
-        test_start_time = now;
+        tune->test_start_time = now;
         // Silent - don't print for every test to avoid timing issues
         return;
     }
@@ -84,56 +310,56 @@ void psx_ack_tune_on_address(void)
 
 void psx_ack_tune_on_command(bool cmd_success)
 {
-    if (tuning_complete)
+    if (tune->tuning_complete)
     {
         return;
     }
 
     // Don't process until tuning has started
-    if (!tuning_started)
+    if (!tune->tuning_started)
     {
         return;
     }
 
     if (cmd_success)
     {
-        test_cmd_success++;
+        tune->test_cmd_success++;
     }
 
     uint32_t now = time_us_32();
-    uint32_t elapsed = now - test_start_time;
+    uint32_t elapsed = now - tune->test_start_time;
 
     // Test each setting for ACK_TUNE_TEST_TRANSACTIONS transactions
     // OR timeout after ACK_TUNE_TIMEOUT_US
-    if (test_addr_count >= ACK_TUNE_TEST_TRANSACTIONS || elapsed >= ACK_TUNE_TIMEOUT_US)
+    if (tune->test_addr_count >= ACK_TUNE_TEST_TRANSACTIONS || elapsed >= ACK_TUNE_TIMEOUT_US)
     {
-        float cmd_success_rate = (float)test_cmd_success / (float)test_addr_count;
+        float cmd_success_rate = (float)tune->test_cmd_success / (float)tune->test_addr_count;
 
-        // Only print when finding a new best to minimize timing impact
+        // Only log when finding a new best to keep the queue short
         if (cmd_success_rate >= ACK_TUNE_CMD_SUCCESS_THRESHOLD)
         {
             bool is_better = false;
 
             // Better if higher success rate
-            if (cmd_success_rate > best_cmd_success_rate)
+            if (cmd_success_rate > tune->best_cmd_success_rate)
             {
                 is_better = true;
             }
             // If same success rate, prefer: 1) shorter WAIT, 2) middle PULSE
-            else if (cmd_success_rate == best_cmd_success_rate && best_cmd_success_rate >= 0.0f)
+            else if (cmd_success_rate == tune->best_cmd_success_rate && tune->best_cmd_success_rate >= 0.0f)
             {
                 // Calculate distance from middle PULSE value
                 uint32_t pulse_mid = (ACK_PULSE_WIDTH_MIN + ACK_PULSE_WIDTH_MAX) / 2;
-                int32_t current_pulse_dist = abs((int32_t)current_ack_pulse_width - (int32_t)pulse_mid);
-                int32_t best_pulse_dist = abs((int32_t)best_pulse_width - (int32_t)pulse_mid);
+                int32_t current_pulse_dist = abs((int32_t)tune->current_ack_pulse_width - (int32_t)pulse_mid);
+                int32_t best_pulse_dist = abs((int32_t)tune->best_pulse_width - (int32_t)pulse_mid);
 
                 // Prefer shorter WAIT first
-                if (current_ack_post_wait < best_post_wait)
+                if (tune->current_ack_post_wait < tune->best_post_wait)
                 {
                     is_better = true;
                 }
                 // If same WAIT, prefer middle PULSE
-                else if (current_ack_post_wait == best_post_wait && current_pulse_dist < best_pulse_dist)
+                else if (tune->current_ack_post_wait == tune->best_post_wait && current_pulse_dist < best_pulse_dist)
                 {
                     is_better = true;
                 }
@@ -141,12 +367,12 @@ void psx_ack_tune_on_command(bool cmd_success)
 
             if (is_better)
             {
-                best_cmd_success_rate = cmd_success_rate;
-                best_pulse_width = current_ack_pulse_width;
-                best_post_wait = current_ack_post_wait;
-                printf("[ACK-TUNE] New best: PULSE=%lu, WAIT=%lu (%.1f%%, %lu/%lu)\n",
-                       current_ack_pulse_width, current_ack_post_wait,
-                       cmd_success_rate * 100.0f, test_cmd_success, test_addr_count);
+                tune->best_cmd_success_rate = cmd_success_rate;
+                tune->best_pulse_width = tune->current_ack_pulse_width;
+                tune->best_post_wait = tune->current_ack_post_wait;
+                uint32_t permille = (uint32_t)(cmd_success_rate * 1000.0f + 0.5f);
+                LOG_PUSH(LOG_ACK_TUNE_BEST, tune->current_ack_pulse_width, tune->current_ack_post_wait,
+                         permille / 10, permille % 10, tune->test_cmd_success, tune->test_addr_count);
             }
         }
 
@@ -154,18 +380,18 @@ void psx_ack_tune_on_command(bool cmd_success)
         bool moved = false;
 
         // Try next wait time (increasing from MIN to MAX)
-        if (current_ack_post_wait < ACK_POST_WAIT_MAX)
+        if (tune->current_ack_post_wait < ACK_POST_WAIT_MAX)
         {
-            current_ack_post_wait += ACK_POST_WAIT_STEP;
+            tune->current_ack_post_wait += ACK_POST_WAIT_STEP;
             moved = true;
         }
         else
         {
             // Reset wait to min, try next pulse width (decreasing)
-            current_ack_post_wait = ACK_POST_WAIT_MIN;
-            if (current_ack_pulse_width > ACK_PULSE_WIDTH_MIN)
+            tune->current_ack_post_wait = ACK_POST_WAIT_MIN;
+            if (tune->current_ack_pulse_width > ACK_PULSE_WIDTH_MIN)
             {
-                current_ack_pulse_width -= ACK_PULSE_WIDTH_STEP;
+                tune->current_ack_pulse_width -= ACK_PULSE_WIDTH_STEP;
                 moved = true;
             }
         }
@@ -173,74 +399,142 @@ void psx_ack_tune_on_command(bool cmd_success)
         if (moved)
         {
             // Continue testing
-            test_start_time = 0;
-            test_addr_count = 0;
-            test_cmd_success = 0;
+            tune->test_start_time = 0;
+            tune->test_addr_count = 0;
+            tune->test_cmd_success = 0;
         }
         else
         {
             // Finished testing all combinations
-            if (best_cmd_success_rate >= ACK_TUNE_CMD_SUCCESS_THRESHOLD)
+            if (tune->best_cmd_success_rate >= ACK_TUNE_CMD_SUCCESS_THRESHOLD)
             {
-                current_ack_pulse_width = best_pulse_width;
-                current_ack_post_wait = best_post_wait;
-                tuning_complete = true;
-                printf("[ACK-TUNE] LOCKED: PULSE=%lu us, WAIT=%lu us (%.0f%%)\n",
-                       best_pulse_width, best_post_wait, best_cmd_success_rate * 100.0f);
+                tune->current_ack_pulse_width = tune->best_pulse_width;
+                tune->current_ack_post_wait = tune->best_post_wait;
+                tune->tuning_complete = true;
+                LOG_PUSH(LOG_ACK_TUNE_LOCKED, tune->best_pulse_width, tune->best_post_wait,
+                         (uint32_t)(tune->best_cmd_success_rate * 100.0f + 0.5f));
             }
             else
             {
-                printf("[ACK-TUNE] No good settings, restarting...\n");
-                current_ack_pulse_width = ACK_PULSE_WIDTH_MAX;
-                current_ack_post_wait = ACK_POST_WAIT_MIN; // Start from MIN
-                test_start_time = 0;
-                test_addr_count = 0;
-                test_cmd_success = 0;
-                best_cmd_success_rate = -1.0f; // Reset to -1
+                // The profile's start point didn't work out; sweep the full range this time
+                LOG_PUSH(LOG_ACK_TUNE_RESTART, 0);
+                tune->current_ack_pulse_width = ACK_PULSE_WIDTH_MAX;
+                tune->current_ack_post_wait = ACK_POST_WAIT_MIN; // Start from MIN
+                tune->test_start_time = 0;
+                tune->test_addr_count = 0;
+                tune->test_cmd_success = 0;
+                tune->best_cmd_success_rate = -1.0f; // Reset to -1
             }
         }
     }
 }
 
+static uint32_t tune_clamp(uint32_t value, uint32_t min, uint32_t max)
+{
+    return value < min ? min : (value > max ? max : value);
+}
+
 void psx_ack_tune_reset(void)
 {
-    current_ack_pulse_width = ACK_PULSE_WIDTH_MAX;
-    current_ack_post_wait = ACK_POST_WAIT_MIN; // Start from MIN
-    test_start_time = 0;
-    test_addr_count = 0;
-    test_cmd_success = 0;
-    best_pulse_width = ACK_PULSE_WIDTH_MAX;
-    best_post_wait = ACK_POST_WAIT_MAX;
-    best_cmd_success_rate = -1.0f;
-    tuning_complete = false;
-    tuning_started = false;
-    last_transaction_time = 0;
+    // Pulse widths from the active profile's down (PS1's slow bus takes the
+    // whole range), each with every wait from the shortest up
+    uint32_t pulse = speed->profile == &timing_profiles[0] ? ACK_PULSE_WIDTH_MAX : speed->profile->ack_pulse_us;
+    tune->current_ack_pulse_width = tune_clamp(pulse, ACK_PULSE_WIDTH_MIN, ACK_PULSE_WIDTH_MAX);
+    tune->current_ack_post_wait = ACK_POST_WAIT_MIN;
+    tune->test_start_time = 0;
+    tune->test_addr_count = 0;
+    tune->test_cmd_success = 0;
+    tune->best_pulse_width = tune->current_ack_pulse_width;
+    tune->best_post_wait = ACK_POST_WAIT_MAX;
+    tune->best_cmd_success_rate = -1.0f;
+    tune->tuning_complete = false;
+    tune->tuning_started = false;
+    tune->last_transaction_time = 0;
 }
 
-uint32_t psx_ack_get_pulse_width(void)
+uint32_t psx_ack_get_pulse_width(uint8_t port)
 {
-    return current_ack_pulse_width;
+    return ack_tune[port].current_ack_pulse_width;
 }
 
-uint32_t psx_ack_get_post_wait(void)
+uint32_t psx_ack_get_post_wait(uint8_t port)
 {
-    return current_ack_post_wait;
+    return ack_tune[port].current_ack_post_wait;
 }
 
-bool psx_ack_is_tuning_complete(void)
+bool psx_ack_is_tuning_complete(uint8_t port)
 {
-    return tuning_complete;
+    return ack_tune[port].tuning_complete;
 }
 
-bool psx_ack_is_tuning_started(void)
+bool psx_ack_is_tuning_started(uint8_t port)
 {
-    return tuning_started;
+    return ack_tune[port].tuning_started;
 }
 #endif
 
+// ============================================================================
+// Port Pin Sets
+// ============================================================================
+
+const psx_port_pins_t psx_port_pins[PSX_PORT_COUNT] = {
+    {PIN_DAT, PIN_CMD, PIN_SEL, PIN_CLK, PIN_ACK},
+#if PSX_PORT_COUNT > 1
+    {PIN2_DAT, PIN2_CMD, PIN2_SEL, PIN2_CLK, PIN2_ACK},
+#endif
+};
+
+// Pins of the port currently on the bus (copied so the hot path reads plain statics)
+static uint bus_dat = PIN_DAT;
+static uint bus_cmd = PIN_CMD;
+static uint bus_sel = PIN_SEL;
+static uint bus_clk = PIN_CLK;
+static uint bus_ack = PIN_ACK;
+
+void psx_bitbang_select_port(uint8_t port)
+{
+    const psx_port_pins_t *pins = &psx_port_pins[port];
+
+    active_port = port;
+    bus_dat = pins->dat;
+    bus_cmd = pins->cmd;
+    bus_sel = pins->sel;
+    bus_clk = pins->clk;
+    bus_ack = pins->ack;
+    speed = &timing[port];
+#if ACK_AUTO_TUNE_ENABLED
+    tune = &ack_tune[port];
+#endif
+}
+
+uint8_t psx_bitbang_active_port(void)
+{
+    return active_port;
+}
+
+// Edge timeout (SEL still LOW) since the last psx_take_timeout()
+static bool timed_out = false;
+
+bool psx_timed_out(void)
+{
+    return timed_out;
+}
+
+bool psx_take_timeout(void)
+{
+    bool result = timed_out;
+    timed_out = false;
+    return result;
+}
+
+bool psx_bus_driven(void)
+{
+    return (sio_hw->gpio_oe & ((1u << bus_dat) | (1u << bus_ack))) != 0;
+}
+
 // Direct SIO register access for reliable open-drain control
 // Using pico SDK structures for safer access
-inline void gpio_out_low(uint gpio)
+static inline void gpio_out_low(uint gpio)
 {
     // Ensure output register is LOW before enabling output
     gpio_put(gpio, 0);
@@ -250,7 +544,7 @@ inline void gpio_out_low(uint gpio)
     __dmb(); // Memory barrier
 }
 
-inline void gpio_hi_z(uint gpio)
+static inline void gpio_hi_z(uint gpio)
 {
     // Disable output (release to external pull-up)
     gpio_set_dir(gpio, GPIO_IN);
@@ -263,43 +557,60 @@ inline void gpio_hi_z(uint gpio)
 
 void psx_bitbang_init(void)
 {
-    // CRITICAL: Ensure GPIO function is set to SIO (GPIO mode) BEFORE using gpio_init
-    // This prevents conflicts with UART or other peripherals
-    gpio_set_function(PIN_DAT, GPIO_FUNC_SIO);
-    gpio_set_function(PIN_ACK, GPIO_FUNC_SIO);
-    gpio_set_function(PIN_CMD, GPIO_FUNC_SIO);
-    gpio_set_function(PIN_CLK, GPIO_FUNC_SIO);
-    gpio_set_function(PIN_SEL, GPIO_FUNC_SIO);
-
-    // Initialize DAT pin (open-drain, bidirectional)
-    gpio_init(PIN_DAT);
-    gpio_put(PIN_DAT, 0);           // Set output register to LOW FIRST
-    gpio_disable_pulls(PIN_DAT);    // NO internal pull-up - rely on external pull-up
-    gpio_set_dir(PIN_DAT, GPIO_IN); // Start in Hi-Z state
-
-    // Initialize ACK pin (open-drain output)
-    // CRITICAL: ACK must NOT have internal pull-up!
-    // The PSX has external pull-up on the bus.
-    // Internal pull-up may prevent ACK from going LOW.
-    gpio_init(PIN_ACK);
-    gpio_put(PIN_ACK, 0);           // Set output register to LOW FIRST
-    gpio_disable_pulls(PIN_ACK);    // NO internal pull-up - PSX has external pull-up
-    gpio_set_dir(PIN_ACK, GPIO_IN); // Start in Hi-Z state
-
-    // Initialize CMD pin (input from PSX)
-    gpio_init(PIN_CMD);
-    gpio_disable_pulls(PIN_CMD); // No pull - PSX has external pull-up
-    gpio_set_dir(PIN_CMD, GPIO_IN);
-
-    // Initialize CLK pin (input from PSX)
-    gpio_init(PIN_CLK);
-    gpio_disable_pulls(PIN_CLK); // No pull - PSX drives this line
-    gpio_set_dir(PIN_CLK, GPIO_IN);
-
-    // Initialize SEL pin (input from PSX, active LOW)
-    gpio_init(PIN_SEL);
-    gpio_disable_pulls(PIN_SEL); // No pull - PSX drives this line
-    gpio_set_dir(PIN_SEL, GPIO_IN);
+    for (uint8_t port = 0; port < PSX_PORT_COUNT; port++)
+    {
+        const psx_port_pins_t *pins = &psx_port_pins[port];
+
+        // CRITICAL: Ensure GPIO function is set to SIO (GPIO mode) BEFORE using gpio_init
+        // This prevents conflicts with UART or other peripherals
+        gpio_set_function(pins->dat, GPIO_FUNC_SIO);
+        gpio_set_function(pins->ack, GPIO_FUNC_SIO);
+        gpio_set_function(pins->cmd, GPIO_FUNC_SIO);
+        gpio_set_function(pins->clk, GPIO_FUNC_SIO);
+        gpio_set_function(pins->sel, GPIO_FUNC_SIO);
+
+        // Initialize DAT pin (open-drain, bidirectional)
+        gpio_init(pins->dat);
+        gpio_put(pins->dat, 0);           // Set output register to LOW FIRST
+        gpio_disable_pulls(pins->dat);    // NO internal pull-up - rely on external pull-up
+        gpio_set_dir(pins->dat, GPIO_IN); // Start in Hi-Z state
+
+        // Initialize ACK pin (open-drain output)
+        // CRITICAL: ACK must NOT have internal pull-up!
+        // The PSX has external pull-up on the bus.
+        // Internal pull-up may prevent ACK from going LOW.
+        gpio_init(pins->ack);
+        gpio_put(pins->ack, 0);           // Set output register to LOW FIRST
+        gpio_disable_pulls(pins->ack);    // NO internal pull-up - PSX has external pull-up
+        gpio_set_dir(pins->ack, GPIO_IN); // Start in Hi-Z state
+
+        // Initialize CMD pin (input from PSX)
+        gpio_init(pins->cmd);
+        gpio_disable_pulls(pins->cmd); // No pull - PSX has external pull-up
+        gpio_set_dir(pins->cmd, GPIO_IN);
+
+        // Initialize CLK pin (input from PSX)
+        gpio_init(pins->clk);
+        gpio_disable_pulls(pins->clk); // No pull - PSX drives this line
+        gpio_set_dir(pins->clk, GPIO_IN);
+
+        // Initialize SEL pin (input from PSX, active LOW)
+        gpio_init(pins->sel);
+        gpio_disable_pulls(pins->sel); // No pull - PSX drives this line
+        gpio_set_dir(pins->sel, GPIO_IN);
+
+        // Each port starts at the PS1 profile until its bus speed is measured
+        psx_bitbang_select_port(port);
+        speed->profile = &timing_profiles[0];
+        speed->candidate = 0;
+        speed->candidate_count = 0;
+        timing_update_timeouts();
+#if ACK_AUTO_TUNE_ENABLED
+        psx_ack_tune_reset();
+#endif
+    }
+
+    psx_bitbang_select_port(0);
 }
 
 // ============================================================================
@@ -308,22 +619,22 @@ void psx_bitbang_init(void)
 
 inline void psx_dat_hiz(void)
 {
-    gpio_set_dir(PIN_DAT, GPIO_IN); // Hi-Z (pulled HIGH externally)
+    gpio_set_dir(bus_dat, GPIO_IN); // Hi-Z (pulled HIGH externally)
 }
 
 inline void psx_dat_low(void)
 {
-    gpio_set_dir(PIN_DAT, GPIO_OUT); // Drive LOW
+    gpio_set_dir(bus_dat, GPIO_OUT); // Drive LOW
 }
 
 inline void psx_ack_hiz(void)
 {
-    gpio_set_dir(PIN_ACK, GPIO_IN); // Hi-Z (pulled HIGH externally)
+    gpio_set_dir(bus_ack, GPIO_IN); // Hi-Z (pulled HIGH externally)
 }
 
 inline void psx_ack_low(void)
 {
-    gpio_set_dir(PIN_ACK, GPIO_OUT); // Drive LOW
+    gpio_set_dir(bus_ack, GPIO_OUT); // Drive LOW
 }
 
 // ============================================================================
@@ -332,17 +643,17 @@ inline void psx_ack_low(void)
 
 inline bool psx_read_sel(void)
 {
-    return gpio_get(PIN_SEL);
+    return gpio_get(bus_sel);
 }
 
 inline bool psx_read_clk(void)
 {
-    return gpio_get(PIN_CLK);
+    return gpio_get(bus_clk);
 }
 
 inline bool psx_read_cmd(void)
 {
-    return gpio_get(PIN_CMD);
+    return gpio_get(bus_cmd);
 }
 
 // ============================================================================
@@ -354,7 +665,7 @@ bool __time_critical_func(psx_wait_clk_rising)(uint32_t timeout_us)
     uint32_t start = time_us_32();
 
     // Wait for CLK to go HIGH
-    while (!gpio_get(PIN_CLK))
+    while (!gpio_get(bus_clk))
     {
         // Check for timeout
         if ((time_us_32() - start) > timeout_us)
@@ -362,7 +673,7 @@ bool __time_critical_func(psx_wait_clk_rising)(uint32_t timeout_us)
             return false;
         }
         // Check if SELECT went HIGH (transaction aborted)
-        if (gpio_get(PIN_SEL))
+        if (gpio_get(bus_sel))
         {
             return false;
         }
@@ -376,7 +687,7 @@ bool __time_critical_func(psx_wait_clk_falling)(uint32_t timeout_us)
     uint32_t start = time_us_32();
 
     // Wait for CLK to go LOW
-    while (gpio_get(PIN_CLK))
+    while (gpio_get(bus_clk))
     {
         // Check for timeout
         if ((time_us_32() - start) > timeout_us)
@@ -384,7 +695,7 @@ bool __time_critical_func(psx_wait_clk_falling)(uint32_t timeout_us)
             return false;
         }
         // Check if SELECT went HIGH (transaction aborted)
-        if (gpio_get(PIN_SEL))
+        if (gpio_get(bus_sel))
         {
             return false;
         }
@@ -397,30 +708,75 @@ bool __time_critical_func(psx_wait_clk_falling)(uint32_t timeout_us)
 // Byte-Level Communication
 // ============================================================================
 
+// A failed edge wait with SEL still asserted is a timeout (not an abort)
+static void timing_count_timeout(psx_timeout_stage_t stage)
+{
+    if (gpio_get(bus_sel))
+    {
+        return;
+    }
+
+    speed->timeouts[stage]++;
+    timed_out = true;
+
+    // The console may simply pause longer than learned: back off to the profile
+    // limit and let the next gaps rebuild the estimate
+    if (stage == PSX_TIMEOUT_INTER_BYTE && speed->gap_avg_us != 0)
+    {
+        speed->gap_avg_us = speed->inter_timeout_us;
+        speed->inter_timeout_us = speed->profile->clk_timeout_us;
+    }
+}
+
 uint8_t __time_critical_func(psx_receive_byte)(void)
 {
     uint8_t data = 0;
+    uint32_t first_rise = 0;
+    uint32_t timeout_us = speed->profile->clk_timeout_us; // First edge after SEL
+    psx_timeout_stage_t stage = PSX_TIMEOUT_ADDRESS;
+
+    addr_span_us = 0;
 
     // Receive 8 bits, LSB first
     for (int bit = 0; bit < 8; bit++)
     {
         // Wait for CLK falling edge (PSX outputs data on falling edge)
-        if (!psx_wait_clk_falling(PSX_CLK_TIMEOUT_US))
+        if (!psx_wait_clk_falling(timeout_us))
         {
+            timing_count_timeout(stage);
             return 0xFF; // Timeout or abort
         }
 
+        // The rest of the byte follows at the learned clock period
+        timeout_us = speed->intra_timeout_us;
+        stage = PSX_TIMEOUT_INTRA_BYTE;
+
         // Wait for CLK rising edge (sample point)
-        if (!psx_wait_clk_rising(PSX_CLK_TIMEOUT_US))
+        if (!psx_wait_clk_rising(timeout_us))
         {
+            timing_count_timeout(stage);
             return 0xFF; // Timeout or abort
         }
 
         // Sample CMD line on rising edge
-        if (gpio_get(PIN_CMD))
+        if (gpio_get(bus_cmd))
         {
             data |= (1 << bit);
         }
+
+        // Timestamp after sampling so the measurement doesn't delay the sample point
+        if (bit == 0)
+        {
+            first_rise = time_us_32();
+        }
+    }
+
+    // Only a complete byte gives a valid clock measurement (picked up by psx_timing_update)
+    byte_end_us = time_us_32();
+    addr_span_us = byte_end_us - first_rise;
+    if (addr_span_us == 0)
+    {
+        addr_span_us = 1; // Faster than the timer resolution
     }
 
     return data;
@@ -428,38 +784,45 @@ uint8_t __time_critical_func(psx_receive_byte)(void)
 
 bool __time_critical_func(psx_send_byte)(uint8_t data)
 {
+    uint32_t timeout_us = speed->inter_timeout_us;
+    psx_timeout_stage_t stage = PSX_TIMEOUT_INTER_BYTE;
+
     // Send 8 bits, LSB first
     for (int bit = 0; bit < 8; bit++)
     {
         // Wait for CLK falling edge (output data)
-        if (!psx_wait_clk_falling(PSX_CLK_TIMEOUT_US))
+        if (!psx_wait_clk_falling(timeout_us))
         {
+            timing_count_timeout(stage);
             // Ensure DAT is Hi-Z before returning
-            gpio_set_dir(PIN_DAT, GPIO_IN);
+            gpio_set_dir(bus_dat, GPIO_IN);
             return false; // Timeout or abort
         }
+        timeout_us = speed->intra_timeout_us;
+        stage = PSX_TIMEOUT_INTRA_BYTE;
 
         // Set DAT line according to current bit immediately after falling edge
         if (data & (1 << bit))
         {
-            gpio_set_dir(PIN_DAT, GPIO_IN); // Hi-Z = 1
+            gpio_set_dir(bus_dat, GPIO_IN); // Hi-Z = 1
         }
         else
         {
-            gpio_set_dir(PIN_DAT, GPIO_OUT); // LOW = 0
+            gpio_set_dir(bus_dat, GPIO_OUT); // LOW = 0
         }
 
         // Wait for CLK rising edge (PSX samples data)
-        if (!psx_wait_clk_rising(PSX_CLK_TIMEOUT_US))
+        if (!psx_wait_clk_rising(timeout_us))
         {
+            timing_count_timeout(stage);
             // Ensure DAT is Hi-Z before returning
-            gpio_set_dir(PIN_DAT, GPIO_IN);
+            gpio_set_dir(bus_dat, GPIO_IN);
             return false; // Timeout or abort
         }
     }
 
     // After byte is sent, ensure DAT returns to Hi-Z (idle state)
-    gpio_set_dir(PIN_DAT, GPIO_IN);
+    gpio_set_dir(bus_dat, GPIO_IN);
 
     return true;
 }
@@ -468,34 +831,49 @@ bool __time_critical_func(psx_send_byte)(uint8_t data)
 uint8_t __time_critical_func(psx_transfer_byte)(uint8_t data_out)
 {
     uint8_t data_in = 0;
+    uint32_t timeout_us = speed->inter_timeout_us; // Gap before the first edge
+    psx_timeout_stage_t stage = PSX_TIMEOUT_INTER_BYTE;
 
     // Transfer 8 bits, LSB first
     for (int bit = 0; bit < 8; bit++)
     {
         // Wait for CLK falling edge
-        if (!psx_wait_clk_falling(PSX_CLK_TIMEOUT_US))
+        if (!psx_wait_clk_falling(timeout_us))
         {
+            timing_count_timeout(stage);
             return 0xFF; // Timeout or abort
         }
 
         // Sample input data on CMD line immediately after falling edge
-        bool cmd_bit = gpio_get(PIN_CMD);
+        bool cmd_bit = gpio_get(bus_cmd);
 
         // Output data on DAT line
         if (data_out & (1 << bit))
         {
-            gpio_set_dir(PIN_DAT, GPIO_IN); // Hi-Z = 1
+            gpio_set_dir(bus_dat, GPIO_IN); // Hi-Z = 1
         }
         else
         {
-            gpio_set_dir(PIN_DAT, GPIO_OUT); // LOW = 0
+            gpio_set_dir(bus_dat, GPIO_OUT); // LOW = 0
+        }
+
+        // Gap since the previous byte (measured once DAT is already set up)
+        if (bit == 0)
+        {
+            uint32_t gap = time_us_32() - byte_end_us;
+            speed->gap_us = gap;
+            speed->gap_avg_us = speed->gap_avg_us == 0 ? gap : (speed->gap_avg_us * 3 + gap) / 4;
+
+            timeout_us = speed->intra_timeout_us;
+            stage = PSX_TIMEOUT_INTRA_BYTE;
         }
 
         // Wait for CLK rising edge
-        if (!psx_wait_clk_rising(PSX_CLK_TIMEOUT_US))
+        if (!psx_wait_clk_rising(timeout_us))
         {
+            timing_count_timeout(stage);
             // Ensure DAT is Hi-Z before returning
-            gpio_set_dir(PIN_DAT, GPIO_IN);
+            gpio_set_dir(bus_dat, GPIO_IN);
             return 0xFF; // Timeout or abort
         }
 
@@ -506,32 +884,38 @@ uint8_t __time_critical_func(psx_transfer_byte)(uint8_t data_out)
         }
     }
 
+    byte_end_us = time_us_32();
+
     // After byte is transferred, ensure DAT returns to Hi-Z (idle state)
-    gpio_set_dir(PIN_DAT, GPIO_IN);
+    gpio_set_dir(bus_dat, GPIO_IN);
 
     return data_in;
 }
 
 void __time_critical_func(psx_send_ack)(void)
 {
-#if ACK_AUTO_TUNE_ENABLED
-    // busy_wait_us_32(current_ack_post_wait);
-    busy_wait_us_32(5);
-#else
-    busy_wait_us_32(ACK_PULSE_WIDTH_US);
-#endif
+    // Pre-ACK delay from the bus speed profile
+    busy_wait_us_32(speed->profile->ack_delay_us);
+
+    // The console may have raised SEL during the delay: the bus is released
+    // by then and ACK must stay off it
+    if (psx_read_sel())
+    {
+        return;
+    }
+
     // Assert ACK (drive LOW) immediately after byte transfer
-    gpio_out_low(PIN_ACK);
+    gpio_out_low(bus_ack);
 
-    // Hold ACK for specified duration (auto-tuned or fixed)
+    // Hold ACK for specified duration (auto-tuned or from the profile)
 #if ACK_AUTO_TUNE_ENABLED
-    busy_wait_us_32(current_ack_pulse_width);
+    busy_wait_us_32(tune->current_ack_pulse_width);
 #else
-    busy_wait_us_32(ACK_PULSE_WIDTH_US);
+    busy_wait_us_32(speed->profile->ack_pulse_us);
 #endif
 
     // Release ACK (Hi-Z)
-    gpio_hi_z(PIN_ACK);
+    gpio_hi_z(bus_ack);
 }
 
 // ============================================================================
@@ -541,6 +925,6 @@ void __time_critical_func(psx_send_ack)(void)
 inline void psx_release_bus(void)
 {
     // Release both DAT and ACK to Hi-Z
-    gpio_set_dir(PIN_DAT, GPIO_IN);
-    gpio_set_dir(PIN_ACK, GPIO_IN);
+    gpio_set_dir(bus_dat, GPIO_IN);
+    gpio_set_dir(bus_ack, GPIO_IN);
 }
@@ -27,9 +27,28 @@
 // PSX Bit-Banging Low-Level Functions
 // ============================================================================
 
-// Initialize PSX bus GPIO pins
+// Pin set of one console port
+typedef struct
+{
+    uint8_t dat;
+    uint8_t cmd;
+    uint8_t sel;
+    uint8_t clk;
+    uint8_t ack;
+} psx_port_pins_t;
+
+extern const psx_port_pins_t psx_port_pins[PSX_PORT_COUNT];
+
+// Initialize PSX bus GPIO pins (all configured ports)
 void psx_bitbang_init(void);
 
+// Route the bus functions below to the given port's pins.
+// Called by Core 1 when a port's SEL is asserted; port 0 is selected after init.
+void psx_bitbang_select_port(uint8_t port);
+
+// Port currently routed to the bus functions
+uint8_t psx_bitbang_active_port(void);
+
 // Open-drain control functions for DAT and ACK lines
 // Hi-Z state: set pin to input mode (pulled HIGH by external resistor)
 // LOW state: set pin to output mode with LOW value
@@ -57,7 +76,7 @@ uint8_t psx_receive_byte(void);
 bool psx_send_byte(uint8_t data);
 
 // Send ACK pulse after byte transmission
-// Asserts ACK LOW for ACK_PULSE_WIDTH_US after ACK_DELAY_US
+// Asserts ACK LOW after the profile's pre-ACK delay, for the tuned (or profile) pulse width
 void psx_send_ack(void);
 
 // Simultaneous send and receive (full duplex)
@@ -67,31 +86,90 @@ uint8_t psx_transfer_byte(uint8_t data_out);
 // Release bus completely (both DAT and ACK to Hi-Z)
 void psx_release_bus(void);
 
+// True if DAT or ACK of the active port is currently driven LOW
+bool psx_bus_driven(void);
+
+// True if an edge wait timed out with SEL still LOW since the previous
+// psx_take_timeout() (which also clears it)
+bool psx_timed_out(void);
+bool psx_take_timeout(void);
+
+// ============================================================================
+// Bus Speed Detection
+// ============================================================================
+
+// Timing profile selected from the measured CLK rate
+typedef struct
+{
+    const char *name;
+    uint32_t min_khz;          // Lowest measured clock this profile applies to
+    uint32_t clk_timeout_us;   // Timeout for a single CLK edge
+    uint32_t ack_delay_us;     // Delay before asserting ACK
+    uint32_t ack_pulse_us;     // ACK pulse width (auto-tune start point)
+    uint32_t ack_post_wait_us; // Wait after ACK (auto-tune start point)
+} psx_timing_profile_t;
+
+// Stage of a byte at which a CLK edge wait timed out
+typedef enum
+{
+    PSX_TIMEOUT_ADDRESS,    // First edge after SEL (profile timeout)
+    PSX_TIMEOUT_INTER_BYTE, // First edge of a following byte (learned gap)
+    PSX_TIMEOUT_INTRA_BYTE, // Edges inside a byte (learned clock period)
+    PSX_TIMEOUT_STAGE_COUNT
+} psx_timeout_stage_t;
+
+// Re-evaluate the active port's profile and edge timeouts from the last received address byte.
+// Switches after PSX_TIMING_CONFIRM consecutive measurements agree (resets ACK tuning).
+// Returns true if the profile changed.
+bool psx_timing_update(void);
+
+// Active profile of a port
+const psx_timing_profile_t *psx_timing_get_profile(uint8_t port);
+
+// Last measured bus clock of a port (kHz, 0 = not measured yet)
+uint32_t psx_timing_get_clock_khz(uint8_t port);
+
+// Last measured gap between two bytes of a port (µs)
+uint32_t psx_timing_get_gap_us(uint8_t port);
+
+// Number of profile switches on a port since boot
+uint32_t psx_timing_get_switches(uint8_t port);
+
+// Edge wait timeouts of a port at the given stage (SEL releases are not counted)
+uint32_t psx_timing_get_timeouts(uint8_t port, psx_timeout_stage_t stage);
+
+// Current timeout of a port for the given stage (µs)
+uint32_t psx_timing_get_timeout_us(uint8_t port, psx_timeout_stage_t stage);
+
+// Short name of a timeout stage for debug output
+const char *psx_timeout_stage_name(psx_timeout_stage_t stage);
+
 // ============================================================================
 // ACK Auto-Tuning Functions (only available if ACK_AUTO_TUNE_ENABLED)
 // ============================================================================
 
 #if ACK_AUTO_TUNE_ENABLED
+// Tuning state is kept per port; these act on the active port.
 // Call when address byte is received (increments attempt counter)
 void psx_ack_tune_on_address(void);
 
 // Call when command byte is received (cmd_success = cmd != 0xFF)
 void psx_ack_tune_on_command(bool cmd_success);
 
-// Reset tuning state
+// Reset tuning state (active port)
 void psx_ack_tune_reset(void);
 
-// Get current ACK pulse width
-uint32_t psx_ack_get_pulse_width(void);
+// Get current ACK pulse width of a port
+uint32_t psx_ack_get_pulse_width(uint8_t port);
 
-// Get current ACK post-wait time
-uint32_t psx_ack_get_post_wait(void);
+// Get current ACK post-wait time of a port
+uint32_t psx_ack_get_post_wait(uint8_t port);
 
-// Check if tuning is complete
-bool psx_ack_is_tuning_complete(void);
+// Check if tuning is complete on a port
+bool psx_ack_is_tuning_complete(uint8_t port);
 
-// Check if tuning has started
-bool psx_ack_is_tuning_started(void);
+// Check if tuning has started on a port
+bool psx_ack_is_tuning_started(uint8_t port);
 #endif
 
 #endif // PSX_BITBANG_H
@@ -0,0 +1,117 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "psx_device.h"
+#include "config.h"
+#include "shared_state.h"
+#include "persona.h"
+#include "turbo.h"
+#include "macro.h"
+#include "inject.h"
+#include "pico/stdlib.h"
+#include <stddef.h>
+
+// ============================================================================
+// Controller (0x01)
+// ============================================================================
+
+// The device type answered is the port's persona (digital pad by default)
+static uint8_t __time_critical_func(controller_first_byte)(uint8_t port)
+{
+    return persona_begin(port);
+}
+
+static uint8_t __time_critical_func(controller_respond)(uint8_t port, uint8_t cmd, uint8_t *frame)
+{
+    // Only poll (0x42) is answered; none of the personas has a config mode
+    if (cmd != PSX_CMD_POLL)
+    {
+        return 0;
+    }
+
+    // Read current button state from shared memory
+    uint8_t btn1, btn2;
+    shared_state_read(port, &btn1, &btn2);
+
+    // Turbo, injection and macros drive the physical pad on port 1 only
+    if (port == 0)
+    {
+        // Turbo advances once per poll so each phase lasts whole frames
+        uint16_t buttons = turbo_apply_poll((uint16_t)(btn1 | (btn2 << 8)));
+
+        // Host-injected state due on this poll replaces live input
+        buttons = inject_on_poll(buttons);
+
+        // Record this poll's output, or substitute the recorded frame
+        buttons = macro_on_poll(buttons);
+        btn1 = (uint8_t)(buttons & 0xFF);
+        btn2 = (uint8_t)(buttons >> 8);
+    }
+
+    // Controller -> console: 0x5A btn1 btn2 [persona payload]
+    return persona_poll_frame(port, (uint16_t)(btn1 | (btn2 << 8)), frame);
+}
+
+static void __time_critical_func(controller_complete)(uint8_t port, uint8_t cmd, bool delivered)
+{
+    // An injected word counts only once the console has read all of it
+    if (port == 0 && cmd == PSX_CMD_POLL)
+    {
+        inject_poll_done(delivered);
+    }
+}
+
+static psx_device_t device_controller = {
+    .name = "controller",
+    .action = PSX_DEVICE_RESPOND,
+    .first_byte = controller_first_byte,
+    .respond = controller_respond,
+    .complete = controller_complete,
+};
+
+// ============================================================================
+// Devices Not Emulated
+// ============================================================================
+
+// The memory card shares the port: never touch the bus while it talks
+static psx_device_t device_memcard = {
+    .name = "memory card",
+    .action = PSX_DEVICE_LISTEN,
+};
+
+static psx_device_t device_ignored = {
+    .name = "ignored",
+    .action = PSX_DEVICE_IGNORE,
+};
+
+// ============================================================================
+// Dispatch Table
+// ============================================================================
+
+// Not const, so the table and the descriptors above live in RAM (see psx_device.h)
+const psx_device_t *psx_device_table[256] = {
+    [PSX_ADDR_CONTROLLER] = &device_controller,
+    [PSX_ADDR_MEMCARD] = &device_memcard,
+
+    // Known addresses to stay silent on
+    [0xFF] = &device_ignored, // Idle bus read as an address byte
+    [0x21] = &device_ignored, // Yaroze Access Card / PS2 multitap (incompatible with PS1)
+    [0x61] = &device_ignored, // PS2 DVD remote receiver
+    [0x43] = &device_ignored, // Config mode command byte read as an address (SEL edge missed)
+    [0x4D] = &device_ignored, // Rumble map command byte read as an address (SEL edge missed)
+};
@@ -0,0 +1,74 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PSX_DEVICE_H
+#define PSX_DEVICE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ============================================================================
+// Bus Device Dispatch
+// ============================================================================
+
+// The address byte indexes a 256-entry table, so the first byte of a
+// transaction costs one load however many devices are known. The entry says
+// what the protocol task does for the rest of the transaction.
+//
+// Emulated devices share one byte-stream interface: the first response byte
+// goes out while the command byte arrives, then the device builds everything
+// that follows in one go and the protocol task streams it, with an ACK after
+// every byte but the last. No device code runs between bytes.
+
+typedef enum
+{
+    PSX_DEVICE_RESPOND, // Emulated here: ACK and answer through the handlers
+    PSX_DEVICE_LISTEN,  // Another device answers (memory card): stay off the bus until SEL rises
+    PSX_DEVICE_IGNORE,  // Known device not emulated: release the bus, wait for the next SEL
+} psx_device_action_t;
+
+// Response bytes after the command byte
+#define PSX_DEVICE_FRAME_MAX 8
+
+typedef struct
+{
+    const char *name;
+    psx_device_action_t action;
+
+    // PSX_DEVICE_RESPOND only (Core 1, timing critical):
+    // Response byte sent while the command byte is received
+    uint8_t (*first_byte)(uint8_t port);
+    // Fill frame[] with the bytes after the command byte and return how many
+    // (at most PSX_DEVICE_FRAME_MAX); 0 = command not supported, stay silent
+    uint8_t (*respond)(uint8_t port, uint8_t cmd, uint8_t *frame);
+    // Optional, after a frame from respond(): delivered = every byte was
+    // clocked out, false = the console cut the transaction short
+    void (*complete)(uint8_t port, uint8_t cmd, bool delivered);
+} psx_device_t;
+
+// Device for each address, NULL where no device is known.
+// The table and the descriptors are kept in RAM: a flash (XIP) cache miss
+// would stall the first byte.
+extern const psx_device_t *psx_device_table[256];
+
+static inline const psx_device_t *psx_device_for(uint8_t addr)
+{
+    return psx_device_table[addr];
+}
+
+#endif // PSX_DEVICE_H
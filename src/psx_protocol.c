@@ -18,8 +18,14 @@
 
 #include "psx_protocol.h"
 #include "psx_bitbang.h"
+#include "psx_device.h"
 #include "config.h"
+#include "bench.h"
+#include "seqlock.h"
+#include "hardware/clocks.h"
 #include "hardware/gpio.h"
+#include "hardware/structs/systick.h"
+#include "hardware/sync.h"
 #include "pico/stdlib.h"
 #include <stdio.h>
 
@@ -28,16 +34,149 @@
 // ============================================================================
 
 static volatile bool transaction_active = false;
-static psx_stats_t stats = {0};
-static uint32_t last_transaction_time = 0;
-static uint64_t total_interval_sum = 0;
-static uint64_t interval_count = 0;
+
+// Statistics of one port. Counters only ever grow; the average interval is
+// derived from the sums when read.
+typedef struct
+{
+    psx_stats_t stats;
+    uint64_t interval_sum_us;
+    uint64_t interval_count;
+} port_counters_t;
+
+// Idle statistics. Sums only ever grow; min/max restart on request.
+typedef struct
+{
+    uint64_t idle_us;  // Time spent waiting for SEL
+    uint32_t time_us;  // Core 1 time of the snapshot
+    uint32_t wakeups;
+    uint32_t spurious;
+    uint32_t wake_min_cycles;
+    uint32_t wake_max_cycles;
+    uint32_t wake_hist[PSX_WAKE_BUCKETS];
+} idle_counters_t;
+
+// Core 1 working copies (index = console port); only Core 1 writes them
+static port_counters_t counters[PSX_PORT_COUNT];
+static idle_counters_t idle;
+static uint32_t last_transaction_time[PSX_PORT_COUNT];
+
+// Published by Core 1 between transactions; stats_seq is odd while the
+// snapshot is being written
+static port_counters_t counters_snapshot[PSX_PORT_COUNT];
+static idle_counters_t idle_snapshot;
+static volatile uint32_t stats_seq = 0;
+
+// Core 0 -> Core 1: stop at the top of the loop; Core 1 answers with parked
+static volatile bool park_request = false;
+static volatile bool parked = false;
+
+// Core 0 -> Core 1: restart the min/max values when request != ack
+static volatile uint32_t minmax_reset_request = 0;
+static volatile uint32_t minmax_reset_ack = 0;
+
+// Core 0: snapshot values at the last reset, subtracted on read
+static port_counters_t counters_baseline[PSX_PORT_COUNT];
+static idle_counters_t idle_baseline;
+
+// SEL pins of all ports, for a single-read wait on any port
+static uint32_t sel_mask = 0;
+
+// SEL pins of ports whose transaction ended (timeout, abort, not for us)
+// with SEL still LOW: the rest of that frame is not a new transaction, so
+// they are ignored until SEL rises
+static volatile uint32_t sel_ended = 0;
+
+// Bucket limits in cycles, from clk_sys at init
+static const uint32_t wake_bucket_ns[PSX_WAKE_BUCKETS - 1] = {250, 500, 1000, 2000};
+static uint32_t wake_bucket_cycles[PSX_WAKE_BUCKETS - 1];
+static uint32_t settle_cycles = 0;
+static uint32_t cycles_per_us = 125;
+
+#if PSX_IDLE_WFE
+// Set by the SEL falling-edge IRQ (Core 1 SysTick value at handler entry)
+static volatile bool sel_fell = false;
+static volatile uint32_t sel_fall_cycles = 0;
+// Set by the SEL rising-edge IRQ: taking it also set the event register
+static volatile bool sel_rise_event = false;
+#endif
 
 // ============================================================================
 // Forward Declarations
 // ============================================================================
 
-static bool handle_poll_command(uint8_t btn1, uint8_t btn2);
+static bool stream_response(psx_stats_t *stats, const uint8_t *frame, uint8_t len);
+
+// ============================================================================
+// Invariant Checks
+// ============================================================================
+
+#if PSX_INVARIANT_CHECKS
+static void record_violation(psx_stats_t *stats, psx_invariant_t invariant)
+{
+    stats->invariant_violations++;
+    stats->last_violation = (uint8_t)invariant;
+}
+#endif
+
+const char *psx_invariant_name(uint8_t invariant)
+{
+    switch (invariant)
+    {
+    case PSX_INVARIANT_NONE:
+        return "none";
+    case PSX_INVARIANT_BUS_HELD:
+        return "bus held after SEL";
+    case PSX_INVARIANT_MEMCARD_DRIVEN:
+        return "driven during memcard";
+    default:
+        return "?";
+    }
+}
+
+// ============================================================================
+// Error Accounting
+// ============================================================================
+
+// Count an abandoned transaction at its failure site, and as a timeout if a
+// byte edge never came while SEL was still LOW (rather than the console ending it)
+static inline void __time_critical_func(record_error)(psx_stats_t *stats, psx_error_t error)
+{
+    stats->errors[error]++;
+    if (psx_take_timeout())
+    {
+        stats->timeout_errors++;
+    }
+}
+
+const char *psx_error_name(uint8_t error)
+{
+    switch (error)
+    {
+    case PSX_ERROR_FALSE_SELECT:
+        return "false select";
+    case PSX_ERROR_ADDRESS:
+        return "address";
+    case PSX_ERROR_ADDRESS_ACK:
+        return "address ACK";
+    case PSX_ERROR_COMMAND:
+        return "command";
+    case PSX_ERROR_AFTER_COMMAND:
+        return "after command";
+    case PSX_ERROR_POLL_BYTE3:
+        return "byte 3";
+    case PSX_ERROR_POLL_BYTE4:
+        return "byte 4";
+    case PSX_ERROR_POLL_BYTE5:
+        return "byte 5+";
+    case PSX_ERROR_UNKNOWN_CMD:
+        return "unknown command";
+    case PSX_ERROR_UNKNOWN_ADDR:
+        return "unknown address";
+    default:
+        return "?";
+    }
+}
 
 // ============================================================================
 // Initialization
@@ -48,12 +187,40 @@ void psx_protocol_init(void)
     // Initialize bit-banging layer
     psx_bitbang_init();
 
-    // Set up SELECT interrupt for rising edge (transaction end/abort)
-    gpio_set_irq_enabled_with_callback(PIN_SEL, GPIO_IRQ_EDGE_RISE, true,
-                                       &psx_sel_interrupt_handler);
+    // Set up SELECT interrupt for rising edge (transaction end/abort) on every port
+    sel_mask = 0;
+    sel_ended = 0;
+    for (uint8_t port = 0; port < PSX_PORT_COUNT; port++)
+    {
+        sel_mask |= 1u << psx_port_pins[port].sel;
+        gpio_set_irq_enabled_with_callback(psx_port_pins[port].sel, GPIO_IRQ_EDGE_RISE, true,
+                                           &psx_sel_interrupt_handler);
+    }
 
-    // Reset statistics
-    psx_reset_stats();
+    // Counters are zero at boot and not cleared here (resets are baselines on
+    // Core 0); the transaction cut short by a restart is simply not counted.
+    // A Core 1 reset without psx_protocol_park() can stop publish_stats()
+    // half-way: make the sequence even again so readers don't spin forever.
+    for (uint8_t port = 0; port < PSX_PORT_COUNT; port++)
+    {
+        last_transaction_time[port] = 0;
+    }
+    seqlock_recover(&stats_seq);
+    park_request = false;
+    parked = false;
+
+    // Core 1's own SysTick as a free-running cycle counter for the wake latency
+    // (SysTick is per core, so this doesn't touch Core 0's)
+    systick_hw->rvr = 0x00FFFFFF;
+    systick_hw->cvr = 0;
+    systick_hw->csr = 0x5; // ENABLE | CLKSOURCE (processor clock)
+
+    cycles_per_us = clock_get_hz(clk_sys) / 1000000;
+    settle_cycles = PSX_SEL_SETTLE_NS * cycles_per_us / 1000;
+    for (int i = 0; i < PSX_WAKE_BUCKETS - 1; i++)
+    {
+        wake_bucket_cycles[i] = wake_bucket_ns[i] * cycles_per_us / 1000;
+    }
 
     transaction_active = false;
 }
@@ -64,8 +231,32 @@ void psx_protocol_init(void)
 
 void __time_critical_func(psx_sel_interrupt_handler)(unsigned int gpio_num, uint32_t events)
 {
+#if PSX_IDLE_WFE
+    // SEL falling edge while Core 1 sleeps: just note when it happened
+    if (events & GPIO_IRQ_EDGE_FALL)
+    {
+        sel_fall_cycles = systick_hw->cvr;
+        sel_fell = true;
+        gpio_acknowledge_irq(gpio_num, GPIO_IRQ_EDGE_FALL);
+        if (!(events & GPIO_IRQ_EDGE_RISE))
+        {
+            return;
+        }
+    }
+#endif
+
     // Acknowledge interrupt
-    gpio_acknowledge_irq(PIN_SEL, GPIO_IRQ_EDGE_RISE);
+    gpio_acknowledge_irq(gpio_num, GPIO_IRQ_EDGE_RISE);
+    sel_ended &= ~(1u << gpio_num);
+#if PSX_IDLE_WFE
+    sel_rise_event = true;
+#endif
+
+    // Another port's SELECT does not end the transaction in progress
+    if (gpio_num != psx_port_pins[psx_bitbang_active_port()].sel)
+    {
+        return;
+    }
 
     // Immediately release bus on SELECT rising edge
     psx_release_bus();
@@ -74,60 +265,280 @@ void __time_critical_func(psx_sel_interrupt_handler)(unsigned int gpio_num, uint
     transaction_active = false;
 }
 
+// ============================================================================
+// Idle Wait (Core 1)
+// ============================================================================
+
+#if PSX_IDLE_WFE
+static void set_sel_fall_irq(bool enabled)
+{
+    for (uint8_t port = 0; port < PSX_PORT_COUNT; port++)
+    {
+        gpio_set_irq_enabled(psx_port_pins[port].sel, GPIO_IRQ_EDGE_FALL, enabled);
+    }
+}
+
+static void record_wake(uint32_t cycles)
+{
+    idle.wakeups++;
+    if (idle.wake_min_cycles == 0 || cycles < idle.wake_min_cycles)
+    {
+        idle.wake_min_cycles = cycles;
+    }
+    if (cycles > idle.wake_max_cycles)
+    {
+        idle.wake_max_cycles = cycles;
+    }
+
+    int bucket = 0;
+    while (bucket < PSX_WAKE_BUCKETS - 1 && cycles >= wake_bucket_cycles[bucket])
+    {
+        bucket++;
+    }
+    idle.wake_hist[bucket]++;
+}
+#endif
+
+// SEL pins that are LOW, less those of a frame already served
+static inline uint32_t __time_critical_func(read_selected)(void)
+{
+    uint32_t low = ~gpio_get_all() & sel_mask;
+    sel_ended &= low;
+    return low & ~sel_ended;
+}
+
+// Wait for any port's SELECT to go LOW and let it settle.
+// Returns the SEL pins that are LOW, or 0 if Core 0 asked Core 1 to park.
+static uint32_t __time_critical_func(wait_for_sel)(void)
+{
+    uint32_t selected;
+    uint32_t start = time_us_32();
+
+#if PSX_IDLE_WFE
+    // Sleep until a SEL falling edge. An edge between the check and __wfe()
+    // still wakes us: the taken IRQ sets the event register.
+    sel_fell = false;
+    set_sel_fall_irq(true);
+    while ((selected = read_selected()) == 0)
+    {
+        if (park_request)
+        {
+            break; // Woken by psx_protocol_park()
+        }
+        __wfe();
+        if (!sel_fell && !sel_rise_event)
+        {
+            idle.spurious++; // SEV from Core 0 (e.g. spin lock release)
+        }
+        sel_rise_event = false; // Its event is consumed now
+    }
+    set_sel_fall_irq(false);
+    idle.idle_us += time_us_32() - start;
+
+    if (selected == 0)
+    {
+        return 0;
+    }
+
+    if (sel_fell)
+    {
+        // The wake latency already counts towards the settle time
+        uint32_t fall = sel_fall_cycles;
+        record_wake(bench_cycles_between(fall, systick_hw->cvr));
+        while (bench_cycles_between(fall, systick_hw->cvr) < settle_cycles)
+        {
+            tight_loop_contents();
+        }
+        return selected;
+    }
+#else
+    while ((selected = read_selected()) == 0)
+    {
+        if (park_request)
+        {
+            idle.idle_us += time_us_32() - start;
+            return 0;
+        }
+        tight_loop_contents();
+    }
+    idle.idle_us += time_us_32() - start;
+#endif
+
+    // Small delay to ensure SELECT is stable
+    busy_wait_us_32((PSX_SEL_SETTLE_NS + 999) / 1000);
+    return selected;
+}
+
+// ============================================================================
+// Statistics Publication (Core 1)
+// ============================================================================
+
+// Called between transactions: apply a pending min/max reset, then copy the
+// working counters to the snapshot Core 0 reads
+static void publish_stats(void)
+{
+    uint32_t request = minmax_reset_request;
+    if (request != minmax_reset_ack)
+    {
+        for (uint8_t port = 0; port < PSX_PORT_COUNT; port++)
+        {
+            counters[port].stats.min_interval_us = 0;
+            counters[port].stats.max_interval_us = 0;
+        }
+        idle.wake_min_cycles = 0;
+        idle.wake_max_cycles = 0;
+        minmax_reset_ack = request;
+    }
+    idle.time_us = time_us_32();
+
+    seqlock_write_begin(&stats_seq);
+    for (uint8_t port = 0; port < PSX_PORT_COUNT; port++)
+    {
+        counters_snapshot[port] = counters[port];
+    }
+    idle_snapshot = idle;
+    seqlock_write_end(&stats_seq);
+}
+
 // ============================================================================
 // Main Protocol Task (Core 1)
 // ============================================================================
 
+// Stay here until Core 0 resets this core: the bus is released and the
+// snapshot is complete
+static void park(void)
+{
+    psx_release_bus();
+    __dmb();
+    parked = true;
+    while (1)
+    {
+        __wfe();
+    }
+}
+
 void psx_protocol_task(void)
 {
     while (1)
     {
-        // Wait for SELECT to go LOW (transaction start)
-        while (psx_read_sel())
+        publish_stats();
+
+        if (park_request)
         {
-            tight_loop_contents();
+            park();
         }
 
-        // Small delay to ensure SELECT is stable
-        busy_wait_us_32(1);
+#if PSX_INVARIANT_CHECKS
+        // Every exit path must leave DAT and ACK released before the next transaction
+        if (psx_bus_driven())
+        {
+            record_violation(&counters[psx_bitbang_active_port()].stats, PSX_INVARIANT_BUS_HELD);
+            psx_release_bus();
+        }
+#endif
+
+        // Wait for any port's SELECT to go LOW (transaction start)
+        uint32_t selected = wait_for_sel();
+        if (selected == 0)
+        {
+            continue; // Park request: publish and stop at the top of the loop
+        }
+
+        // Route the bus to the selected port (port 1 wins a simultaneous start)
+        uint8_t port = 0;
+        while (!(selected & (1u << psx_port_pins[port].sel)))
+        {
+            port++;
+        }
+        psx_bitbang_select_port(port);
+        uint sel_pin = psx_port_pins[port].sel;
+        sel_ended |= 1u << sel_pin; // However this transaction ends, it is served until SEL rises
+        psx_stats_t *stats = &counters[port].stats;
+
+#if PSX_PORT_COUNT > 1
+        // Any other port already selected cannot be served this time
+        for (uint8_t other = 0; other < PSX_PORT_COUNT; other++)
+        {
+            if (other != port && (selected & (1u << psx_port_pins[other].sel)))
+            {
+                counters[other].stats.overlapped_transactions++;
+            }
+        }
+#endif
 
         // Double-check SELECT is still LOW
         if (psx_read_sel())
         {
+            stats->errors[PSX_ERROR_FALSE_SELECT]++;
             continue; // False trigger, go back to waiting
         }
 
         // Mark transaction as active
         transaction_active = true;
+        psx_take_timeout();
 
         // Receive first byte (device address) - don't send anything yet, keep DAT Hi-Z
         uint8_t addr = psx_receive_byte();
 
-        // Check if transaction was aborted
-        if (!transaction_active || psx_read_sel())
+        // Check if transaction was aborted or nothing was clocked in
+        if (!transaction_active || psx_read_sel() || psx_timed_out())
         {
+            record_error(stats, PSX_ERROR_ADDRESS);
             psx_release_bus();
             continue;
         }
 
         // Count all transactions (valid or invalid)
-        stats.total_transactions++;
+        stats->total_transactions++;
 
-        // CRITICAL: Check for memory card FIRST and immediately release bus
+        // One table load decides the rest of the transaction
+        const psx_device_t *device = psx_device_for(addr);
+        if (device == NULL)
+        {
+            // Truly unknown address - log it
+            stats->errors[PSX_ERROR_UNKNOWN_ADDR]++;
+            stats->invalid_transactions++;
+            stats->last_invalid_addr = addr;
+            psx_release_bus();
+            transaction_active = false;
+            continue;
+        }
+
+        if (device->action == PSX_DEVICE_IGNORE)
+        {
+            // Known address to ignore - stay silent
+            psx_release_bus();
+            transaction_active = false;
+            continue;
+        }
+
+        // CRITICAL: Memory card addressed - immediately release bus
         // This must happen before any other processing to avoid interfering with memory card communication
-        if (addr == PSX_ADDR_MEMCARD)
+        if (device->action == PSX_DEVICE_LISTEN)
         {
             // Memory card addressed - immediately release bus and stay completely silent
-            stats.memcard_transactions++;
+            stats->memcard_transactions++;
             psx_release_bus();
 
             // IMPORTANT: Wait for the entire memory card transaction to complete
             // SEL will stay LOW during the full memory card communication
             // We must wait until SEL goes HIGH before starting to listen for next transaction
+#if PSX_INVARIANT_CHECKS
+            bool driven = false;
+            while (!psx_read_sel() && transaction_active)
+            {
+                driven |= psx_bus_driven();
+            }
+            if (driven)
+            {
+                record_violation(stats, PSX_INVARIANT_MEMCARD_DRIVEN);
+            }
+#else
             while (!psx_read_sel() && transaction_active)
             {
                 tight_loop_contents();
             }
+#endif
 
             // Transaction ended
             transaction_active = false;
@@ -136,154 +547,127 @@ void psx_protocol_task(void)
             continue;
         }
 
-        // Handle based on address
-        if (addr == PSX_ADDR_CONTROLLER)
+        // Emulated device addressed - process transaction
+        stats->controller_transactions++;
+
+        // Ensure DAT is Hi-Z before ACK
+        psx_dat_hiz();
+
+        // Send ACK after receiving address byte immediately (no debug output here - timing critical!)
+        // Disable SEL interrupt temporarily to avoid false abort during ACK pulse
+        gpio_set_irq_enabled(sel_pin, GPIO_IRQ_EDGE_RISE, false);
+        psx_send_ack();
+        // Clear any pending interrupts before re-enabling
+        gpio_acknowledge_irq(sel_pin, GPIO_IRQ_EDGE_RISE);
+        gpio_set_irq_enabled(sel_pin, GPIO_IRQ_EDGE_RISE, true);
+
+        // Check if SEL went HIGH during ACK
+        if (psx_read_sel())
         {
-            // Controller addressed - process transaction
-            stats.controller_transactions++;
-
-            // Ensure DAT is Hi-Z before ACK
-            gpio_set_dir(PIN_DAT, GPIO_IN);
-
-            // Send ACK after receiving address byte immediately (no debug output here - timing critical!)
-            // Disable SEL interrupt temporarily to avoid false abort during ACK pulse
-            gpio_set_irq_enabled(PIN_SEL, GPIO_IRQ_EDGE_RISE, false);
-            psx_send_ack();
-            // Clear any pending interrupts before re-enabling
-            gpio_acknowledge_irq(PIN_SEL, GPIO_IRQ_EDGE_RISE);
-            gpio_set_irq_enabled(PIN_SEL, GPIO_IRQ_EDGE_RISE, true);
-
-            // Check if SEL went HIGH during ACK
-            if (psx_read_sel())
-            {
-                psx_release_bus();
-                continue;
-            }
+            record_error(stats, PSX_ERROR_ADDRESS_ACK);
+            psx_release_bus();
+            continue;
+        }
+
+        // Follow the console's bus speed (may restart ACK tuning)
+        psx_timing_update();
 
 #if ACK_AUTO_TUNE_ENABLED
-            // Report address byte received for auto-tuning
-            extern void psx_ack_tune_on_address(void);
-            psx_ack_tune_on_address();
+        // Report address byte received for auto-tuning
+        extern void psx_ack_tune_on_address(void);
+        psx_ack_tune_on_address();
 
-            // Wait for PSX to prepare for CMD transmission after ACK (auto-tuned)
-            extern uint32_t psx_ack_get_post_wait(void);
-            busy_wait_us_32(psx_ack_get_post_wait());
+        // Wait for PSX to prepare for CMD transmission after ACK (auto-tuned)
+        extern uint32_t psx_ack_get_post_wait(uint8_t port);
+        busy_wait_us_32(psx_ack_get_post_wait(port));
 #else
-            // Fixed wait time
-            busy_wait_us_32(50);
+        // Wait from the bus speed profile
+        busy_wait_us_32(psx_timing_get_profile(port)->ack_post_wait_us);
 #endif
 
-            // Now start responding: receive command byte while sending controller ID low byte
-            uint8_t cmd = psx_transfer_byte(PSX_ID_DIGITAL_LO);
+        // Now start responding: receive command byte while sending the device's first byte
+        uint8_t cmd = psx_transfer_byte(device->first_byte(port));
 
 #if ACK_AUTO_TUNE_ENABLED
-            // Report command byte result for auto-tuning
-            extern void psx_ack_tune_on_command(bool cmd_success);
-            psx_ack_tune_on_command(cmd != 0xFF);
+        // Report command byte result for auto-tuning
+        extern void psx_ack_tune_on_command(bool cmd_success);
+        psx_ack_tune_on_command(cmd != 0xFF);
 #endif
 
-            // Disable SEL interrupt briefly - no debug output here, timing critical!
-            gpio_set_irq_enabled(PIN_SEL, GPIO_IRQ_EDGE_RISE, false);
+        // Disable SEL interrupt briefly - no debug output here, timing critical!
+        gpio_set_irq_enabled(sel_pin, GPIO_IRQ_EDGE_RISE, false);
 
-            if (cmd == 0xFF)
-            {
-                // transfer_byte returned 0xFF = timeout or abort during transfer
-                psx_release_bus();
-                gpio_set_irq_enabled(PIN_SEL, GPIO_IRQ_EDGE_RISE, true);
-                continue;
-            }
+        if (cmd == 0xFF)
+        {
+            // transfer_byte returned 0xFF = timeout or abort during transfer
+            record_error(stats, PSX_ERROR_COMMAND);
+            psx_release_bus();
+            gpio_set_irq_enabled(sel_pin, GPIO_IRQ_EDGE_RISE, true);
+            continue;
+        }
 
-            // Check SEL state while interrupt disabled
-            if (psx_read_sel())
-            {
-                psx_release_bus();
-                gpio_set_irq_enabled(PIN_SEL, GPIO_IRQ_EDGE_RISE, true);
-                continue;
-            }
+        // Check SEL state while interrupt disabled
+        if (psx_read_sel())
+        {
+            record_error(stats, PSX_ERROR_AFTER_COMMAND);
+            psx_release_bus();
+            gpio_set_irq_enabled(sel_pin, GPIO_IRQ_EDGE_RISE, true);
+            continue;
+        }
 
-            // SEL is still LOW - safe to proceed, now re-enable interrupt
-            gpio_set_irq_enabled(PIN_SEL, GPIO_IRQ_EDGE_RISE, true);
+        // SEL is still LOW - safe to proceed, now re-enable interrupt
+        gpio_set_irq_enabled(sel_pin, GPIO_IRQ_EDGE_RISE, true);
 
-            if (!transaction_active || psx_read_sel())
-            {
-                psx_release_bus();
-                continue;
-            }
+        if (!transaction_active || psx_read_sel())
+        {
+            record_error(stats, PSX_ERROR_AFTER_COMMAND);
+            psx_release_bus();
+            continue;
+        }
 
-            // Handle command
-            if (cmd == PSX_CMD_POLL)
+        if (cmd == PSX_CMD_POLL)
+        {
+            // Calculate poll interval (only for 0x42 command)
+            uint32_t current_time = time_us_32();
+            if (last_transaction_time[port] != 0)
             {
-                // Calculate poll interval (only for 0x42 command)
-                uint32_t current_time = time_us_32();
-                if (last_transaction_time != 0)
+                uint32_t interval = current_time - last_transaction_time[port];
+
+                // Update min/max
+                if (stats->min_interval_us == 0 || interval < stats->min_interval_us)
                 {
-                    uint32_t interval = current_time - last_transaction_time;
-
-                    // Update min/max
-                    if (stats.min_interval_us == 0 || interval < stats.min_interval_us)
-                    {
-                        stats.min_interval_us = interval;
-                    }
-                    if (interval > stats.max_interval_us)
-                    {
-                        stats.max_interval_us = interval;
-                    }
-
-                    // Update average
-                    total_interval_sum += interval;
-                    interval_count++;
-                    stats.avg_interval_us = (uint32_t)(total_interval_sum / interval_count);
+                    stats->min_interval_us = interval;
+                }
+                if (interval > stats->max_interval_us)
+                {
+                    stats->max_interval_us = interval;
                 }
-                last_transaction_time = current_time;
-
-                // Read current button state from shared memory
-                uint8_t btn1, btn2;
-                extern void shared_state_read(uint8_t *btn1, uint8_t *btn2);
-                shared_state_read(&btn1, &btn2);
 
-                // Process poll command (0x42) - only command we support
-                bool success = handle_poll_command(btn1, btn2);
-                (void)success; // Suppress unused variable warning
-            }
-            else
-            {
-                // Ignore all other commands (Config mode commands, etc.)
-                // Digital controller doesn't need to respond to Config mode
-                psx_release_bus();
+                // Sums for the average (computed when read)
+                counters[port].interval_sum_us += interval;
+                counters[port].interval_count++;
             }
+            last_transaction_time[port] = current_time;
+        }
+
+        // The device builds the rest of its answer at once
+        uint8_t frame[PSX_DEVICE_FRAME_MAX];
+        uint8_t frame_len = device->respond(port, cmd, frame);
+        if (frame_len == 0)
+        {
+            // Ignore all other commands (Config mode commands, etc.)
+            // Digital controller doesn't need to respond to Config mode
+            stats->errors[PSX_ERROR_UNKNOWN_CMD]++;
+            stats->last_invalid_cmd = cmd;
+            psx_release_bus();
         }
         else
         {
-            // Check if this is a known address to ignore
-            static const uint8_t ignored_addresses[] = {
-                0xFF, // Timeout or aborted address byte
-                0x21, // Yaroze Access Card / PS2 multitap (incompatible with PS1)
-                0x61, // PS2 DVD remote receiver
-                0x43, // Config command address
-                0x4D, // Config command address
-            };
-
-            bool should_ignore = false;
-            for (size_t i = 0; i < sizeof(ignored_addresses); i++)
-            {
-                if (addr == ignored_addresses[i])
-                {
-                    should_ignore = true;
-                    break;
-                }
-            }
-
-            if (should_ignore)
+            // Aborts are counted by byte inside
+            bool delivered = stream_response(stats, frame, frame_len);
+            if (device->complete != NULL)
             {
-                // Known address to ignore - stay silent
-                psx_release_bus();
-            }
-            else
-            {
-                // Truly unknown address - log it
-                stats.invalid_transactions++;
-                stats.last_invalid_addr = addr;
-                psx_release_bus();
+                device->complete(port, cmd, delivered);
             }
         }
 
@@ -294,61 +678,43 @@ void psx_protocol_task(void)
 }
 
 // ============================================================================
-// Command Handlers
+// Response Streaming
 // ============================================================================
 
-static bool __time_critical_func(handle_poll_command)(uint8_t btn1, uint8_t btn2)
+// Stream a device's frame after the command byte: ACK the previous byte,
+// then exchange the next. No ACK follows the last byte.
+static bool __time_critical_func(stream_response)(psx_stats_t *stats, const uint8_t *frame, uint8_t len)
 {
-    // Poll command sequence:
+    // Example, digital controller poll:
     // PSX -> Controller:  0x01  0x42  0x00  0x00  0x00
     // Controller -> PSX:  0xFF  0x41  0x5A  btn1  btn2
+    // We've already transferred: 0x01/0xFF and 0x42/0x41, frame = 0x5A btn1 btn2
 
-    // We've already transferred: 0x01/0xFF and 0x42/0x41
-    // Send ACK after ID_LO
-    psx_send_ack();
-
-    if (!transaction_active || psx_read_sel())
+    for (uint8_t i = 0; i < len; i++)
     {
-        return false;
-    }
+        // An abort is counted against the byte the console was due to clock next
+        // (frame byte i is byte i + 3 of the transaction)
+        psx_error_t site = i < 2 ? (psx_error_t)(PSX_ERROR_POLL_BYTE3 + i) : PSX_ERROR_POLL_BYTE5;
 
-    // Transfer: receive 0x00, send ID_HI (0x5A)
-    uint8_t dummy1 = psx_transfer_byte(PSX_ID_DIGITAL_HI);
-    if (!transaction_active || psx_read_sel())
-    {
-        return false;
-    }
-
-    psx_send_ack();
-    if (!transaction_active || psx_read_sel())
-    {
-        return false;
-    }
-
-    // Transfer: receive 0x00, send button data byte 1
-    uint8_t dummy2 = psx_transfer_byte(btn1);
-    if (!transaction_active || psx_read_sel())
-    {
-        return false;
-    }
-    psx_send_ack();
+        psx_send_ack();
+        if (!transaction_active || psx_read_sel())
+        {
+            record_error(stats, site);
+            return false;
+        }
 
-    if (!transaction_active || psx_read_sel())
-    {
-        return false;
+        // A byte that timed out ends the frame rather than ACKing a partial byte
+        psx_transfer_byte(frame[i]);
+        if (!transaction_active || psx_read_sel() || psx_timed_out())
+        {
+            record_error(stats, site);
+            return false;
+        }
     }
 
-    // Transfer: receive 0x00, send button data byte 2
-    uint8_t dummy3 = psx_transfer_byte(btn2);
-    if (!transaction_active || psx_read_sel())
-    {
-        return false;
-    }
     // NOTE: Do NOT send ACK after the last byte!
     // Spec: "Once the last byte of the packet is transferred,
     //        the device shall no longer pulse /ACK."
-
-    // Transaction complete
     return true;
 }
 
@@ -356,6 +722,25 @@ static bool __time_critical_func(handle_poll_command)(uint8_t btn1, uint8_t btn2
 // Public API for Transaction Processing
 // ============================================================================
 
+bool psx_protocol_park(uint32_t timeout_us)
+{
+    parked = false;
+    __dmb();
+    park_request = true;
+    __sev(); // Wake Core 1 from its SEL wait
+
+    uint32_t start = time_us_32();
+    while (!parked)
+    {
+        if (time_us_32() - start > timeout_us)
+        {
+            return false;
+        }
+        tight_loop_contents();
+    }
+    return true;
+}
+
 bool psx_process_transaction(uint8_t btn1, uint8_t btn2)
 {
     // This function is kept for API compatibility
@@ -367,34 +752,87 @@ bool psx_process_transaction(uint8_t btn1, uint8_t btn2)
 // Statistics Functions
 // ============================================================================
 
-void psx_get_stats(psx_stats_t *stats_out)
+// Core 0: consistent copy of the published snapshot
+static void read_snapshot(port_counters_t *ports, idle_counters_t *idle_out)
+{
+    uint32_t seq;
+
+    // Retry until a consistent snapshot is read
+    do
+    {
+        seq = seqlock_read_begin(&stats_seq);
+        for (uint8_t port = 0; port < PSX_PORT_COUNT; port++)
+        {
+            ports[port] = counters_snapshot[port];
+        }
+        *idle_out = idle_snapshot;
+    } while (seqlock_read_retry(&stats_seq, seq));
+}
+
+void psx_get_stats(uint8_t port, psx_stats_t *stats_out)
 {
-    if (stats_out)
+    if (!stats_out || port >= PSX_PORT_COUNT)
+    {
+        return;
+    }
+
+    port_counters_t ports[PSX_PORT_COUNT];
+    idle_counters_t idle_now;
+    read_snapshot(ports, &idle_now);
+
+    const port_counters_t *now = &ports[port];
+    const port_counters_t *base = &counters_baseline[port];
+
+    *stats_out = now->stats;
+    stats_out->total_transactions -= base->stats.total_transactions;
+    stats_out->controller_transactions -= base->stats.controller_transactions;
+    stats_out->memcard_transactions -= base->stats.memcard_transactions;
+    stats_out->invalid_transactions -= base->stats.invalid_transactions;
+    stats_out->timeout_errors -= base->stats.timeout_errors;
+    stats_out->overlapped_transactions -= base->stats.overlapped_transactions;
+    stats_out->invariant_violations -= base->stats.invariant_violations;
+    for (int error = 0; error < PSX_ERROR_COUNT; error++)
     {
-        *stats_out = stats;
+        stats_out->errors[error] -= base->stats.errors[error];
     }
+
+    uint64_t count = now->interval_count - base->interval_count;
+    stats_out->avg_interval_us = count ? (uint32_t)((now->interval_sum_us - base->interval_sum_us) / count) : 0;
 }
 
 void psx_reset_stats(void)
 {
-    stats.total_transactions = 0;
-    stats.controller_transactions = 0;
-    stats.memcard_transactions = 0;
-    stats.invalid_transactions = 0;
-    stats.timeout_errors = 0;
-    stats.min_interval_us = 0;
-    stats.max_interval_us = 0;
-    stats.avg_interval_us = 0;
-    last_transaction_time = 0;
-    total_interval_sum = 0;
+    read_snapshot(counters_baseline, &idle_baseline);
+    minmax_reset_request++;
 }
 
 void psx_reset_interval_stats(void)
 {
-    stats.min_interval_us = 0;
-    stats.max_interval_us = 0;
-    stats.avg_interval_us = 0;
-    // Keep last_transaction_time to maintain continuity
-    total_interval_sum = 0;
-    interval_count = 0;
+    port_counters_t ports[PSX_PORT_COUNT];
+    read_snapshot(ports, &idle_baseline);
+
+    for (uint8_t port = 0; port < PSX_PORT_COUNT; port++)
+    {
+        counters_baseline[port].interval_sum_us = ports[port].interval_sum_us;
+        counters_baseline[port].interval_count = ports[port].interval_count;
+    }
+    minmax_reset_request++;
+}
+
+void psx_get_idle_stats(psx_idle_stats_t *stats)
+{
+    port_counters_t ports[PSX_PORT_COUNT];
+    idle_counters_t now;
+    read_snapshot(ports, &now);
+
+    stats->idle_us = now.idle_us - idle_baseline.idle_us;
+    stats->elapsed_us = now.time_us - idle_baseline.time_us;
+    stats->wakeups = now.wakeups - idle_baseline.wakeups;
+    stats->spurious = now.spurious - idle_baseline.spurious;
+    stats->wake_min_ns = now.wake_min_cycles * 1000 / cycles_per_us;
+    stats->wake_max_ns = now.wake_max_cycles * 1000 / cycles_per_us;
+    for (int i = 0; i < PSX_WAKE_BUCKETS; i++)
+    {
+        stats->wake_hist[i] = now.wake_hist[i] - idle_baseline.wake_hist[i];
+    }
 }
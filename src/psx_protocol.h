@@ -31,9 +31,14 @@
 void psx_protocol_init(void);
 
 // Core 1: Main protocol handler loop
-// Waits for SELECT LOW, then processes transaction
+// Waits for SELECT LOW on any port, then processes that port's transaction
 void psx_protocol_task(void);
 
+// Core 0: Ask Core 1 to stop between transactions with the bus released and
+// nothing half-published, before it is reset. Returns false on timeout
+// (Core 1 not running the protocol task).
+bool psx_protocol_park(uint32_t timeout_us);
+
 // Process a complete PSX transaction
 // Called when SELECT goes LOW
 // Returns true if transaction was for controller (0x01)
@@ -43,6 +48,37 @@ bool psx_process_transaction(uint8_t btn1, uint8_t btn2);
 // Called on SELECT rising edge to abort transaction
 void psx_sel_interrupt_handler(unsigned int gpio_num, uint32_t events);
 
+// Bus rules checked on every transaction (PSX_INVARIANT_CHECKS)
+typedef enum
+{
+    PSX_INVARIANT_NONE = 0,
+    PSX_INVARIANT_BUS_HELD,       // DAT or ACK still driven after SEL went HIGH
+    PSX_INVARIANT_MEMCARD_DRIVEN, // DAT or ACK driven during memory card traffic
+} psx_invariant_t;
+
+// Name of an invariant for debug output
+const char *psx_invariant_name(uint8_t invariant);
+
+// Sites where a transaction is abandoned, counted separately so marginal
+// ACK timing (aborts mid-poll) can be told apart from noise (address/command)
+typedef enum
+{
+    PSX_ERROR_FALSE_SELECT = 0, // SEL already HIGH again when Core 1 woke
+    PSX_ERROR_ADDRESS,          // Address byte timed out or was aborted
+    PSX_ERROR_ADDRESS_ACK,      // SEL rose during the ACK after the address
+    PSX_ERROR_COMMAND,          // Command byte timed out or was aborted
+    PSX_ERROR_AFTER_COMMAND,    // SEL rose right after the command byte
+    PSX_ERROR_POLL_BYTE3,       // Response aborted at byte 3 (poll: ID high)
+    PSX_ERROR_POLL_BYTE4,       // Response aborted at byte 4 (poll: buttons low)
+    PSX_ERROR_POLL_BYTE5,       // Response aborted at byte 5 or later (poll: buttons high)
+    PSX_ERROR_UNKNOWN_CMD,      // Command the addressed device does not answer
+    PSX_ERROR_UNKNOWN_ADDR,     // Address without an entry in the device table
+    PSX_ERROR_COUNT
+} psx_error_t;
+
+// Name of an error site for debug output
+const char *psx_error_name(uint8_t error);
+
 // Get transaction statistics for debugging
 typedef struct
 {
@@ -50,16 +86,41 @@ typedef struct
     uint64_t controller_transactions;
     uint64_t memcard_transactions;
     uint64_t invalid_transactions;
-    uint64_t timeout_errors;
+    uint64_t timeout_errors;          // Aborts with SEL still LOW (edge timeout, not the console)
+    uint64_t overlapped_transactions; // SEL asserted while the other port was being served
+    uint64_t invariant_violations;    // Bus rule broken (see psx_invariant_t)
+    uint8_t last_violation;           // psx_invariant_t of the most recent violation
     uint8_t last_invalid_addr; // Last invalid address received
     uint8_t last_invalid_cmd;  // Last invalid command received
     uint32_t min_interval_us;  // Minimum transaction interval (microseconds)
     uint32_t max_interval_us;  // Maximum transaction interval (microseconds)
     uint32_t avg_interval_us;  // Average transaction interval (microseconds)
+    uint32_t errors[PSX_ERROR_COUNT]; // Aborts by failure site (see psx_error_t)
 } psx_stats_t;
 
-void psx_get_stats(psx_stats_t *stats);
+// Statistics are kept per console port (0 = port 1).
+// Core 1 owns the counters and publishes a sequence-counted snapshot after
+// every transaction; these Core 0 functions read that snapshot (never torn)
+// and reset by recording a baseline instead of writing Core 1's data.
+void psx_get_stats(uint8_t port, psx_stats_t *stats);
 void psx_reset_stats(void);
 void psx_reset_interval_stats(void);
 
+// Core 1 idle statistics (PSX_IDLE_WFE), reset with the interval statistics.
+// As of the last published snapshot (end of the last transaction).
+#define PSX_WAKE_BUCKETS 5 // <250, <500, <1000, <2000, >=2000 ns
+
+typedef struct
+{
+    uint64_t idle_us;       // Time spent waiting for SEL
+    uint64_t elapsed_us;    // Time covered by these statistics
+    uint32_t wakeups;       // Wake-ups by a SEL falling edge
+    uint32_t spurious;      // Wake-ups by other events (SEL still HIGH)
+    uint32_t wake_min_ns;   // SEL IRQ entry to transaction start
+    uint32_t wake_max_ns;
+    uint32_t wake_hist[PSX_WAKE_BUCKETS];
+} psx_idle_stats_t;
+
+void psx_get_idle_stats(psx_idle_stats_t *stats);
+
 #endif // PSX_PROTOCOL_H
@@ -0,0 +1,139 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "sched.h"
+#include "pico/stdlib.h"
+#include <stddef.h>
+#include <stdio.h>
+
+// ============================================================================
+// Scheduler State
+// ============================================================================
+
+static sched_task_t *task_table = NULL;
+static uint8_t task_count = 0;
+
+// ============================================================================
+// Public Functions
+// ============================================================================
+
+void sched_init(sched_task_t *tasks, uint8_t count)
+{
+    uint32_t now = time_us_32();
+
+    task_table = tasks;
+    task_count = count;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        tasks[i].next_due = now;
+    }
+    sched_reset_stats();
+}
+
+void sched_run(void)
+{
+    uint32_t now = time_us_32();
+    sched_task_t *next = NULL;
+    sched_task_t *earliest = NULL;
+
+    for (uint8_t i = 0; i < task_count; i++)
+    {
+        sched_task_t *task = &task_table[i];
+
+        if (earliest == NULL || (int32_t)(task->next_due - earliest->next_due) < 0)
+        {
+            earliest = task;
+        }
+
+        if ((int32_t)(now - task->next_due) < 0)
+        {
+            continue; // Not due yet
+        }
+        if (next == NULL || task->priority < next->priority ||
+            (task->priority == next->priority && (int32_t)(task->next_due - next->next_due) < 0))
+        {
+            next = task;
+        }
+    }
+
+    if (next == NULL)
+    {
+        // Nothing due: sleep until the earliest deadline (any interrupt, e.g. USB, also wakes us)
+        if (earliest != NULL)
+        {
+            best_effort_wfe_or_timeout(make_timeout_time_us(earliest->next_due - now));
+        }
+        return;
+    }
+
+    uint32_t late = now - next->next_due;
+    next->run(now);
+    uint32_t end = time_us_32();
+    uint32_t exec = end - now;
+
+    next->runs++;
+    if (exec > next->budget_us)
+    {
+        next->overruns++;
+    }
+    if (exec > next->max_exec_us)
+    {
+        next->max_exec_us = exec;
+    }
+    if (late > next->max_late_us)
+    {
+        next->max_late_us = late;
+    }
+
+    // Fixed rate; periods that already passed are skipped rather than run back to back
+    next->next_due += next->period_us;
+    while ((int32_t)(end - next->next_due) >= 0)
+    {
+        next->next_due += next->period_us;
+        next->skipped++;
+    }
+}
+
+void sched_print_stats(void)
+{
+    printf("\nCore 0 tasks:\n");
+    printf("  %-8s %4s %9s %9s %9s %9s %9s %9s %9s\n",
+           "task", "prio", "period", "budget", "runs", "max exec", "overruns", "max late", "skipped");
+    for (uint8_t i = 0; i < task_count; i++)
+    {
+        const sched_task_t *task = &task_table[i];
+        printf("  %-8s %4u %7luus %7luus %9lu %7luus %9lu %7luus %9lu\n",
+               task->name, task->priority, task->period_us, task->budget_us, task->runs,
+               task->max_exec_us, task->overruns, task->max_late_us, task->skipped);
+    }
+    printf("\n");
+}
+
+void sched_reset_stats(void)
+{
+    for (uint8_t i = 0; i < task_count; i++)
+    {
+        sched_task_t *task = &task_table[i];
+
+        task->runs = 0;
+        task->overruns = 0;
+        task->skipped = 0;
+        task->max_exec_us = 0;
+        task->max_late_us = 0;
+    }
+}
@@ -0,0 +1,68 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SCHED_H
+#define SCHED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ============================================================================
+// Core 0 Deadline Scheduler
+// ============================================================================
+
+// Cooperative scheduler for the Core 0 main loop. Each task runs once per
+// period. Of the tasks that are due, the highest priority one runs first
+// (earliest deadline among equal priorities), one task per pass, so a slow
+// low-priority task delays a higher one by at most its own run time.
+// With nothing due, Core 0 sleeps (WFE) until an alarm at the next deadline.
+
+typedef struct
+{
+    const char *name;
+    void (*run)(uint32_t now); // Called with the time the run started
+    uint32_t period_us;
+    uint32_t budget_us; // Execution time allowed per run
+    uint8_t priority;   // 0 = highest
+
+    // Maintained by the scheduler
+    uint32_t next_due;
+    uint32_t runs;
+    uint32_t overruns;    // Runs that exceeded budget_us
+    uint32_t skipped;     // Whole periods missed while other tasks ran
+    uint32_t max_exec_us; // Longest run
+    uint32_t max_late_us; // Longest delay between deadline and start
+} sched_task_t;
+
+// Static task table entry
+#define SCHED_TASK(task_name, fn, period, budget, prio) \
+    {.name = (task_name), .run = (fn), .period_us = (period), .budget_us = (budget), .priority = (prio)}
+
+// Register the task table; every task is due immediately
+void sched_init(sched_task_t *tasks, uint8_t count);
+
+// Run the most urgent due task, or sleep until the next deadline
+void sched_run(void);
+
+// Print per-task run/overrun statistics
+void sched_print_stats(void);
+
+// Clear the statistics (deadlines are kept)
+void sched_reset_stats(void);
+
+#endif // SCHED_H
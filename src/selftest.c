@@ -0,0 +1,486 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "selftest.h"
+#include "config.h"
+#include "bench.h"
+#include "shared_state.h"
+#include "persona.h"
+#include "hardware/clocks.h"
+#include "hardware/gpio.h"
+#include "hardware/sync.h"
+#include "hardware/vreg.h"
+#include "pico/multicore.h"
+#include "pico/stdlib.h"
+#include <stdio.h>
+#include <string.h>
+
+// External Core1 entry point
+extern void core1_entry(void);
+extern void core1_stop(void);
+
+// ============================================================================
+// Test Pattern
+// ============================================================================
+
+// Button bytes published to Core 1 during the test (no opposite directions,
+// so SOCD resolution leaves them unchanged)
+#define TEST_BTN1 0x96 // SELECT, START, RIGHT, DOWN pressed
+#define TEST_BTN2 0x69 // R2, L1, TRIANGLE, SQUARE pressed
+
+static const uint8_t poll_request[PSX_DIGITAL_RESPONSE_LEN] = {
+    PSX_ADDR_CONTROLLER, PSX_CMD_POLL, 0x00, 0x00, 0x00};
+
+// DAT stays Hi-Z (pulled HIGH) during the address byte
+static const uint8_t poll_expected[PSX_DIGITAL_RESPONSE_LEN] = {
+    PSX_RESPONSE_IDLE, PSX_ID_DIGITAL_LO, PSX_ID_DIGITAL_HI, TEST_BTN1, TEST_BTN2};
+
+// The reports need the self-test pins, which port 2 uses in a two-port build
+#if PSX_PORT_COUNT == 1
+// Clock rates tried by a full run
+static const uint32_t sweep_khz[] = {125, 250, 500, 750, 1000, 1500, 2000, 3000};
+
+// System clocks tried by the latency sweep (kHz)
+static const uint32_t sweep_sys_khz[] = {125000, 150000, 200000, 250000};
+#endif
+
+// ============================================================================
+// Console Side (Core 0)
+// ============================================================================
+
+static uint32_t cycles_per_us = 125;
+static uint32_t half_period_cycles = 250;
+
+#if PSX_PORT_COUNT == 1
+static void pins_init(void)
+{
+    const uint outputs[] = {SELFTEST_PIN_SEL, SELFTEST_PIN_CLK, SELFTEST_PIN_CMD};
+    for (size_t i = 0; i < sizeof(outputs) / sizeof(outputs[0]); i++)
+    {
+        gpio_init(outputs[i]);
+        gpio_put(outputs[i], 1); // Bus idles HIGH
+        gpio_set_dir(outputs[i], GPIO_OUT);
+    }
+
+    // DAT and ACK are open-drain - the console side provides the pull-up
+    gpio_init(SELFTEST_PIN_DAT);
+    gpio_pull_up(SELFTEST_PIN_DAT);
+    gpio_init(SELFTEST_PIN_ACK);
+    gpio_pull_up(SELFTEST_PIN_ACK);
+}
+
+static void pins_release(void)
+{
+    // Weak pull-ups keep the jumpered bus idle without fighting a console
+    const uint outputs[] = {SELFTEST_PIN_SEL, SELFTEST_PIN_CLK, SELFTEST_PIN_CMD};
+    for (size_t i = 0; i < sizeof(outputs) / sizeof(outputs[0]); i++)
+    {
+        gpio_set_dir(outputs[i], GPIO_IN);
+        gpio_pull_up(outputs[i]);
+    }
+}
+#endif
+
+// One byte, LSB first: CMD changes before CLK falls, DAT is sampled as CLK rises.
+// Bits where DAT must change level also time the device's reaction to CLK falling.
+static uint8_t __not_in_flash_func(console_transfer)(uint8_t cmd, uint8_t expect, uint32_t *last_rise,
+                                                    selftest_result_t *result)
+{
+    uint8_t dat = 0;
+    bool level = true; // DAT idles Hi-Z between bytes
+
+    for (int bit = 0; bit < 8; bit++)
+    {
+        bool want = (expect >> bit) & 1;
+
+        gpio_put(SELFTEST_PIN_CMD, (cmd >> bit) & 1);
+        gpio_put(SELFTEST_PIN_CLK, 0);
+        uint32_t fall = bench_cycles_now();
+
+        if (want != level)
+        {
+            while (gpio_get(SELFTEST_PIN_DAT) != want)
+            {
+                if (bench_cycles_between(fall, bench_cycles_now()) >= half_period_cycles)
+                {
+                    break;
+                }
+            }
+            uint32_t latency = bench_cycles_between(fall, bench_cycles_now());
+            if (latency < half_period_cycles)
+            {
+                if (latency < result->dat_latency_min_ns)
+                {
+                    result->dat_latency_min_ns = latency;
+                }
+                if (latency > result->dat_latency_max_ns)
+                {
+                    result->dat_latency_max_ns = latency;
+                }
+            }
+            level = want;
+        }
+
+        while (bench_cycles_between(fall, bench_cycles_now()) < half_period_cycles)
+        {
+            // Rest of the LOW half period
+        }
+
+        gpio_put(SELFTEST_PIN_CLK, 1);
+        *last_rise = bench_cycles_now();
+        if (gpio_get(SELFTEST_PIN_DAT))
+        {
+            dat |= (uint8_t)(1u << bit);
+        }
+        busy_wait_at_least_cycles(half_period_cycles);
+    }
+
+    gpio_put(SELFTEST_PIN_CMD, 1);
+    return dat;
+}
+
+// Returns false if no ACK falling edge came within SELFTEST_ACK_TIMEOUT_US
+static bool __not_in_flash_func(wait_ack)(uint32_t from, uint32_t *delay, uint32_t *width)
+{
+    uint32_t timeout = SELFTEST_ACK_TIMEOUT_US * cycles_per_us;
+
+    while (gpio_get(SELFTEST_PIN_ACK))
+    {
+        if (bench_cycles_between(from, bench_cycles_now()) > timeout)
+        {
+            return false;
+        }
+    }
+    uint32_t fall = bench_cycles_now();
+
+    while (!gpio_get(SELFTEST_PIN_ACK))
+    {
+        if (bench_cycles_between(fall, bench_cycles_now()) > timeout)
+        {
+            break;
+        }
+    }
+    uint32_t rise = bench_cycles_now();
+
+    *delay = bench_cycles_between(from, fall);
+    *width = bench_cycles_between(fall, rise);
+    return true;
+}
+
+// Send one 0x42 poll; ACK timings in cycles are folded into the result
+static bool __not_in_flash_func(run_poll)(selftest_result_t *result)
+{
+    bool ok = true;
+    uint32_t ints = save_and_disable_interrupts();
+
+    gpio_put(SELFTEST_PIN_SEL, 0);
+    busy_wait_us_32(SELFTEST_BYTE_GAP_US);
+
+    for (int i = 0; i < PSX_DIGITAL_RESPONSE_LEN; i++)
+    {
+        uint32_t rise = 0;
+        uint32_t delay, width;
+
+        if (console_transfer(poll_request[i], poll_expected[i], &rise, result) != poll_expected[i])
+        {
+            result->byte_errors++;
+            ok = false;
+        }
+
+        bool ack = wait_ack(rise, &delay, &width);
+        if (i == PSX_DIGITAL_RESPONSE_LEN - 1)
+        {
+            // The device must stay silent after the last byte
+            if (ack)
+            {
+                result->ack_after_last++;
+                ok = false;
+            }
+            break;
+        }
+
+        if (!ack)
+        {
+            // Without an ACK a real console ends the transaction here
+            result->ack_missing++;
+            ok = false;
+            break;
+        }
+
+        if (delay < result->ack_delay_min_ns)
+        {
+            result->ack_delay_min_ns = delay;
+        }
+        if (delay > result->ack_delay_max_ns)
+        {
+            result->ack_delay_max_ns = delay;
+        }
+        if (width < result->ack_width_min_ns)
+        {
+            result->ack_width_min_ns = width;
+        }
+        if (width > result->ack_width_max_ns)
+        {
+            result->ack_width_max_ns = width;
+        }
+
+        busy_wait_us_32(SELFTEST_BYTE_GAP_US);
+    }
+
+    gpio_put(SELFTEST_PIN_SEL, 1);
+    restore_interrupts(ints);
+    return ok;
+}
+
+static uint32_t cycles_to_ns(uint32_t cycles)
+{
+    return cycles == UINT32_MAX ? 0 : (uint32_t)((uint64_t)cycles * 1000 / cycles_per_us);
+}
+
+// ============================================================================
+// Public Functions
+// ============================================================================
+
+bool selftest_check_wiring(void)
+{
+    // Console outputs -> bus inputs (SEL last: pulling it LOW wakes Core 1,
+    // which drops the 1µs pulse as a false trigger)
+    static const struct
+    {
+        uint8_t from;
+        uint8_t to;
+        const char *name;
+    } inputs[] = {
+        {SELFTEST_PIN_CLK, PIN_CLK, "CLK"},
+        {SELFTEST_PIN_CMD, PIN_CMD, "CMD"},
+        {SELFTEST_PIN_SEL, PIN_SEL, "SEL"},
+    };
+
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++)
+    {
+        gpio_put(inputs[i].from, 0);
+        busy_wait_us_32(1);
+        bool low = !gpio_get(inputs[i].to);
+        gpio_put(inputs[i].from, 1);
+        busy_wait_us_32(1);
+        bool high = gpio_get(inputs[i].to);
+
+        if (!low || !high)
+        {
+            printf("\n>>> No connection: GPIO %u -> GPIO %u (%s)\n\n", inputs[i].from, inputs[i].to, inputs[i].name);
+            return false;
+        }
+    }
+
+    // Bus outputs -> console inputs: drive the open-drain lines from here
+    // while Core 1 is idle waiting for SEL
+    static const struct
+    {
+        uint8_t from;
+        uint8_t to;
+        const char *name;
+    } outputs[] = {
+        {PIN_DAT, SELFTEST_PIN_DAT, "DAT"},
+        {PIN_ACK, SELFTEST_PIN_ACK, "ACK"},
+    };
+
+    for (size_t i = 0; i < sizeof(outputs) / sizeof(outputs[0]); i++)
+    {
+        gpio_put(outputs[i].from, 0);
+        gpio_set_dir(outputs[i].from, GPIO_OUT);
+        busy_wait_us_32(1);
+        bool low = !gpio_get(outputs[i].to);
+        gpio_set_dir(outputs[i].from, GPIO_IN);
+        busy_wait_us_32(10); // Internal pull-up only
+        bool high = gpio_get(outputs[i].to);
+
+        if (!low || !high)
+        {
+            printf("\n>>> No connection: GPIO %u -> GPIO %u (%s)\n\n", outputs[i].from, outputs[i].to, outputs[i].name);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void selftest_run(uint32_t clock_khz, selftest_result_t *result)
+{
+    uint32_t clk_hz = clock_get_hz(clk_sys);
+    cycles_per_us = clk_hz / 1000000;
+    half_period_cycles = clk_hz / (2 * clock_khz * 1000);
+
+    memset(result, 0, sizeof(*result));
+    result->clock_khz = clock_khz;
+    result->ack_delay_min_ns = UINT32_MAX;
+    result->ack_width_min_ns = UINT32_MAX;
+    result->dat_latency_min_ns = UINT32_MAX;
+
+    bench_cycles_start();
+
+    // The expected response is the digital pad's
+    persona_id_t persona = persona_get(0);
+    persona_set(0, PERSONA_DIGITAL);
+
+    // Known button state so the response can be checked; one untimed poll
+    // first clears anything latched before the test
+    selftest_result_t warmup = *result;
+    shared_state_write(0, TEST_BTN1, TEST_BTN2);
+    run_poll(&warmup);
+    sleep_us(200);
+
+    for (int n = 0; n < SELFTEST_TRANSACTIONS; n++)
+    {
+        shared_state_write(0, TEST_BTN1, TEST_BTN2);
+        if (run_poll(result))
+        {
+            result->passed++;
+        }
+        result->transactions++;
+
+        // Let Core 1 finish and return to waiting for SEL
+        sleep_us(200);
+    }
+
+    bench_cycles_stop();
+    persona_set(0, persona);
+
+    // Min/max were collected in cycles
+    result->ack_delay_min_ns = cycles_to_ns(result->ack_delay_min_ns);
+    result->ack_delay_max_ns = cycles_to_ns(result->ack_delay_max_ns);
+    result->ack_width_min_ns = cycles_to_ns(result->ack_width_min_ns);
+    result->ack_width_max_ns = cycles_to_ns(result->ack_width_max_ns);
+    result->dat_latency_min_ns = cycles_to_ns(result->dat_latency_min_ns);
+    result->dat_latency_max_ns = cycles_to_ns(result->dat_latency_max_ns);
+}
+
+void selftest_report(uint32_t clock_khz)
+{
+#if PSX_PORT_COUNT > 1
+    (void)clock_khz;
+    printf("\n>>> Self-test unavailable: its pins are used by port 2\n\n");
+#else
+    pins_init();
+
+    if (!selftest_check_wiring())
+    {
+        pins_release();
+        return;
+    }
+
+    printf("\nLoopback self-test (%d polls per rate):\n", SELFTEST_TRANSACTIONS);
+
+    uint32_t max_passing_khz = 0;
+    size_t rate_count = clock_khz ? 1 : sizeof(sweep_khz) / sizeof(sweep_khz[0]);
+    for (size_t i = 0; i < rate_count; i++)
+    {
+        selftest_result_t result;
+        selftest_run(clock_khz ? clock_khz : sweep_khz[i], &result);
+
+        printf("  %4lu kHz: %lu/%lu passed, byte errors %lu, ACK missing %lu, ACK after last %lu",
+               result.clock_khz, result.passed, result.transactions,
+               result.byte_errors, result.ack_missing, result.ack_after_last);
+        if (result.ack_delay_max_ns > 0)
+        {
+            printf(", ACK delay %lu-%lu ns, width %lu-%lu ns",
+                   result.ack_delay_min_ns, result.ack_delay_max_ns,
+                   result.ack_width_min_ns, result.ack_width_max_ns);
+        }
+        if (result.dat_latency_max_ns > 0)
+        {
+            printf(", DAT latency %lu-%lu ns", result.dat_latency_min_ns, result.dat_latency_max_ns);
+        }
+        printf("\n");
+
+        if (result.passed == result.transactions && result.clock_khz > max_passing_khz)
+        {
+            max_passing_khz = result.clock_khz;
+        }
+    }
+
+    pins_release();
+
+    if (max_passing_khz > 0)
+    {
+        printf("  Highest fully passing clock: %lu kHz\n\n", max_passing_khz);
+    }
+    else
+    {
+        printf("  No clock rate passed\n\n");
+    }
+#endif
+}
+
+#if PSX_PORT_COUNT == 1
+// Core 1 converts its timings (SEL settle, wake latency) to cycles of clk_sys
+// once at start: stop it across the change and start it again at the new clock
+static bool set_sweep_clock(uint32_t khz, bool required)
+{
+    core1_stop();
+    bool ok = set_sys_clock_khz(khz, required);
+    multicore_launch_core1(core1_entry);
+    return ok;
+}
+#endif
+
+void selftest_clock_report(void)
+{
+#if PSX_PORT_COUNT > 1
+    printf("\n>>> Self-test unavailable: its pins are used by port 2\n\n");
+#else
+    pins_init();
+
+    if (!selftest_check_wiring())
+    {
+        pins_release();
+        return;
+    }
+
+    printf("\nSystem clock sweep (%d polls at %d kHz per clock):\n", SELFTEST_TRANSACTIONS, SELFTEST_SYSCLK_BUS_KHZ);
+
+    // Highest voltage first, so every step of the sweep is covered
+    vreg_set_voltage(SYS_CLOCK_VREG_VOLTAGE);
+    sleep_ms(10);
+
+    for (size_t i = 0; i < sizeof(sweep_sys_khz) / sizeof(sweep_sys_khz[0]); i++)
+    {
+        if (!set_sweep_clock(sweep_sys_khz[i], false))
+        {
+            printf("  %3lu MHz: not reachable with the PLL\n", sweep_sys_khz[i] / 1000);
+            continue;
+        }
+        sleep_ms(10);
+
+        selftest_result_t result;
+        selftest_run(SELFTEST_SYSCLK_BUS_KHZ, &result);
+
+        printf("  %3lu MHz: %lu/%lu passed, DAT latency %lu-%lu ns, ACK delay %lu-%lu ns\n",
+               sweep_sys_khz[i] / 1000, result.passed, result.transactions,
+               result.dat_latency_min_ns, result.dat_latency_max_ns,
+               result.ack_delay_min_ns, result.ack_delay_max_ns);
+    }
+
+    set_sweep_clock(SYS_CLOCK_KHZ, true);
+#if SYS_CLOCK_KHZ <= 133000
+    vreg_set_voltage(VREG_VOLTAGE_DEFAULT);
+#endif
+
+    pins_release();
+    printf("  Restored %lu MHz (SYS_CLOCK_KHZ)\n\n", clock_get_hz(clk_sys) / 1000000);
+#endif
+}
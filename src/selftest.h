@@ -0,0 +1,72 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SELFTEST_H
+#define SELFTEST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ============================================================================
+// Loopback Self-Test
+// ============================================================================
+
+// For board bring-up without a console: Core 0 bit-bangs the console side
+// of the bus on the SELFTEST_PIN_* spare pins (jumpered to the port 1 bus
+// pins) while Core 1 answers as usual. Each run sends 0x42 polls at a fixed
+// clock rate and checks the response bytes and ACK placement.
+
+#define SELFTEST_TRANSACTIONS 100   // Polls per clock rate
+#define SELFTEST_ACK_TIMEOUT_US 100 // No ACK within this time = missing
+#define SELFTEST_BYTE_GAP_US 8      // Idle time after ACK before the next byte
+#define SELFTEST_SYSCLK_BUS_KHZ 500 // Bus clock used by the system clock sweep (PS2 speed)
+#define SELFTEST_CLOCK_KHZ_MAX 4000 // Highest single bus clock accepted by selftest_report()
+
+typedef struct
+{
+    uint32_t clock_khz;        // Bus clock used
+    uint32_t transactions;     // Polls sent
+    uint32_t passed;           // Polls with correct bytes and ACKs
+    uint32_t byte_errors;      // Response bytes that did not match
+    uint32_t ack_missing;      // Expected ACKs that never came
+    uint32_t ack_after_last;   // ACK seen after the last byte
+    uint32_t ack_delay_min_ns; // Last CLK rising edge to ACK falling edge
+    uint32_t ack_delay_max_ns;
+    uint32_t ack_width_min_ns; // ACK LOW time
+    uint32_t ack_width_max_ns;
+    uint32_t dat_latency_min_ns; // CLK falling edge to DAT change (bits that change level)
+    uint32_t dat_latency_max_ns;
+} selftest_result_t;
+
+// Core 0: Check the jumpers between the self-test pins and the bus pins
+// Prints the first broken connection and returns false if one is found
+bool selftest_check_wiring(void);
+
+// Core 0: Run SELFTEST_TRANSACTIONS polls at the given bus clock
+void selftest_run(uint32_t clock_khz, selftest_result_t *result);
+
+// Core 0: Wiring check, then one run per clock rate (or all rates if
+// clock_khz is 0) with the results and the highest fully passing rate
+void selftest_report(uint32_t clock_khz);
+
+// Core 0: Wiring check, then one run at SELFTEST_SYSCLK_BUS_KHZ per system
+// clock (125-250MHz) with the edge-to-DAT latency of each. SYS_CLOCK_KHZ is
+// restored afterwards. Only USB stdio is reliable while the clock changes.
+void selftest_clock_report(void);
+
+#endif // SELFTEST_H
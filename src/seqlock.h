@@ -0,0 +1,75 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hardware/sync.h"
+
+// ============================================================================
+// Sequence Lock (one writer core, readers on the other)
+// ============================================================================
+
+// The writer makes the sequence odd while it updates the data; a reader
+// copies the data and retries until it saw the same even value before and
+// after. The writer never waits.
+//
+//   writer:  seqlock_write_begin(&seq); ...update...; seqlock_write_end(&seq);
+//   reader:  do { start = seqlock_read_begin(&seq); ...copy...; }
+//            while (seqlock_read_retry(&seq, start));
+
+static inline void seqlock_write_begin(volatile uint32_t *seq)
+{
+    // |= rather than ++: stays odd if a reset left it odd
+    *seq |= 1u;
+    __dmb();
+}
+
+static inline void seqlock_write_end(volatile uint32_t *seq)
+{
+    __dmb();
+    *seq += 1u;
+}
+
+static inline uint32_t seqlock_read_begin(const volatile uint32_t *seq)
+{
+    uint32_t start = *seq;
+    __dmb();
+    return start;
+}
+
+static inline bool seqlock_read_retry(const volatile uint32_t *seq, uint32_t start)
+{
+    __dmb();
+    return (start & 1u) || start != *seq;
+}
+
+// Writer side at (re)start: a writer core reset half-way through an update
+// leaves the sequence odd and readers would spin until the next update.
+// Make it even again; the data may be torn until then.
+static inline void seqlock_recover(volatile uint32_t *seq)
+{
+    if (*seq & 1u)
+    {
+        *seq += 1u;
+    }
+}
+
+#endif // SEQLOCK_H
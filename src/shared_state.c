@@ -18,6 +18,7 @@
 
 #include "shared_state.h"
 #include "config.h"
+#include "socd.h"
 #include "pico/stdlib.h"
 #include "hardware/sync.h"
 
@@ -25,11 +26,11 @@
 // Global Shared State
 // ============================================================================
 
-shared_controller_state_t g_shared_state;
+shared_controller_state_t g_shared_state[PSX_PORT_COUNT];
 
-// Latching mode: Store accumulated button presses (used when latching_mode is ON)
-static uint8_t latched_btn1 = 0xFF;
-static uint8_t latched_btn2 = 0xFF;
+// Latching mode: Store accumulated button presses per port (used when latching_mode is ON)
+static uint8_t latched_btn1[PSX_PORT_COUNT];
+static uint8_t latched_btn2[PSX_PORT_COUNT];
 
 // External runtime configuration
 extern bool latching_mode;
@@ -40,94 +41,84 @@ extern bool latching_mode;
 
 void shared_state_init(void)
 {
-    // Initialize both buffers with idle state (all buttons released = 0xFF)
-    for (int i = 0; i < 2; i++)
+    for (int port = 0; port < PSX_PORT_COUNT; port++)
     {
-        g_shared_state.buffer[i].buttons1 = 0xFF;
-        g_shared_state.buffer[i].buttons2 = 0xFF;
-    }
+        shared_controller_state_t *state = &g_shared_state[port];
+
+        // Initialize both buffers with idle state (all buttons released = 0xFF)
+        for (int i = 0; i < 2; i++)
+        {
+            state->buffer[i].buttons1 = 0xFF;
+            state->buffer[i].buttons2 = 0xFF;
+        }
 
-    // Initialize indices
-    g_shared_state.write_index = 0;
-    g_shared_state.read_index = 0;
+        // Initialize indices
+        state->write_index = 0;
+        state->read_index = 0;
+
+        latched_btn1[port] = 0xFF;
+        latched_btn2[port] = 0xFF;
+    }
 }
 
-void shared_state_write(uint8_t btn1, uint8_t btn2)
+void shared_state_write(uint8_t port, uint8_t btn1, uint8_t btn2)
 {
-    uint32_t write_idx = 1 - g_shared_state.read_index;
-    
+    shared_controller_state_t *state = &g_shared_state[port];
+    uint32_t write_idx = 1 - state->read_index;
+
     if (latching_mode)
     {
         // Latching mode: Accumulate button presses (0 = pressed)
         // Once a button is pressed (bit = 0), keep it pressed until PSX reads it
-        latched_btn1 &= btn1; // Bitwise AND - keeps 0s (pressed buttons)
-        latched_btn2 &= btn2;
+        latched_btn1[port] &= btn1; // Bitwise AND - keeps 0s (pressed buttons)
+        latched_btn2[port] &= btn2;
+
+        // Opposite directions latched from different samples are resolved here
+        // so Core 1 never has to run the SOCD cleaner (physical pad only)
+        if (port == 0)
+        {
+            latched_btn1[port] = socd_resolve_latched(latched_btn1[port], btn1);
+        }
 
         // Write latched state to buffer
-        g_shared_state.buffer[write_idx].buttons1 = latched_btn1;
-        g_shared_state.buffer[write_idx].buttons2 = latched_btn2;
+        state->buffer[write_idx].buttons1 = latched_btn1[port];
+        state->buffer[write_idx].buttons2 = latched_btn2[port];
     }
     else
     {
         // Direct mode: Write current button state directly
-        g_shared_state.buffer[write_idx].buttons1 = btn1;
-        g_shared_state.buffer[write_idx].buttons2 = btn2;
+        state->buffer[write_idx].buttons1 = btn1;
+        state->buffer[write_idx].buttons2 = btn2;
     }
 
     // Memory barrier to ensure writes complete before index update
     __dmb();
 
     // Switch to new buffer
-    g_shared_state.write_index = write_idx;
+    state->write_index = write_idx;
 }
 
-void shared_state_read(uint8_t *btn1, uint8_t *btn2)
+void shared_state_read(uint8_t port, uint8_t *btn1, uint8_t *btn2)
 {
+    shared_controller_state_t *state = &g_shared_state[port];
+
     // Read from the latest complete buffer
-    uint32_t read_idx = g_shared_state.write_index;
+    uint32_t read_idx = state->write_index;
 
     // Update read index
-    g_shared_state.read_index = read_idx;
+    state->read_index = read_idx;
 
     // Memory barrier to ensure index is read before data
     __dmb();
 
     // Read button state
-    *btn1 = g_shared_state.buffer[read_idx].buttons1;
-    *btn2 = g_shared_state.buffer[read_idx].buttons2;
+    *btn1 = state->buffer[read_idx].buttons1;
+    *btn2 = state->buffer[read_idx].buttons2;
 
     if (latching_mode)
     {
         // Clear latched state after PSX reads it
-        latched_btn1 = 0xFF;
-        latched_btn2 = 0xFF;
-    }
-
-    // ========================================================================
-    // SOCD (Simultaneous Opposite Cardinal Direction) Cleaner - HitBox style
-    // ========================================================================
-    // Button mapping in btn1:
-    // Bit 4: UP (0 = pressed)
-    // Bit 5: RIGHT (0 = pressed)
-    // Bit 6: DOWN (0 = pressed)
-    // Bit 7: LEFT (0 = pressed)
-
-    bool up_pressed = !(*btn1 & 0x10);
-    bool right_pressed = !(*btn1 & 0x20);
-    bool down_pressed = !(*btn1 & 0x40);
-    bool left_pressed = !(*btn1 & 0x80);
-
-    // Left + Right = Neutral (both released)
-    if (left_pressed && right_pressed)
-    {
-        *btn1 |= 0x80; // Release LEFT
-        *btn1 |= 0x20; // Release RIGHT
-    }
-
-    // Up + Down = Neutral (both released)
-    if (up_pressed && down_pressed)
-    {
-        *btn1 |= 0x10; // Release UP
-        *btn1 |= 0x40; // Release DOWN
+        latched_btn1[port] = 0xFF;
+        latched_btn2[port] = 0xFF;
     }
 }
@@ -20,6 +20,7 @@
 #define SHARED_STATE_H
 
 #include <stdint.h>
+#include "config.h"
 
 // ============================================================================
 // Shared State Structure for Inter-Core Communication
@@ -44,7 +45,8 @@ typedef struct
 // Global Shared State
 // ============================================================================
 
-extern shared_controller_state_t g_shared_state;
+// One instance per console port
+extern shared_controller_state_t g_shared_state[PSX_PORT_COUNT];
 
 // ============================================================================
 // Function Prototypes
@@ -53,10 +55,10 @@ extern shared_controller_state_t g_shared_state;
 // Initialize shared state
 void shared_state_init(void);
 
-// Core 0: Write new button state
-void shared_state_write(uint8_t btn1, uint8_t btn2);
+// Core 0: Write new button state for a port (already SOCD-resolved)
+void shared_state_write(uint8_t port, uint8_t btn1, uint8_t btn2);
 
-// Core 1: Read stable button state
-void shared_state_read(uint8_t *btn1, uint8_t *btn2);
+// Core 1: Read stable button state of a port
+void shared_state_read(uint8_t port, uint8_t *btn1, uint8_t *btn2);
 
 #endif // SHARED_STATE_H
@@ -0,0 +1,296 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "sniffer.h"
+#include "config.h"
+#include "psx_bitbang.h"
+#include "host_link.h"
+#include "hardware/pio.h"
+#include "hardware/pio_instructions.h"
+#include "hardware/gpio.h"
+#include "hardware/sync.h"
+#include "pico/multicore.h"
+#include "pico/stdlib.h"
+
+// ============================================================================
+// Capture State Machines
+// ============================================================================
+
+// Program (pins are patched in at run time from config.h):
+//   0: wait 0 gpio SEL      ; transaction active
+//   1: set x, 7
+//   2: wait 0 gpio CLK
+//   3: wait 1 gpio CLK      ; sample point
+//   4: in pins, 1           ; autopush after 8 bits
+//   5: jmp x-- 2
+//      (wrap to 0)
+#define CAPTURE_PROGRAM_LEN 6
+
+static uint16_t capture_instructions[CAPTURE_PROGRAM_LEN];
+static PIO capture_pio = pio0;
+static uint capture_offset = 0;
+static uint sm_cmd = 0;
+static uint sm_dat = 1;
+
+// ============================================================================
+// Record Ring (single producer Core 1, single consumer Core 0)
+// ============================================================================
+
+static sniffer_record_t ring[SNIFFER_RING_SIZE];
+static volatile uint32_t ring_head = 0; // Written by Core 1
+static volatile uint32_t ring_tail = 0; // Written by Core 0
+
+// Counters owned by Core 1
+static volatile uint32_t record_count = 0;
+static volatile uint32_t transaction_count = 0;
+static volatile uint32_t dropped_count = 0;
+
+static volatile bool sniffer_enabled = false;
+
+// External Core1 entry point
+extern void core1_entry(void);
+extern void core1_stop(void);
+
+// ============================================================================
+// Core 1 Functions
+// ============================================================================
+
+static void capture_init(void)
+{
+    capture_instructions[0] = pio_encode_wait_gpio(false, PIN_SEL);
+    capture_instructions[1] = pio_encode_set(pio_x, 7);
+    capture_instructions[2] = pio_encode_wait_gpio(false, PIN_CLK);
+    capture_instructions[3] = pio_encode_wait_gpio(true, PIN_CLK);
+    capture_instructions[4] = pio_encode_in(pio_pins, 1);
+    capture_instructions[5] = pio_encode_jmp_x_dec(2); // Relocated by pio_add_program
+
+    static const pio_program_t program = {
+        .instructions = capture_instructions,
+        .length = CAPTURE_PROGRAM_LEN,
+        .origin = -1,
+    };
+
+    // Core 1 may have been reset with the program still loaded
+    pio_clear_instruction_memory(capture_pio);
+    capture_offset = pio_add_program(capture_pio, &program);
+
+    const uint pins[2] = {PIN_CMD, PIN_DAT};
+    const uint sms[2] = {sm_cmd, sm_dat};
+    for (int i = 0; i < 2; i++)
+    {
+        pio_sm_config c = pio_get_default_sm_config();
+        sm_config_set_wrap(&c, capture_offset, capture_offset + CAPTURE_PROGRAM_LEN - 1);
+        sm_config_set_in_pins(&c, pins[i]);
+        sm_config_set_in_shift(&c, true, true, 8); // LSB first, autopush each byte
+        sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_RX);
+        pio_sm_init(capture_pio, sms[i], capture_offset, &c);
+    }
+
+    // Both machines see the same CLK edges only if they start together
+    pio_set_sm_mask_enabled(capture_pio, (1u << sm_cmd) | (1u << sm_dat), true);
+}
+
+// Drop a partial byte left by an aborted transaction
+static void capture_restart(void)
+{
+    uint32_t mask = (1u << sm_cmd) | (1u << sm_dat);
+
+    pio_set_sm_mask_enabled(capture_pio, mask, false);
+    pio_restart_sm_mask(capture_pio, mask);
+    pio_sm_exec(capture_pio, sm_cmd, pio_encode_jmp(capture_offset));
+    pio_sm_exec(capture_pio, sm_dat, pio_encode_jmp(capture_offset));
+    pio_set_sm_mask_enabled(capture_pio, mask, true);
+}
+
+static void __time_critical_func(ring_commit)(const sniffer_record_t *record)
+{
+    static bool overflowed = false;
+    uint32_t head = ring_head;
+
+    if (head - ring_tail >= SNIFFER_RING_SIZE)
+    {
+        dropped_count++;
+        overflowed = true;
+        return;
+    }
+
+    ring[head & (SNIFFER_RING_SIZE - 1)] = *record;
+    if (overflowed)
+    {
+        ring[head & (SNIFFER_RING_SIZE - 1)].flags |= SNIFFER_FLAG_OVERFLOW;
+        overflowed = false;
+    }
+
+    // Record must be complete before Core 0 can see it
+    __dmb();
+    ring_head = head + 1;
+    record_count++;
+}
+
+void __time_critical_func(sniffer_task)(void)
+{
+    // All bus pins as Hi-Z inputs - the sniffer never drives the bus
+    psx_bitbang_init();
+    capture_init();
+
+    sniffer_record_t current = {0};
+    bool pending = false;  // current holds a byte still waiting for its ACK
+    bool selected = false; // SEL is LOW
+    bool first_byte = false;
+
+    while (1)
+    {
+        // Complete byte on both lines
+        if (!pio_sm_is_rx_fifo_empty(capture_pio, sm_cmd) && !pio_sm_is_rx_fifo_empty(capture_pio, sm_dat))
+        {
+            uint32_t now = time_us_32();
+            if (pending)
+            {
+                ring_commit(&current);
+            }
+
+            // Shift-right ISR: the byte is in the top 8 bits
+            current.time_us = now;
+            current.cmd = (uint8_t)(pio_sm_get(capture_pio, sm_cmd) >> 24);
+            current.dat = (uint8_t)(pio_sm_get(capture_pio, sm_dat) >> 24);
+            current.ack_delay = 0;
+            current.flags = first_byte ? SNIFFER_FLAG_START : 0;
+            if (first_byte)
+            {
+                transaction_count++;
+                first_byte = false;
+            }
+            pending = true;
+            continue;
+        }
+
+        // First ACK falling edge after the byte
+        if (pending && !(current.flags & SNIFFER_FLAG_ACK) && !gpio_get(PIN_ACK))
+        {
+            uint32_t delay = time_us_32() - current.time_us;
+            current.ack_delay = delay > 255 ? 255 : (uint8_t)delay;
+            current.flags |= SNIFFER_FLAG_ACK;
+        }
+
+        bool sel_low = !gpio_get(PIN_SEL);
+        if (sel_low && !selected)
+        {
+            selected = true;
+            first_byte = true;
+        }
+        else if (!sel_low && selected &&
+                 pio_sm_is_rx_fifo_empty(capture_pio, sm_cmd) && pio_sm_is_rx_fifo_empty(capture_pio, sm_dat))
+        {
+            // Transaction over and all of its bytes collected
+            selected = false;
+            if (pending)
+            {
+                ring_commit(&current);
+                pending = false;
+            }
+            capture_restart();
+        }
+    }
+}
+
+// ============================================================================
+// Core 0 Functions
+// ============================================================================
+
+void sniffer_set_enabled(bool enabled)
+{
+    if (enabled == sniffer_enabled)
+    {
+        return;
+    }
+
+    // Core1 runs either the controller emulation or the capture loop
+    core1_stop();
+
+    // A reset in the middle of a response may leave DAT/ACK driven LOW
+    for (uint8_t port = 0; port < PSX_PORT_COUNT; port++)
+    {
+        gpio_set_dir(psx_port_pins[port].dat, GPIO_IN);
+        gpio_set_dir(psx_port_pins[port].ack, GPIO_IN);
+    }
+
+    if (!enabled)
+    {
+        // Controller emulation does not use the PIO
+        pio_set_sm_mask_enabled(capture_pio, (1u << sm_cmd) | (1u << sm_dat), false);
+    }
+
+    ring_head = 0;
+    ring_tail = 0;
+    sniffer_enabled = enabled;
+
+    multicore_launch_core1(core1_entry);
+}
+
+bool sniffer_is_enabled(void)
+{
+    return sniffer_enabled;
+}
+
+void sniffer_stream_task(void)
+{
+    uint32_t tail = ring_tail;
+    uint32_t available = ring_head - tail;
+
+    if (available == 0)
+    {
+        return;
+    }
+    if (available > SNIFFER_FRAME_RECORDS)
+    {
+        available = SNIFFER_FRAME_RECORDS;
+    }
+
+    // Records must be read after their head update
+    __dmb();
+
+    uint8_t payload[SNIFFER_FRAME_RECORDS * 8];
+    uint8_t *p = payload;
+    for (uint32_t i = 0; i < available; i++)
+    {
+        const sniffer_record_t *record = &ring[(tail + i) & (SNIFFER_RING_SIZE - 1)];
+        p[0] = (uint8_t)record->time_us;
+        p[1] = (uint8_t)(record->time_us >> 8);
+        p[2] = (uint8_t)(record->time_us >> 16);
+        p[3] = (uint8_t)(record->time_us >> 24);
+        p[4] = record->cmd;
+        p[5] = record->dat;
+        p[6] = record->ack_delay;
+        p[7] = record->flags;
+        p += 8;
+    }
+
+    // Slots may be reused only after they were copied
+    __dmb();
+    ring_tail = tail + available;
+
+    host_link_send(HOST_FRAME_SNIFF, payload, (uint8_t)(available * 8));
+}
+
+void sniffer_get_stats(sniffer_stats_t *stats)
+{
+    stats->records = record_count;
+    stats->transactions = transaction_count;
+    stats->dropped = dropped_count;
+    stats->buffered = ring_head - ring_tail;
+}
@@ -0,0 +1,81 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SNIFFER_H
+#define SNIFFER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ============================================================================
+// Passive Bus Sniffer
+// ============================================================================
+
+// Listen-only mode: Core 1 stops emulating the controller and records the
+// traffic between the console and whatever device is on the port 1 pins
+// (official pad, memory card). DAT and ACK are never driven.
+//
+// Two PIO state machines shift in CMD and DAT on every CLK rising edge and
+// autopush one byte each, so capture keeps up with back-to-back 500kHz
+// transfers. Core 1 only timestamps completed bytes, measures the ACK delay
+// and resynchronises the state machines when SEL goes HIGH.
+//
+// Records go into a RAM ring (Core 1 -> Core 0) and are streamed to the host
+// as HOST_FRAME_SNIFF frames; tools/psx_sniff.py decodes them into
+// per-transaction records.
+
+#define SNIFFER_RING_SIZE 4096  // Records (8 bytes each), must be a power of 2
+#define SNIFFER_FRAME_RECORDS 8 // Records per host frame
+
+// Record flags
+#define SNIFFER_FLAG_START 0x01    // First byte after SEL went LOW
+#define SNIFFER_FLAG_ACK 0x02      // ACK pulse seen after this byte (ack_delay valid)
+#define SNIFFER_FLAG_OVERFLOW 0x04 // Records were dropped just before this one
+
+typedef struct
+{
+    uint32_t time_us;  // time_us_32() when the byte completed
+    uint8_t cmd;       // Console -> device
+    uint8_t dat;       // Device -> console
+    uint8_t ack_delay; // µs from byte end to ACK falling edge (saturates at 255)
+    uint8_t flags;     // SNIFFER_FLAG_*
+} sniffer_record_t;
+
+typedef struct
+{
+    uint32_t records;      // Bytes captured
+    uint32_t transactions; // SEL LOW periods with at least one byte
+    uint32_t dropped;      // Records lost because the ring was full
+    uint32_t buffered;     // Records waiting to be streamed
+} sniffer_stats_t;
+
+// Core 0: Switch Core 1 between controller emulation and sniffing
+// Core 1 is restarted; the bus is released before capture starts
+void sniffer_set_enabled(bool enabled);
+bool sniffer_is_enabled(void);
+
+// Core 1: Capture loop (never returns)
+void sniffer_task(void);
+
+// Core 0: Send one frame of buffered records to the host (if any)
+void sniffer_stream_task(void);
+
+// Get capture statistics
+void sniffer_get_stats(sniffer_stats_t *stats);
+
+#endif // SNIFFER_H
@@ -0,0 +1,200 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "socd.h"
+#include "config.h"
+#include <string.h>
+
+// ============================================================================
+// Direction Bits (PSX byte 1, 0 = pressed)
+// ============================================================================
+
+#define DIR_UP 0x10
+#define DIR_RIGHT 0x20
+#define DIR_DOWN 0x40
+#define DIR_LEFT 0x80
+#define DIR_MASK (DIR_UP | DIR_RIGHT | DIR_DOWN | DIR_LEFT)
+
+// ============================================================================
+// SOCD State (Core 0 only)
+// ============================================================================
+
+static socd_mode_t current_mode = SOCD_DEFAULT_MODE;
+
+// Directions pressed in the previous sample (1 = pressed)
+static uint8_t prev_pressed = 0;
+
+// Timestamp of the most recent press of each direction (index = bit - 4)
+static uint32_t press_time[4];
+
+static const char *const mode_names[SOCD_MODE_COUNT] = {
+    "off", "neutral", "last", "first", "up",
+};
+
+// ============================================================================
+// Internal Functions
+// ============================================================================
+
+static inline uint32_t dir_press_time(uint8_t dir)
+{
+    // DIR_* are single bits 4..7
+    return press_time[__builtin_ctz(dir) - 4];
+}
+
+// Resolve one axis where both a and b are pressed
+// Returns the direction bits to release (set to 1)
+static uint8_t resolve_axis(uint8_t a, uint8_t b)
+{
+    int32_t diff = (int32_t)(dir_press_time(a) - dir_press_time(b));
+
+    switch (current_mode)
+    {
+    case SOCD_MODE_LAST_WIN:
+        // Release the older press, neutral if pressed in the same sample
+        if (diff > 0)
+            return b;
+        if (diff < 0)
+            return a;
+        return a | b;
+
+    case SOCD_MODE_FIRST_WIN:
+        // Release the newer press, neutral if pressed in the same sample
+        if (diff < 0)
+            return b;
+        if (diff > 0)
+            return a;
+        return a | b;
+
+    case SOCD_MODE_UP_PRIORITY:
+        // UP beats DOWN, LEFT+RIGHT stays neutral
+        if (a == DIR_UP)
+            return DIR_DOWN;
+        return a | b;
+
+    case SOCD_MODE_NEUTRAL:
+    default:
+        return a | b;
+    }
+}
+
+// ============================================================================
+// Public Functions
+// ============================================================================
+
+void socd_init(void)
+{
+    socd_set_mode(SOCD_DEFAULT_MODE);
+}
+
+bool socd_set_mode(socd_mode_t mode)
+{
+    if (mode >= SOCD_MODE_COUNT)
+    {
+        return false;
+    }
+
+    current_mode = mode;
+    prev_pressed = 0;
+    memset(press_time, 0, sizeof(press_time));
+    return true;
+}
+
+socd_mode_t socd_get_mode(void)
+{
+    return current_mode;
+}
+
+const char *socd_mode_name(socd_mode_t mode)
+{
+    if (mode >= SOCD_MODE_COUNT)
+    {
+        return "?";
+    }
+    return mode_names[mode];
+}
+
+socd_mode_t socd_parse_mode(const char *name)
+{
+    for (int i = 0; i < SOCD_MODE_COUNT; i++)
+    {
+        if (strcmp(name, mode_names[i]) == 0)
+        {
+            return (socd_mode_t)i;
+        }
+    }
+    return SOCD_MODE_COUNT;
+}
+
+uint8_t socd_apply(uint8_t btn1, uint32_t now_us)
+{
+    if (current_mode == SOCD_MODE_OFF)
+    {
+        return btn1;
+    }
+
+    uint8_t pressed = ~btn1 & DIR_MASK;
+
+    // Record press time for directions that went down in this sample
+    uint8_t new_presses = pressed & ~prev_pressed;
+    for (int i = 0; i < 4; i++)
+    {
+        if (new_presses & (DIR_UP << i))
+        {
+            press_time[i] = now_us;
+        }
+    }
+    prev_pressed = pressed;
+
+    // Left + Right
+    if ((pressed & (DIR_LEFT | DIR_RIGHT)) == (DIR_LEFT | DIR_RIGHT))
+    {
+        btn1 |= resolve_axis(DIR_LEFT, DIR_RIGHT);
+    }
+
+    // Up + Down
+    if ((pressed & (DIR_UP | DIR_DOWN)) == (DIR_UP | DIR_DOWN))
+    {
+        btn1 |= resolve_axis(DIR_UP, DIR_DOWN);
+    }
+
+    return btn1;
+}
+
+uint8_t socd_resolve_latched(uint8_t latched_btn1, uint8_t current_btn1)
+{
+    if (current_mode == SOCD_MODE_OFF)
+    {
+        return latched_btn1;
+    }
+
+    uint8_t pressed = ~latched_btn1 & DIR_MASK;
+
+    // Latched presses from different samples can add up to both directions;
+    // fall back to the current resolved sample for that axis
+    if ((pressed & (DIR_LEFT | DIR_RIGHT)) == (DIR_LEFT | DIR_RIGHT))
+    {
+        latched_btn1 = (latched_btn1 & ~(DIR_LEFT | DIR_RIGHT)) | (current_btn1 & (DIR_LEFT | DIR_RIGHT));
+    }
+    if ((pressed & (DIR_UP | DIR_DOWN)) == (DIR_UP | DIR_DOWN))
+    {
+        latched_btn1 = (latched_btn1 & ~(DIR_UP | DIR_DOWN)) | (current_btn1 & (DIR_UP | DIR_DOWN));
+    }
+
+    return latched_btn1;
+}
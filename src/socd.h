@@ -0,0 +1,64 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SOCD_H
+#define SOCD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ============================================================================
+// SOCD (Simultaneous Opposite Cardinal Direction) Cleaner
+// ============================================================================
+
+// Resolution modes for LEFT+RIGHT and UP+DOWN
+typedef enum
+{
+    SOCD_MODE_OFF = 0,     // Pass through (both directions reported)
+    SOCD_MODE_NEUTRAL,     // Both directions released (HitBox style)
+    SOCD_MODE_LAST_WIN,    // Most recently pressed direction wins
+    SOCD_MODE_FIRST_WIN,   // Direction held first wins
+    SOCD_MODE_UP_PRIORITY, // UP wins over DOWN, LEFT+RIGHT = neutral
+    SOCD_MODE_COUNT
+} socd_mode_t;
+
+// Initialize SOCD state with SOCD_DEFAULT_MODE
+void socd_init(void);
+
+// Select resolution mode (resets per-direction state)
+bool socd_set_mode(socd_mode_t mode);
+
+// Get current resolution mode
+socd_mode_t socd_get_mode(void);
+
+// Mode names for the serial console ("off", "neutral", "last", "first", "up")
+const char *socd_mode_name(socd_mode_t mode);
+
+// Parse a mode name, returns SOCD_MODE_COUNT if unknown
+socd_mode_t socd_parse_mode(const char *name);
+
+// Core 0: Resolve opposite directions in a sampled PSX byte 1
+// now_us is the sample timestamp used to order presses
+uint8_t socd_apply(uint8_t btn1, uint32_t now_us);
+
+// Core 0: Resolve opposite directions accumulated by latching mode
+// Axes with both directions latched take their state from the current
+// (already resolved) sample
+uint8_t socd_resolve_latched(uint8_t latched_btn1, uint8_t current_btn1);
+
+#endif // SOCD_H
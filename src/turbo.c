@@ -0,0 +1,116 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "turbo.h"
+#include "config.h"
+
+// ============================================================================
+// Turbo State
+// ============================================================================
+
+// Configuration (written by Core 0, read by Core 1)
+static volatile uint16_t turbo_mask = TURBO_DEFAULT_MASK;
+static volatile uint8_t turbo_rate = TURBO_DEFAULT_RATE;
+
+// Phase state (Core 1 only)
+static uint8_t phase_polls = 0;       // Polls spent in the current phase
+static bool phase_released = false;   // true = turbo buttons forced released
+
+// ============================================================================
+// Public Functions
+// ============================================================================
+
+void turbo_init(void)
+{
+    turbo_mask = TURBO_DEFAULT_MASK;
+    turbo_rate = TURBO_DEFAULT_RATE;
+    phase_polls = 0;
+    phase_released = false;
+}
+
+bool turbo_set_button(psx_button_t button, bool enabled)
+{
+    if (button >= PSX_BTN_COUNT)
+    {
+        return false;
+    }
+
+    if (enabled)
+    {
+        turbo_mask |= (uint16_t)(1u << button);
+    }
+    else
+    {
+        turbo_mask &= (uint16_t)~(1u << button);
+    }
+    return true;
+}
+
+void turbo_set_mask(uint16_t mask)
+{
+    turbo_mask = mask;
+}
+
+uint16_t turbo_get_mask(void)
+{
+    return turbo_mask;
+}
+
+bool turbo_set_rate(uint8_t polls)
+{
+    if (polls < TURBO_RATE_MIN || polls > TURBO_RATE_MAX)
+    {
+        return false;
+    }
+    turbo_rate = polls;
+    return true;
+}
+
+uint8_t turbo_get_rate(void)
+{
+    return turbo_rate;
+}
+
+uint16_t __time_critical_func(turbo_apply_poll)(uint16_t buttons)
+{
+    // Turbo buttons currently held (0 = pressed in PSX format)
+    uint16_t held = ~buttons & turbo_mask;
+
+    if (held == 0)
+    {
+        // Restart the pattern so the next press is reported immediately
+        phase_polls = 0;
+        phase_released = false;
+        return buttons;
+    }
+
+    if (phase_released)
+    {
+        buttons |= held;
+    }
+
+    // Advance the phase on poll boundaries only
+    if (++phase_polls >= turbo_rate)
+    {
+        phase_polls = 0;
+        phase_released = !phase_released;
+    }
+
+    return buttons;
+}
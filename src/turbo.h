@@ -0,0 +1,60 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TURBO_H
+#define TURBO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "button_input.h"
+
+// ============================================================================
+// Turbo / Rapid-Fire (synchronised to console polls)
+// ============================================================================
+
+// Held turbo buttons alternate between pressed and released every
+// `rate` 0x42 polls, so the game sees each state for exactly `rate` frames.
+// The pattern always starts with a press when the first turbo button goes down.
+
+#define TURBO_RATE_MIN 1  // 1 = toggle every poll (fastest)
+#define TURBO_RATE_MAX 30 // 30 polls = 1 press per second at 60 Hz
+
+// Initialize turbo state (TURBO_DEFAULT_MASK, TURBO_DEFAULT_RATE)
+void turbo_init(void);
+
+// Core 0: Enable/disable turbo for one button
+bool turbo_set_button(psx_button_t button, bool enabled);
+
+// Core 0: Set turbo-enabled buttons as a 16-bit mask (1 = turbo)
+void turbo_set_mask(uint16_t mask);
+
+// Get turbo-enabled button mask
+uint16_t turbo_get_mask(void);
+
+// Core 0: Set polls per pressed/released phase
+bool turbo_set_rate(uint8_t polls);
+
+// Get polls per pressed/released phase
+uint8_t turbo_get_rate(void);
+
+// Core 1: Apply turbo to the button word of one 0x42 poll
+// Must be called exactly once per poll
+uint16_t turbo_apply_poll(uint16_t buttons);
+
+#endif // TURBO_H
@@ -0,0 +1,322 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// ============================================================================
+// Bus Fuzzer
+// ============================================================================
+//
+// Feeds arbitrary console traffic to the firmware's Core 1 loop on the
+// simulated RP2040 and aborts when a bus rule breaks:
+//
+//   - the loop stops answering SEL (the session does not finish)
+//   - DAT or ACK is still driven after SEL rose
+//   - an ACK pulse is not released before the console's ACK timeout
+//   - an ACK follows the last byte of the device's response
+//   - two drivers fight over a net
+//   - the firmware counts an invariant violation (PSX_INVARIANT_CHECKS)
+//
+// An input is a list of exchanges, each a 3-byte header and its CMD bytes:
+//
+//     [gap/clock] [len] [abort_after] [cmd...]
+//
+// gap/clock: bits 0-1 pick the CLK rate (250/500/750/1000 kHz), bits 2-7
+// the idle time before SEL falls in 10 us steps. Missing CMD bytes at the
+// end of the input are 0xFF.
+//
+// With -DPSX_FUZZ=ON and clang this is a libFuzzer target. Otherwise main()
+// below replays corpus files and directories (the psx_fuzz_corpus test):
+//
+//     psx_fuzz <file or dir>...
+//     psx_fuzz --seeds <dir>        write the seed inputs after running them
+
+#include "sim.h"
+#include "console.h"
+#include "firmware.h"
+#include "psx_protocol.h"
+#include "psx_device.h"
+#include "shared_state.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#define MAX_EXCHANGES 16
+#define MAX_INPUT_SIZE 4096
+
+static const uint32_t clock_khz[] = {250, 500, 750, 1000};
+
+typedef struct
+{
+    const uint8_t *data;
+    size_t size;
+    uint32_t exchanges;
+    uint32_t driven_after_sel;
+    uint32_t ack_stuck;
+    uint32_t ack_after_last;
+} run_t;
+
+// ============================================================================
+// One Input
+// ============================================================================
+
+// Bytes of the device's whole response: only the address byte where nothing
+// is emulated, up to the command byte for commands it doesn't answer, and
+// for a poll as many as its ID byte announces (low nibble = halfwords)
+static uint8_t response_len(const uint8_t *cmd, const console_result_t *result)
+{
+    const psx_device_t *device = psx_device_for(cmd[0]);
+    if (device == NULL || device->action != PSX_DEVICE_RESPOND)
+    {
+        return 1;
+    }
+    if (cmd[1] != PSX_CMD_POLL || result->len < 2)
+    {
+        return 2;
+    }
+    return (uint8_t)(3 + 2 * (result->dat[1] & 0x0F));
+}
+
+static void console_task(void *arg)
+{
+    run_t *run = arg;
+    const uint8_t *p = run->data;
+    const uint8_t *end = run->data + run->size;
+    console_t console = console_default(0);
+
+    while (end - p >= 3 && run->exchanges < MAX_EXCHANGES)
+    {
+        uint8_t flags = p[0];
+        uint8_t len = p[1] % (CONSOLE_MAX_BYTES + 1);
+        uint8_t abort_after = p[2];
+        p += 3;
+
+        uint8_t cmd[CONSOLE_MAX_BYTES];
+        memset(cmd, 0xFF, sizeof(cmd));
+        size_t available = (size_t)(end - p) < len ? (size_t)(end - p) : len;
+        memcpy(cmd, p, available);
+        p += available;
+
+        console.clock_khz = clock_khz[flags & 3];
+        sim_delay_ns((uint64_t)(flags >> 2) * 10000);
+
+        console_result_t result;
+        console_exchange(&console, cmd, len, abort_after, &result);
+        run->exchanges++;
+        if (result.driven_after_sel)
+        {
+            run->driven_after_sel++;
+        }
+        for (uint8_t i = 0; i + 1 < result.len; i++)
+        {
+            if (result.ack[i] && result.ack_width_ns[i] == 0)
+            {
+                run->ack_stuck++;
+            }
+        }
+
+        // Clocked to the end of the response, not cut short: no ACK after it
+        if (len > 0 && result.len == len && abort_after >= len && len == response_len(cmd, &result) &&
+            result.ack[len - 1])
+        {
+            run->ack_after_last++;
+        }
+    }
+}
+
+// Run one input; prints what broke and returns false on a violation
+static bool run_input(const uint8_t *data, size_t size)
+{
+    run_t run = {.data = data, .size = size};
+
+    firmware_boot();
+    psx_reset_stats();
+    shared_state_write(0, 0xFF, 0xFF);
+    uint32_t contention = sim_contention_count();
+
+    sim_spawn("console", SIM_EXTERNAL, console_task, &run);
+    bool finished = sim_run(1000000);
+
+    psx_stats_t stats;
+    psx_get_stats(0, &stats);
+    contention = sim_contention_count() - contention;
+
+    if (finished && run.driven_after_sel == 0 && run.ack_stuck == 0 && run.ack_after_last == 0 && contention == 0 &&
+        stats.invariant_violations == 0)
+    {
+        return true;
+    }
+    fprintf(stderr,
+            "%u exchanges:%s driven after SEL %u, ACK stuck %u, ACK after last byte %u, contention %u, "
+            "invariant violations %llu (last: %s)\n",
+            run.exchanges, finished ? "" : " did not finish,", run.driven_after_sel, run.ack_stuck, run.ack_after_last,
+            contention,
+            (unsigned long long)stats.invariant_violations, psx_invariant_name(stats.last_violation));
+    return false;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    if (!run_input(data, size))
+    {
+        abort();
+    }
+    return 0;
+}
+
+#ifndef PSX_FUZZ_LIBFUZZER
+
+// ============================================================================
+// Seed Inputs
+// ============================================================================
+
+typedef struct
+{
+    const char *name;
+    uint8_t size;
+    uint8_t data[48];
+} seed_t;
+
+#define CLK(khz_index, gap_10us) (uint8_t)(((gap_10us) << 2) | (khz_index))
+
+static const seed_t seeds[] = {
+    {"poll", 8, {CLK(0, 0), 5, 5, 0x01, 0x42, 0x00, 0x00, 0x00}},
+    {"poll_500k", 16, {CLK(1, 0), 5, 5, 0x01, 0x42, 0x00, 0x00, 0x00, CLK(1, 20), 5, 5, 0x01, 0x42, 0x00, 0x00, 0x00}},
+    {"poll_aborted", 16, {CLK(0, 0), 5, 3, 0x01, 0x42, 0x00, 0x00, 0x00, CLK(0, 2), 5, 5, 0x01, 0x42, 0x00, 0x00, 0x00}},
+    {"config_enter_exit",
+     28,
+     {CLK(0, 0), 5, 5, 0x01, 0x43, 0x00, 0x01, 0x00, CLK(0, 2), 9, 9, 0x01, 0x45, 0x00, 0x5A, 0x5A, 0x5A, 0x5A, 0x5A,
+      0x5A, CLK(0, 2), 5, 5, 0x01, 0x43, 0x00, 0x00, 0x00}},
+    {"memcard_read", 13, {CLK(0, 0), 10, 10, 0x81, 0x52, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+    {"wrong_address", 8, {CLK(0, 0), 5, 5, 0x02, 0x42, 0x00, 0x00, 0x00}},
+    {"sel_pulse", 6, {CLK(0, 0), 0, 0, CLK(0, 1), 0, 0}},
+    {"last_byte",
+     23,
+     {CLK(0, 0), 5, 5, 0x01, 0x42, 0x00, 0x00, 0x00, CLK(1, 2), 5, 5, 0x01, 0x42, 0x00, 0x00, 0x00, CLK(0, 2), 2, 2,
+      0x01, 0x44, CLK(0, 2), 1, 1, 0x81}},
+    {"fast_burst", 24, {CLK(3, 0), 5, 5, 0x01, 0x42, 0x00, 0x00, 0x00, CLK(2, 0), 5, 5, 0x01, 0x42, 0x00, 0x00, 0x00,
+                        CLK(0, 0), 5, 5, 0x01, 0x42, 0x00, 0x00, 0x00}},
+};
+
+static bool write_seeds(const char *dir)
+{
+    bool ok = true;
+    for (size_t i = 0; i < sizeof(seeds) / sizeof(seeds[0]); i++)
+    {
+        const seed_t *seed = &seeds[i];
+        if (!run_input(seed->data, seed->size))
+        {
+            fprintf(stderr, "seed %s fails\n", seed->name);
+            ok = false;
+            continue;
+        }
+
+        char path[1024];
+        snprintf(path, sizeof(path), "%s/%s", dir, seed->name);
+        FILE *f = fopen(path, "wb");
+        if (!f || fwrite(seed->data, 1, seed->size, f) != seed->size)
+        {
+            perror(path);
+            ok = false;
+        }
+        if (f)
+        {
+            fclose(f);
+        }
+    }
+    return ok;
+}
+
+// ============================================================================
+// Corpus Replay
+// ============================================================================
+
+static int inputs = 0, passed = 0;
+
+static void replay_file(const char *path)
+{
+    static uint8_t data[MAX_INPUT_SIZE];
+    FILE *f = fopen(path, "rb");
+    if (!f)
+    {
+        perror(path);
+        inputs++;
+        return;
+    }
+    size_t size = fread(data, 1, sizeof(data), f);
+    fclose(f);
+
+    inputs++;
+    if (run_input(data, size))
+    {
+        passed++;
+    }
+    else
+    {
+        printf("FAIL  %s\n", path);
+    }
+}
+
+static void replay_path(const char *path)
+{
+    struct stat st;
+    if (stat(path, &st) == 0 && S_ISDIR(st.st_mode))
+    {
+        DIR *dir = opendir(path);
+        struct dirent *entry;
+        while (dir && (entry = readdir(dir)) != NULL)
+        {
+            if (entry->d_name[0] != '.')
+            {
+                char child[1024];
+                snprintf(child, sizeof(child), "%s/%s", path, entry->d_name);
+                replay_file(child);
+            }
+        }
+        if (dir)
+        {
+            closedir(dir);
+        }
+    }
+    else
+    {
+        replay_file(path);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc == 3 && strcmp(argv[1], "--seeds") == 0)
+    {
+        return write_seeds(argv[2]) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <file or dir>... | --seeds <dir>\n", argv[0]);
+        return 2;
+    }
+
+    for (int i = 1; i < argc; i++)
+    {
+        replay_path(argv[i]);
+    }
+    printf("%d/%d inputs passed\n", passed, inputs);
+    return inputs > 0 && passed == inputs ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+#endif // PSX_FUZZ_LIBFUZZER
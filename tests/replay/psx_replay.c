@@ -0,0 +1,352 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// ============================================================================
+// Session Replay Harness
+// ============================================================================
+//
+// Replays recorded bus sessions against the firmware's Core 1 loop on the
+// simulated RP2040 and checks what the device answered:
+//
+//     psx_replay [--dat-limit-ns N] [--ack-limit-us N] <file.session>...
+//
+// A session is text (tools/psx_sniff.py --session writes one from a capture):
+//
+//     clock_khz 250                  CLK rate of the console
+//     gap_us 10                      ACK release to the next byte (optional)
+//     <at_us> <cmd hex...> | <dat hex...> | <ack per byte, + or ->
+//
+// Each line is one SEL LOW period, started at_us after the session start
+// (or right after the previous one if that ran longer). The console clocks
+// the CMD bytes and gives up after a byte without ACK, like a real one.
+// The pad state of a 0x42 poll is taken from the expected answer, so
+// sessions recorded with buttons pressed still match.
+//
+// Per session it reports DAT mismatches, missing and extra ACKs, the worst
+// CLK-falling-edge-to-DAT latency and the worst ACK delay, and fails when
+// any of them is off or over its limit.
+
+#include "sim.h"
+#include "console.h"
+#include "firmware.h"
+#include "psx_protocol.h"
+#include "shared_state.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdarg.h>
+
+#define MAX_TRANSACTIONS 4096
+#define MAX_LISTED 5 // Mismatches printed per session
+
+typedef struct
+{
+    uint32_t at_us;
+    uint8_t len;
+    uint8_t cmd[CONSOLE_MAX_BYTES];
+    uint8_t dat[CONSOLE_MAX_BYTES];
+    bool ack[CONSOLE_MAX_BYTES];
+} transaction_t;
+
+typedef struct
+{
+    uint32_t clock_khz;
+    uint32_t gap_us;
+    uint32_t count;
+    transaction_t transactions[MAX_TRANSACTIONS];
+} session_t;
+
+typedef struct
+{
+    uint32_t compared;
+    uint32_t mismatches;
+    uint32_t ack_missing;
+    uint32_t ack_extra;
+    uint32_t ack_late;
+    uint32_t dat_late;
+    uint32_t dat_max_ns;
+    uint32_t ack_max_ns;
+    uint32_t listed;
+} report_t;
+
+static uint32_t dat_limit_ns = 500;
+static uint32_t ack_limit_us = 10;
+
+static session_t session;
+static report_t report;
+
+// ============================================================================
+// Session Files
+// ============================================================================
+
+// Parse hex bytes up to '|' or the end of the line; returns the count
+static int parse_bytes(char **cursor, uint8_t *out)
+{
+    int count = 0;
+    char *p = *cursor;
+
+    while (*p && *p != '|' && *p != '\n')
+    {
+        if (isspace((unsigned char)*p))
+        {
+            p++;
+            continue;
+        }
+        char *end;
+        unsigned long value = strtoul(p, &end, 16);
+        if (end == p || value > 0xFF || count == CONSOLE_MAX_BYTES)
+        {
+            return -1;
+        }
+        out[count++] = (uint8_t)value;
+        p = end;
+    }
+    *cursor = *p == '|' ? p + 1 : p;
+    return count;
+}
+
+static bool load_session(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    if (!f)
+    {
+        perror(path);
+        return false;
+    }
+
+    memset(&session, 0, sizeof(session));
+    session.clock_khz = 250;
+    session.gap_us = 10;
+
+    char line[512];
+    int line_no = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), f))
+    {
+        line_no++;
+        char *p = line;
+        while (isspace((unsigned char)*p))
+        {
+            p++;
+        }
+        if (*p == '\0' || *p == '#')
+        {
+            continue;
+        }
+        if (sscanf(p, "clock_khz %u", &session.clock_khz) == 1 || sscanf(p, "gap_us %u", &session.gap_us) == 1)
+        {
+            continue;
+        }
+        if (session.count == MAX_TRANSACTIONS)
+        {
+            fprintf(stderr, "%s: more than %d transactions\n", path, MAX_TRANSACTIONS);
+            ok = false;
+            break;
+        }
+
+        transaction_t *t = &session.transactions[session.count];
+        char *end;
+        t->at_us = (uint32_t)strtoul(p, &end, 10);
+        p = end;
+        int cmd_len = end == line ? -1 : parse_bytes(&p, t->cmd);
+        int dat_len = parse_bytes(&p, t->dat);
+        while (isspace((unsigned char)*p))
+        {
+            p++;
+        }
+        int ack_len = 0;
+        while (*p == '+' || *p == '-')
+        {
+            if (ack_len < CONSOLE_MAX_BYTES)
+            {
+                t->ack[ack_len] = *p == '+';
+            }
+            ack_len++;
+            p++;
+        }
+        if (cmd_len <= 0 || dat_len != cmd_len || ack_len != cmd_len)
+        {
+            fprintf(stderr, "%s:%d: expected '<at_us> <cmd...> | <dat...> | <+/-...>'\n", path, line_no);
+            ok = false;
+            break;
+        }
+        t->len = (uint8_t)cmd_len;
+        session.count++;
+    }
+    fclose(f);
+
+    if (ok && session.clock_khz == 0)
+    {
+        fprintf(stderr, "%s: clock_khz must be non-zero\n", path);
+        ok = false;
+    }
+    return ok;
+}
+
+// ============================================================================
+// Replay
+// ============================================================================
+
+static void note(uint32_t index, const char *fmt, ...)
+{
+    if (report.listed++ < MAX_LISTED)
+    {
+        va_list args;
+        va_start(args, fmt);
+        printf("      #%u ", index);
+        vprintf(fmt, args);
+        printf("\n");
+        va_end(args);
+    }
+}
+
+static void check(uint32_t index, const transaction_t *want, const console_result_t *got)
+{
+    report.compared++;
+    for (uint8_t i = 0; i < want->len; i++)
+    {
+        if (i >= got->len)
+        {
+            report.mismatches++;
+            note(index, "byte %u: not clocked (%u bytes exchanged)", i, got->len);
+            break;
+        }
+        if (got->dat[i] != want->dat[i])
+        {
+            report.mismatches++;
+            note(index, "byte %u: DAT %02X", i, got->dat[i]);
+        }
+        if (want->ack[i] && !got->ack[i])
+        {
+            report.ack_missing++;
+            note(index, "byte %u: ACK missing", i);
+        }
+        else if (!want->ack[i] && got->ack[i])
+        {
+            report.ack_extra++;
+            note(index, "byte %u: unexpected ACK", i);
+        }
+        else if (got->ack[i] && i < want->len - 1)
+        {
+            if (got->ack_delay_ns[i] > report.ack_max_ns)
+            {
+                report.ack_max_ns = got->ack_delay_ns[i];
+            }
+            if (got->ack_delay_ns[i] > ack_limit_us * 1000)
+            {
+                report.ack_late++;
+                note(index, "byte %u: ACK after %u ns", i, got->ack_delay_ns[i]);
+            }
+        }
+    }
+
+    if (got->dat_latency_max_ns > report.dat_max_ns)
+    {
+        report.dat_max_ns = got->dat_latency_max_ns;
+    }
+    if (got->dat_latency_max_ns > dat_limit_ns)
+    {
+        report.dat_late++;
+        note(index, "DAT %u ns after CLK fell", got->dat_latency_max_ns);
+    }
+}
+
+static void console_task(void *arg)
+{
+    console_t console = console_default(0);
+    console.clock_khz = session.clock_khz;
+    console.byte_gap_ns = session.gap_us * 1000;
+    uint64_t start = sim_now_ns();
+
+    for (uint32_t i = 0; i < session.count; i++)
+    {
+        const transaction_t *t = &session.transactions[i];
+        uint64_t at = start + (uint64_t)t->at_us * 1000;
+        if (at > sim_now_ns())
+        {
+            sim_delay_ns(at - sim_now_ns());
+        }
+
+        if (t->len >= 5 && t->cmd[0] == 0x01 && t->cmd[1] == 0x42)
+        {
+            shared_state_write(0, t->dat[3], t->dat[4]);
+        }
+
+        console_result_t result;
+        console_exchange(&console, t->cmd, t->len, t->len, &result);
+        check(i, t, &result);
+    }
+}
+
+static bool replay(const char *path)
+{
+    const char *name = strrchr(path, '/') ? strrchr(path, '/') + 1 : path;
+    if (!load_session(path))
+    {
+        return false;
+    }
+
+    memset(&report, 0, sizeof(report));
+    firmware_boot();
+    sim_spawn("console", SIM_EXTERNAL, console_task, NULL);
+    uint64_t span_us = session.count ? session.transactions[session.count - 1].at_us : 0;
+    bool finished = sim_run((uint32_t)(span_us + 1000000));
+
+    bool failed = !finished || report.mismatches || report.ack_missing || report.ack_extra || report.ack_late ||
+                  report.dat_late;
+    printf("%-4s  %s: %u transactions at %u kHz, %u DAT mismatches, ACK missing %u / extra %u / late %u, "
+           "edge-to-DAT max %u ns (limit %u), ACK delay max %u ns (limit %u us)%s\n",
+           failed ? "FAIL" : "ok", name, report.compared, session.clock_khz, report.mismatches, report.ack_missing,
+           report.ack_extra, report.ack_late, report.dat_max_ns, dat_limit_ns, report.ack_max_ns, ack_limit_us,
+           finished ? "" : ", did not finish");
+    return !failed;
+}
+
+int main(int argc, char **argv)
+{
+    int sessions = 0, passed = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--dat-limit-ns") == 0 && i + 1 < argc)
+        {
+            dat_limit_ns = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argv[i], "--ack-limit-us") == 0 && i + 1 < argc)
+        {
+            ack_limit_us = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else
+        {
+            sessions++;
+            passed += replay(argv[i]);
+        }
+    }
+
+    if (sessions == 0)
+    {
+        fprintf(stderr, "usage: %s [--dat-limit-ns N] [--ack-limit-us N] <file.session>...\n", argv[0]);
+        return 2;
+    }
+    if (sessions > 1)
+    {
+        printf("\n%d/%d sessions passed\n", passed, sessions);
+    }
+    return passed == sessions ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,43 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HARDWARE_STRUCTS_SIO_H
+#define HARDWARE_STRUCTS_SIO_H
+
+#include <stdint.h>
+
+// Only the GPIO fields are kept up to date by the simulator
+typedef struct
+{
+    volatile uint32_t cpuid;
+    volatile uint32_t gpio_in;
+    volatile uint32_t gpio_hi_in;
+    uint32_t _pad0;
+    volatile uint32_t gpio_out;
+    volatile uint32_t gpio_set;
+    volatile uint32_t gpio_clr;
+    volatile uint32_t gpio_togl;
+    volatile uint32_t gpio_oe;
+    volatile uint32_t gpio_oe_set;
+    volatile uint32_t gpio_oe_clr;
+    volatile uint32_t gpio_oe_togl;
+} sio_hw_t;
+
+extern sio_hw_t *sio_hw;
+
+#endif // HARDWARE_STRUCTS_SIO_H
@@ -0,0 +1,34 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HARDWARE_VREG_H
+#define HARDWARE_VREG_H
+
+enum vreg_voltage
+{
+    VREG_VOLTAGE_1_10 = 11,
+    VREG_VOLTAGE_1_15 = 12,
+    VREG_VOLTAGE_1_20 = 13,
+    VREG_VOLTAGE_1_25 = 14,
+    VREG_VOLTAGE_1_30 = 15,
+    VREG_VOLTAGE_DEFAULT = VREG_VOLTAGE_1_10
+};
+
+void vreg_set_voltage(enum vreg_voltage voltage);
+
+#endif // HARDWARE_VREG_H
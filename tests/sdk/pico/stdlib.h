@@ -0,0 +1,55 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Host stand-in for the pico-sdk headers used by src/ (see tests/sim/sim.c)
+
+#ifndef PICO_STDLIB_H
+#define PICO_STDLIB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef unsigned int uint;
+
+#define PICO_DEFAULT_LED_PIN 25
+#define PICO_ERROR_TIMEOUT (-1)
+#define PICO_FLASH_SIZE_BYTES (2 * 1024 * 1024)
+#define XIP_BASE 0x10000000
+#define NUM_BANK0_GPIOS 30
+
+#define __time_critical_func(x) x
+#define __not_in_flash_func(x) x
+#define __not_in_flash(group)
+#define __scratch_x(group)
+#define __scratch_y(group)
+#define __force_inline inline
+
+void stdio_init_all(void);
+int getchar_timeout_us(uint32_t timeout_us);
+int putchar_raw(int c);
+void stdio_flush(void);
+
+static inline void tight_loop_contents(void) {}
+
+bool set_sys_clock_khz(uint32_t freq_khz, bool required);
+
+#include "hardware/gpio.h"
+#include "pico/time.h"
+
+#endif // PICO_STDLIB_H
@@ -0,0 +1,152 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "console.h"
+#include "sim.h"
+#include "psx_bitbang.h"
+#include <string.h>
+
+// ============================================================================
+// Console Side of the Bus
+// ============================================================================
+
+console_t console_default(uint8_t port)
+{
+    console_t console = {
+        .port = port,
+        .clock_khz = 250,
+        .sel_setup_ns = 20000,
+        .byte_gap_ns = 10000,
+        .ack_timeout_ns = 100000,
+        .sel_hold_ns = 500,
+        .release_ns = 10000,
+    };
+    return console;
+}
+
+void console_connect(const console_t *console)
+{
+    const psx_port_pins_t *pins = &psx_port_pins[console->port];
+    sim_pull_up(pins->dat);
+    sim_pull_up(pins->ack);
+    sim_drive(pins->sel, 1);
+    sim_drive(pins->clk, 1);
+    sim_drive(pins->cmd, 1);
+}
+
+// Clock one byte LSB first: CMD changes on the falling edge, DAT is sampled
+// on the rising edge. Returns the time of the last rising edge.
+static uint64_t clock_byte(const console_t *console, uint8_t out, uint8_t *in, console_result_t *result)
+{
+    const psx_port_pins_t *pins = &psx_port_pins[console->port];
+    uint64_t half = 500000ull / console->clock_khz;
+    uint64_t rise = 0;
+    uint8_t value = 0;
+
+    for (int bit = 0; bit < 8; bit++)
+    {
+        sim_drive(pins->clk, 0);
+        uint64_t fall = sim_now_ns();
+        sim_drive(pins->cmd, (out >> bit) & 1);
+        sim_delay_ns(half);
+
+        sim_drive(pins->clk, 1);
+        rise = sim_now_ns();
+        if (sim_level(pins->dat))
+        {
+            value |= 1u << bit;
+        }
+        uint64_t change = sim_last_change_ns(pins->dat);
+        if (change > fall && change <= rise)
+        {
+            uint32_t latency = (uint32_t)(change - fall);
+            if (latency > result->dat_latency_max_ns)
+            {
+                result->dat_latency_max_ns = latency;
+            }
+            result->dat_changes++;
+        }
+        if (bit < 7)
+        {
+            sim_delay_ns(half);
+        }
+    }
+
+    *in = value;
+    return rise;
+}
+
+void console_exchange(const console_t *console, const uint8_t *cmd, uint8_t len, uint8_t abort_after,
+                      console_result_t *result)
+{
+    const psx_port_pins_t *pins = &psx_port_pins[console->port];
+
+    memset(result, 0, sizeof(*result));
+    if (len > CONSOLE_MAX_BYTES)
+    {
+        len = CONSOLE_MAX_BYTES;
+    }
+
+    sim_drive(pins->sel, 0);
+    result->start_ns = sim_now_ns();
+    sim_delay_ns(console->sel_setup_ns);
+
+    for (uint8_t i = 0; i < len && i < abort_after; i++)
+    {
+        uint64_t rise = clock_byte(console, cmd[i], &result->dat[i], result);
+        result->len = i + 1;
+
+        if (i == len - 1 || i + 1 == abort_after)
+        {
+            // No ACK is waited for after the last byte; any ACK activity is noted below
+            sim_delay_ns(console->sel_hold_ns);
+            break;
+        }
+
+        uint64_t ack_fall, ack_rise;
+        if (!sim_wait_level(pins->ack, 0, console->ack_timeout_ns, &ack_fall))
+        {
+            break;
+        }
+        result->ack[i] = true;
+        result->ack_delay_ns[i] = (uint32_t)(ack_fall - rise);
+        if (sim_wait_level(pins->ack, 1, console->ack_timeout_ns, &ack_rise))
+        {
+            result->ack_width_ns[i] = (uint32_t)(ack_rise - ack_fall);
+        }
+        sim_delay_ns(console->byte_gap_ns);
+    }
+
+    uint64_t last_byte_end = sim_now_ns();
+    sim_drive(pins->cmd, 1);
+    sim_drive(pins->sel, 1);
+    result->end_ns = sim_now_ns();
+
+    sim_delay_ns(console->release_ns);
+    result->driven_after_sel = !sim_level(pins->dat) || !sim_level(pins->ack);
+    if (result->len == len && len > 0 && sim_last_change_ns(pins->ack) >= last_byte_end - console->sel_hold_ns)
+    {
+        result->ack[len - 1] = true;
+    }
+}
+
+void console_poll(const console_t *console, console_result_t *result)
+{
+    static const uint8_t poll[] = {0x01, 0x42, 0x00, 0x00, 0x00};
+    console_exchange(console, poll, sizeof(poll), sizeof(poll), result);
+}
@@ -0,0 +1,73 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SIM_CONSOLE_H
+#define SIM_CONSOLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ============================================================================
+// Simulated Console (runs inside a sim coroutine)
+// ============================================================================
+
+#define CONSOLE_MAX_BYTES 40
+
+// Timing of one console port
+typedef struct
+{
+    uint8_t port;            // Pin set from psx_port_pins
+    uint32_t clock_khz;      // CLK rate
+    uint32_t sel_setup_ns;   // SEL LOW to the first CLK falling edge
+    uint32_t byte_gap_ns;    // ACK release to the next byte
+    uint32_t ack_timeout_ns; // A byte without ACK within this ends the transaction
+    uint32_t sel_hold_ns;    // Last CLK rising edge to SEL HIGH
+    uint32_t release_ns;     // After SEL rises, DAT and ACK must be released within this
+} console_t;
+
+// What the console saw during one transaction
+typedef struct
+{
+    uint8_t len;                              // Bytes clocked
+    uint8_t dat[CONSOLE_MAX_BYTES];           // Bytes read from DAT
+    bool ack[CONSOLE_MAX_BYTES];              // ACK after the byte (last byte: any ACK activity)
+    uint32_t ack_delay_ns[CONSOLE_MAX_BYTES]; // Last CLK rise to ACK falling edge
+    uint32_t ack_width_ns[CONSOLE_MAX_BYTES];
+    uint32_t dat_latency_max_ns;              // Worst CLK falling edge to DAT change
+    uint32_t dat_changes;                     // Number of DAT changes measured
+    bool driven_after_sel;                    // DAT or ACK still LOW release_ns after SEL rose
+    uint64_t start_ns;                        // SEL falling edge
+    uint64_t end_ns;                          // SEL rising edge
+} console_result_t;
+
+// PS1-like defaults for a port (250 kHz)
+console_t console_default(uint8_t port);
+
+// Pull-ups on DAT/ACK and SEL/CLK/CMD idle HIGH. Call before sim_run().
+void console_connect(const console_t *console);
+
+// Clock a transaction of len command bytes. The console gives up after a
+// byte other than the last that isn't ACKed, like a real one; len = 0 only
+// pulses SEL. Stops early (aborts) after abort_after bytes if that is < len.
+void console_exchange(const console_t *console, const uint8_t *cmd, uint8_t len, uint8_t abort_after,
+                      console_result_t *result);
+
+// Digital controller poll (01 42 00 00 00)
+void console_poll(const console_t *console, console_result_t *result);
+
+#endif // SIM_CONSOLE_H
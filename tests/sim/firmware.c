@@ -0,0 +1,97 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// ============================================================================
+// Host Stand-in for main.c
+// ============================================================================
+//
+// The globals and Core 1 entry that src/ modules take from main.c, without
+// the serial console, scheduler tasks or sniffer.
+
+#include "firmware.h"
+#include "sim.h"
+#include "console.h"
+#include "config.h"
+#include "button_input.h"
+#include "debounce.h"
+#include "socd.h"
+#include "persona.h"
+#include "turbo.h"
+#include "macro.h"
+#include "inject.h"
+#include "poll_sync.h"
+#include "shared_state.h"
+#include "psx_protocol.h"
+#include "psx_bitbang.h"
+#include "pico/multicore.h"
+#include <stdbool.h>
+#include <stdlib.h>
+
+bool latching_mode = false;
+
+void core1_entry(void)
+{
+    psx_protocol_init();
+    inject_core1_start();
+    psx_protocol_task();
+}
+
+void core1_stop(void)
+{
+    psx_protocol_park(PSX_PARK_TIMEOUT_US);
+    multicore_reset_core1();
+}
+
+void firmware_init(void)
+{
+    button_input_init();
+    debounce_init();
+    socd_init();
+    persona_init();
+    turbo_init();
+    macro_init();
+    inject_init();
+    poll_sync_init();
+    shared_state_init();
+}
+
+void firmware_boot(void)
+{
+    sim_reset();
+    firmware_init();
+    for (uint8_t port = 0; port < PSX_PORT_COUNT; port++)
+    {
+        console_t console = console_default(port);
+        console_connect(&console);
+    }
+    const char *vcd = getenv("PSX_VCD");
+    if (vcd != NULL && *vcd != '\0')
+    {
+        firmware_trace_port(0, vcd);
+    }
+    multicore_launch_core1(core1_entry);
+    sim_run(100);
+}
+
+bool firmware_trace_port(uint8_t port, const char *path)
+{
+    static const char *const names[] = {"SEL", "CLK", "CMD", "DAT", "ACK"};
+    const psx_port_pins_t *p = &psx_port_pins[port];
+    const unsigned int trace_pins[] = {p->sel, p->clk, p->cmd, p->dat, p->ack};
+    return sim_trace_open(path, trace_pins, names, (int)(sizeof(trace_pins) / sizeof(trace_pins[0])));
+}
@@ -0,0 +1,46 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SIM_FIRMWARE_H
+#define SIM_FIRMWARE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ============================================================================
+// Host Stand-in for main.c
+// ============================================================================
+
+// Core 1 entry as in main.c (sniffer disabled)
+void core1_entry(void);
+
+// Park and reset Core 1 as in main.c
+void core1_stop(void);
+
+// Module initialization of main() without flash, LED, stdio or the scheduler
+void firmware_init(void);
+
+// sim_reset(), firmware_init(), console pins of every port, then Core 1
+// launched and idle in its SEL wait. With PSX_VCD=<file> in the environment,
+// port 1's bus is traced to that file from here on (the last boot wins).
+void firmware_boot(void);
+
+// Trace SEL/CLK/CMD/DAT/ACK of a port to a VCD file until sim_reset()
+bool firmware_trace_port(uint8_t port, const char *path);
+
+#endif // SIM_FIRMWARE_H
@@ -0,0 +1,1186 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define _GNU_SOURCE
+#include "sim.h"
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "hardware/clocks.h"
+#include "hardware/gpio.h"
+#include "hardware/sync.h"
+#include "hardware/vreg.h"
+#include "hardware/structs/sio.h"
+#include "hardware/structs/systick.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ucontext.h>
+
+// ============================================================================
+// Simulator State
+// ============================================================================
+
+#define SIM_MAX_COROUTINES 8
+#define SIM_STACK_SIZE (256 * 1024)
+#define SIM_NEVER UINT64_MAX
+
+typedef enum
+{
+    CO_READY,   // Running, or runnable at its current time
+    CO_WAITING, // Waiting until wake_at (busy wait, WFE or pin watch)
+    CO_DONE,    // Returned or reset
+} co_state_t;
+
+typedef struct
+{
+    const char *name;
+    sim_role_t role;
+    bool background; // Core 1 launched by the firmware: sim_run() doesn't wait for it
+    co_state_t state;
+    uint64_t now;
+    uint64_t wake_at;
+    bool in_wfe;
+    int watch_pin;
+    bool watch_level;
+    bool watch_hit;
+    uint64_t watch_at;
+    sim_entry_t entry;
+    void *arg;
+    ucontext_t ctx;
+    void *stack;
+} coroutine_t;
+
+// Per-core processor state (IO_BANK0 enables and the SDK callback survive a core reset)
+typedef struct
+{
+    coroutine_t *co;
+    uint32_t inte[SIM_GPIO_COUNT];
+    gpio_irq_callback_t callback;
+    bool masked;
+    bool in_handler;
+    bool event;
+    systick_hw_t systick;
+    uint32_t systick_shown;
+    uint64_t systick_base;
+} core_t;
+
+typedef struct
+{
+    int func;
+    bool oe;
+    bool out;
+    bool pull_up;
+    bool pull_down;
+    int ext;           // External driver level or SIM_RELEASE
+    bool ext_pull_up;
+    int parent;        // Net (union-find)
+    uint32_t raw;      // Latched edge events (shared by both cores)
+} pin_t;
+
+typedef struct
+{
+    bool level;
+    bool contended;
+    uint64_t last_change;
+} net_t;
+
+static coroutine_t coroutines[SIM_MAX_COROUTINES];
+static int coroutine_count = 0;
+static coroutine_t *current = NULL;
+static ucontext_t scheduler_ctx;
+static uint64_t main_now = 0;
+static uint64_t run_deadline = SIM_NEVER; // Limit of the sim_run() in progress
+
+static core_t cores[2];
+static pin_t pins[SIM_GPIO_COUNT];
+static net_t nets[SIM_GPIO_COUNT];
+static uint32_t contentions = 0;
+
+static uint32_t sys_hz = 125000000;
+static sim_costs_t costs = {.pin_access = 3, .timer_read = 8, .sdk_call = 20, .irq_entry = 40};
+static int (*putchar_hook)(int c) = NULL;
+
+static sio_hw_t sio_regs;
+sio_hw_t *sio_hw = &sio_regs;
+
+// ============================================================================
+// Time and Scheduling
+// ============================================================================
+
+static uint64_t cycles_to_ns(uint64_t cycles)
+{
+    return cycles * 1000000000ull / sys_hz;
+}
+
+static uint64_t now_ns(void)
+{
+    return current ? current->now : main_now;
+}
+
+static uint64_t next_time(const coroutine_t *co)
+{
+    switch (co->state)
+    {
+    case CO_READY:
+        return co->now;
+    case CO_WAITING:
+        return co->wake_at;
+    default:
+        return SIM_NEVER;
+    }
+}
+
+static uint64_t others_min(const coroutine_t *self)
+{
+    uint64_t min = SIM_NEVER;
+    for (int i = 0; i < coroutine_count; i++)
+    {
+        if (&coroutines[i] != self && next_time(&coroutines[i]) < min)
+        {
+            min = next_time(&coroutines[i]);
+        }
+    }
+    return min;
+}
+
+static void co_yield(void)
+{
+    coroutine_t *self = current;
+    swapcontext(&self->ctx, &scheduler_ctx);
+}
+
+static core_t *core_of(const coroutine_t *co)
+{
+    if (co == NULL)
+    {
+        return &cores[0];
+    }
+    return co->role == SIM_EXTERNAL ? NULL : &cores[co->role];
+}
+
+// Events of a pin that would enter the handler of a core
+static uint32_t pending_events(const core_t *core, unsigned int pin)
+{
+    uint32_t events = pins[pin].raw;
+    events |= nets[pins[pin].parent].level ? GPIO_IRQ_LEVEL_HIGH : GPIO_IRQ_LEVEL_LOW;
+    return events & core->inte[pin];
+}
+
+static bool irq_deliverable(const core_t *core)
+{
+    if (core == NULL || core->masked || core->in_handler || core->callback == NULL)
+    {
+        return false;
+    }
+    for (unsigned int pin = 0; pin < SIM_GPIO_COUNT; pin++)
+    {
+        if (pending_events(core, pin))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Run the GPIO IRQ handler of the current core for every pending pin
+static void take_irqs(void)
+{
+    core_t *core = core_of(current);
+    while (irq_deliverable(core))
+    {
+        core->in_handler = true;
+        current->now += cycles_to_ns(costs.irq_entry);
+        for (unsigned int pin = 0; pin < SIM_GPIO_COUNT; pin++)
+        {
+            uint32_t events = pending_events(core, pin);
+            if (events)
+            {
+                // As the SDK's dispatcher: edges are acknowledged before the callback
+                pins[pin].raw &= ~(events & (GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE));
+                core->callback(pin, events);
+            }
+        }
+        core->in_handler = false;
+        core->event = true;
+    }
+}
+
+// Let every coroutine that is behind catch up, then take pending IRQs
+static void co_sync(void)
+{
+    coroutine_t *self = current;
+    if (self == NULL)
+    {
+        return;
+    }
+    // A coroutine spinning alone past the limit goes back to sim_run() too
+    while (self->now > others_min(self) || self->now > run_deadline)
+    {
+        co_yield();
+    }
+    take_irqs();
+}
+
+static void tick(uint32_t cycles)
+{
+    if (current != NULL)
+    {
+        current->now += cycles_to_ns(cycles);
+        co_sync();
+    }
+}
+
+static void wake(coroutine_t *co, uint64_t at)
+{
+    if (co == NULL || co->state != CO_WAITING)
+    {
+        return;
+    }
+    if (at < co->now)
+    {
+        at = co->now;
+    }
+    if (at < co->wake_at)
+    {
+        co->wake_at = at;
+    }
+}
+
+// Sleep the current coroutine until the deadline, an IRQ or (in WFE) an event
+static void wait_until(uint64_t deadline, bool wfe)
+{
+    coroutine_t *self = current;
+    if (self == NULL)
+    {
+        if (deadline != SIM_NEVER && deadline > main_now)
+        {
+            main_now = deadline;
+        }
+        return;
+    }
+
+    while (self->now < deadline)
+    {
+        if (irq_deliverable(core_of(self)))
+        {
+            take_irqs();
+            if (wfe)
+            {
+                break;
+            }
+            continue;
+        }
+        if (self->watch_pin >= 0 && self->watch_hit)
+        {
+            break;
+        }
+
+        self->state = CO_WAITING;
+        self->wake_at = deadline;
+        self->in_wfe = wfe;
+        co_yield();
+        self->in_wfe = false;
+
+        if (wfe && core_of(self) && core_of(self)->event)
+        {
+            take_irqs();
+            break;
+        }
+    }
+    co_sync();
+}
+
+static void co_trampoline(int index)
+{
+    coroutine_t *co = &coroutines[index];
+    co->entry(co->arg);
+    co->state = CO_DONE;
+    if (co->role != SIM_EXTERNAL && cores[co->role].co == co)
+    {
+        cores[co->role].co = NULL;
+    }
+}
+
+static coroutine_t *spawn(const char *name, sim_role_t role, sim_entry_t entry, void *arg, bool background)
+{
+    // Reuse the slot of a finished or reset coroutine (never resumed again)
+    int index = 0;
+    while (index < coroutine_count && coroutines[index].state != CO_DONE)
+    {
+        index++;
+    }
+    if (index == SIM_MAX_COROUTINES)
+    {
+        fprintf(stderr, "sim: too many coroutines\n");
+        abort();
+    }
+    if (index == coroutine_count)
+    {
+        coroutine_count++;
+    }
+    if (role != SIM_EXTERNAL && cores[role].co != NULL)
+    {
+        fprintf(stderr, "sim: core %d already runs %s\n", role, cores[role].co->name);
+        abort();
+    }
+
+    coroutine_t *co = &coroutines[index];
+    free(co->stack);
+    memset(co, 0, sizeof(*co));
+    co->name = name;
+    co->role = role;
+    co->background = background;
+    co->state = CO_READY;
+    co->now = now_ns();
+    co->watch_pin = -1;
+    co->entry = entry;
+    co->arg = arg;
+    co->stack = malloc(SIM_STACK_SIZE);
+
+    getcontext(&co->ctx);
+    co->ctx.uc_stack.ss_sp = co->stack;
+    co->ctx.uc_stack.ss_size = SIM_STACK_SIZE;
+    co->ctx.uc_link = &scheduler_ctx;
+    makecontext(&co->ctx, (void (*)(void))co_trampoline, 1, index);
+
+    if (role != SIM_EXTERNAL)
+    {
+        cores[role].co = co;
+    }
+    return co;
+}
+
+// ============================================================================
+// Pins and Nets
+// ============================================================================
+
+static int net_of(unsigned int pin)
+{
+    int p = (int)pin;
+    while (pins[p].parent != p)
+    {
+        p = pins[p].parent;
+    }
+    return p;
+}
+
+// ============================================================================
+// Waveform Trace
+// ============================================================================
+
+// VCD in the layout of tools/psx_vcd.py's VcdWriter: change lines are built
+// when the trace opens, so an edge is only a couple of buffered writes
+typedef struct
+{
+    FILE *file;
+    int count;
+    unsigned int pins[SIM_TRACE_MAX];
+    char lines[SIM_TRACE_MAX][2][4]; // "0!\n", "1!\n", ...
+    uint64_t time;                   // Of the last "#" line
+} trace_t;
+
+static trace_t trace;
+
+static void trace_net(int net, bool level, uint64_t at)
+{
+    for (int i = 0; i < trace.count; i++)
+    {
+        if (net_of(trace.pins[i]) != net)
+        {
+            continue;
+        }
+        if (at != trace.time)
+        {
+            fprintf(trace.file, "#%llu\n", (unsigned long long)at);
+            trace.time = at;
+        }
+        fputs(trace.lines[i][level], trace.file);
+    }
+}
+
+static void update_sio(void)
+{
+    uint32_t oe = 0, out = 0, in = 0;
+    for (unsigned int pin = 0; pin < SIM_GPIO_COUNT; pin++)
+    {
+        if (pins[pin].func == GPIO_FUNC_SIO && pins[pin].oe)
+        {
+            oe |= 1u << pin;
+        }
+        if (pins[pin].out)
+        {
+            out |= 1u << pin;
+        }
+        if (nets[pins[pin].parent].level)
+        {
+            in |= 1u << pin;
+        }
+    }
+    sio_regs.gpio_oe = oe;
+    sio_regs.gpio_out = out;
+    sio_regs.gpio_in = in;
+}
+
+// Resolve a net after a driver, pull or wire changed; latch edges and wake waiters
+static void resolve_net(int net)
+{
+    bool low = false, high = false, up = false, down = false;
+    for (unsigned int pin = 0; pin < SIM_GPIO_COUNT; pin++)
+    {
+        const pin_t *p = &pins[pin];
+        if (p->parent != net)
+        {
+            continue;
+        }
+        if (p->func == GPIO_FUNC_SIO && p->oe)
+        {
+            low |= !p->out;
+            high |= p->out;
+        }
+        low |= p->ext == 0;
+        high |= p->ext == 1;
+        up |= p->pull_up || p->ext_pull_up;
+        down |= p->pull_down;
+    }
+
+    net_t *n = &nets[net];
+    bool contended = low && high;
+    if (contended && !n->contended)
+    {
+        contentions++;
+    }
+    n->contended = contended;
+
+    bool level = n->level; // Floating nets keep their charge
+    if (low)
+    {
+        level = false;
+    }
+    else if (high)
+    {
+        level = true;
+    }
+    else if (up != down)
+    {
+        level = up;
+    }
+
+    if (level != n->level)
+    {
+        uint64_t at = now_ns();
+        n->level = level;
+        n->last_change = at;
+        if (trace.file != NULL)
+        {
+            trace_net(net, level, at);
+        }
+        uint32_t edge = level ? GPIO_IRQ_EDGE_RISE : GPIO_IRQ_EDGE_FALL;
+
+        for (unsigned int pin = 0; pin < SIM_GPIO_COUNT; pin++)
+        {
+            if (pins[pin].parent != net)
+            {
+                continue;
+            }
+            pins[pin].raw |= edge;
+            for (int c = 0; c < 2; c++)
+            {
+                if (irq_deliverable(&cores[c]))
+                {
+                    wake(cores[c].co, at);
+                }
+            }
+            for (int i = 0; i < coroutine_count; i++)
+            {
+                coroutine_t *co = &coroutines[i];
+                if (co->watch_pin >= 0 && net_of((unsigned int)co->watch_pin) == net &&
+                    co->watch_level == level && !co->watch_hit)
+                {
+                    co->watch_hit = true;
+                    co->watch_at = at;
+                    wake(co, at);
+                }
+            }
+        }
+    }
+    update_sio();
+}
+
+static void pin_changed(unsigned int pin)
+{
+    resolve_net(pins[pin].parent);
+}
+
+static bool check_pin(unsigned int pin)
+{
+    if (pin >= SIM_GPIO_COUNT)
+    {
+        fprintf(stderr, "sim: GPIO %u out of range\n", pin);
+        abort();
+    }
+    return true;
+}
+
+// ============================================================================
+// Simulator API
+// ============================================================================
+
+void sim_reset(void)
+{
+    sim_trace_close(); // Time starts over
+    for (int i = 0; i < coroutine_count; i++)
+    {
+        free(coroutines[i].stack);
+    }
+    memset(coroutines, 0, sizeof(coroutines));
+    coroutine_count = 0;
+    current = NULL;
+    main_now = 0;
+
+    memset(cores, 0, sizeof(cores));
+    for (unsigned int pin = 0; pin < SIM_GPIO_COUNT; pin++)
+    {
+        // Reset state of a bank 0 pad: no function, input, pull-down
+        pins[pin] = (pin_t){.func = GPIO_FUNC_NULL, .pull_down = true, .ext = SIM_RELEASE, .parent = (int)pin};
+        nets[pin] = (net_t){0};
+    }
+    contentions = 0;
+    sys_hz = 125000000;
+    putchar_hook = NULL;
+    update_sio();
+}
+
+void sim_spawn(const char *name, sim_role_t role, sim_entry_t entry, void *arg)
+{
+    spawn(name, role, entry, arg, false);
+}
+
+bool sim_run(uint32_t limit_us)
+{
+    uint64_t deadline = main_now + (uint64_t)limit_us * 1000;
+    run_deadline = deadline;
+    bool idle = true;
+    for (int i = 0; i < coroutine_count; i++)
+    {
+        idle &= coroutines[i].state == CO_DONE || coroutines[i].background;
+    }
+
+    while (1)
+    {
+        bool foreground = false;
+        coroutine_t *next = NULL;
+        for (int i = 0; i < coroutine_count; i++)
+        {
+            coroutine_t *co = &coroutines[i];
+            foreground |= co->state != CO_DONE && !co->background;
+            if (next_time(co) != SIM_NEVER && (next == NULL || next_time(co) < next_time(next)))
+            {
+                next = co;
+            }
+        }
+        if (!foreground && !idle)
+        {
+            run_deadline = SIM_NEVER;
+            return true;
+        }
+        if (next == NULL || next_time(next) > deadline)
+        {
+            // Out of time, or every coroutine sleeps forever
+            main_now = deadline;
+            run_deadline = SIM_NEVER;
+            return idle;
+        }
+
+        if (next->state == CO_WAITING)
+        {
+            next->now = next->wake_at > next->now ? next->wake_at : next->now;
+            next->state = CO_READY;
+        }
+        if (next->now > main_now)
+        {
+            main_now = next->now;
+        }
+        current = next;
+        swapcontext(&scheduler_ctx, &next->ctx);
+        current = NULL;
+    }
+}
+
+uint64_t sim_now_ns(void)
+{
+    return now_ns();
+}
+
+void sim_advance_ns(uint64_t ns)
+{
+    main_now += ns;
+}
+
+void sim_delay_ns(uint64_t ns)
+{
+    wait_until(now_ns() + ns, false);
+}
+
+bool sim_wait_level(unsigned int pin, bool level, uint64_t timeout_ns, uint64_t *at_ns)
+{
+    check_pin(pin);
+    co_sync();
+    if (nets[net_of(pin)].level == level)
+    {
+        if (at_ns)
+        {
+            *at_ns = now_ns();
+        }
+        return true;
+    }
+    if (current == NULL)
+    {
+        return false;
+    }
+
+    current->watch_pin = (int)pin;
+    current->watch_level = level;
+    current->watch_hit = false;
+    wait_until(now_ns() + timeout_ns, false);
+    current->watch_pin = -1;
+
+    if (current->watch_hit && at_ns)
+    {
+        *at_ns = current->watch_at;
+    }
+    return current->watch_hit;
+}
+
+bool sim_core1_running(void)
+{
+    return cores[1].co != NULL;
+}
+
+void sim_connect(unsigned int a, unsigned int b)
+{
+    check_pin(a);
+    check_pin(b);
+    int na = net_of(a), nb = net_of(b);
+    if (na == nb)
+    {
+        return;
+    }
+    for (unsigned int pin = 0; pin < SIM_GPIO_COUNT; pin++)
+    {
+        if (pins[pin].parent == nb)
+        {
+            pins[pin].parent = na;
+        }
+    }
+    resolve_net(na);
+}
+
+void sim_pull_up(unsigned int pin)
+{
+    check_pin(pin);
+    pins[pin].ext_pull_up = true;
+    pin_changed(pin);
+}
+
+void sim_drive(unsigned int pin, int level)
+{
+    check_pin(pin);
+    co_sync();
+    pins[pin].ext = level;
+    pin_changed(pin);
+}
+
+bool sim_level(unsigned int pin)
+{
+    check_pin(pin);
+    co_sync();
+    return nets[net_of(pin)].level;
+}
+
+uint64_t sim_last_change_ns(unsigned int pin)
+{
+    check_pin(pin);
+    return nets[net_of(pin)].last_change;
+}
+
+uint32_t sim_contention_count(void)
+{
+    return contentions;
+}
+
+bool sim_pin_output(unsigned int pin)
+{
+    return pins[pin].func == GPIO_FUNC_SIO && pins[pin].oe;
+}
+
+bool sim_pin_pull_up(unsigned int pin)
+{
+    return pins[pin].pull_up;
+}
+
+bool sim_pin_pull_down(unsigned int pin)
+{
+    return pins[pin].pull_down;
+}
+
+int sim_pin_function(unsigned int pin)
+{
+    return pins[pin].func;
+}
+
+void sim_set_costs(const sim_costs_t *new_costs)
+{
+    costs = *new_costs;
+}
+
+uint32_t sim_sys_hz(void)
+{
+    return sys_hz;
+}
+
+void sim_set_putchar(int (*fn)(int c))
+{
+    putchar_hook = fn;
+}
+
+bool sim_trace_open(const char *path, const unsigned int *trace_pins, const char *const *names, int count)
+{
+    sim_trace_close();
+    if (count > SIM_TRACE_MAX)
+    {
+        count = SIM_TRACE_MAX;
+    }
+    FILE *file = fopen(path, "w");
+    if (file == NULL)
+    {
+        perror(path);
+        return false;
+    }
+    setvbuf(file, NULL, _IOFBF, 1 << 20);
+
+    fprintf(file, "$timescale 1ns $end\n$scope module psx $end\n");
+    for (int i = 0; i < count; i++)
+    {
+        char code = (char)(33 + i);
+        check_pin(trace_pins[i]);
+        trace.pins[i] = trace_pins[i];
+        snprintf(trace.lines[i][0], sizeof(trace.lines[i][0]), "0%c\n", code);
+        snprintf(trace.lines[i][1], sizeof(trace.lines[i][1]), "1%c\n", code);
+        fprintf(file, "$var wire 1 %c %s $end\n", code, names[i]);
+    }
+    fprintf(file, "$upscope $end\n$enddefinitions $end\n");
+
+    // Current levels, then only changes
+    trace.time = now_ns();
+    fprintf(file, "#%llu\n", (unsigned long long)trace.time);
+    for (int i = 0; i < count; i++)
+    {
+        fputs(trace.lines[i][nets[net_of(trace_pins[i])].level], file);
+    }
+    trace.file = file;
+    trace.count = count;
+    return true;
+}
+
+void sim_trace_close(void)
+{
+    if (trace.file == NULL)
+    {
+        return;
+    }
+    uint64_t at = now_ns();
+    if (at > trace.time)
+    {
+        fprintf(trace.file, "#%llu\n", (unsigned long long)at);
+    }
+    fclose(trace.file);
+    trace.file = NULL;
+    trace.count = 0;
+}
+
+// ============================================================================
+// SDK: GPIO
+// ============================================================================
+
+void gpio_init(uint gpio)
+{
+    check_pin(gpio);
+    tick(costs.sdk_call);
+    pins[gpio].oe = false;
+    pins[gpio].out = false;
+    pins[gpio].func = GPIO_FUNC_SIO;
+    pin_changed(gpio);
+}
+
+void gpio_deinit(uint gpio)
+{
+    check_pin(gpio);
+    tick(costs.sdk_call);
+    pins[gpio].func = GPIO_FUNC_NULL;
+    pin_changed(gpio);
+}
+
+void gpio_set_function(uint gpio, int fn)
+{
+    check_pin(gpio);
+    tick(costs.sdk_call);
+    pins[gpio].func = fn;
+    pin_changed(gpio);
+}
+
+void gpio_set_dir(uint gpio, bool out)
+{
+    check_pin(gpio);
+    tick(costs.pin_access);
+    pins[gpio].oe = out;
+    pin_changed(gpio);
+}
+
+void gpio_put(uint gpio, bool value)
+{
+    check_pin(gpio);
+    tick(costs.pin_access);
+    pins[gpio].out = value;
+    pin_changed(gpio);
+}
+
+bool gpio_get(uint gpio)
+{
+    check_pin(gpio);
+    tick(costs.pin_access);
+    return nets[pins[gpio].parent].level;
+}
+
+uint32_t gpio_get_all(void)
+{
+    tick(costs.pin_access);
+    return sio_regs.gpio_in;
+}
+
+void gpio_pull_up(uint gpio)
+{
+    check_pin(gpio);
+    tick(costs.sdk_call);
+    pins[gpio].pull_up = true;
+    pins[gpio].pull_down = false;
+    pin_changed(gpio);
+}
+
+void gpio_pull_down(uint gpio)
+{
+    check_pin(gpio);
+    tick(costs.sdk_call);
+    pins[gpio].pull_up = false;
+    pins[gpio].pull_down = true;
+    pin_changed(gpio);
+}
+
+void gpio_disable_pulls(uint gpio)
+{
+    check_pin(gpio);
+    tick(costs.sdk_call);
+    pins[gpio].pull_up = false;
+    pins[gpio].pull_down = false;
+    pin_changed(gpio);
+}
+
+void gpio_set_irq_enabled(uint gpio, uint32_t events, bool enabled)
+{
+    check_pin(gpio);
+    tick(costs.sdk_call);
+    core_t *core = core_of(current);
+    if (enabled)
+    {
+        // As the SDK: stale edges are cleared before enabling
+        pins[gpio].raw &= ~events;
+        core->inte[gpio] |= events;
+    }
+    else
+    {
+        core->inte[gpio] &= ~events;
+    }
+}
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t events, bool enabled,
+                                        gpio_irq_callback_t callback)
+{
+    core_of(current)->callback = callback;
+    gpio_set_irq_enabled(gpio, events, enabled);
+}
+
+void gpio_acknowledge_irq(uint gpio, uint32_t events)
+{
+    check_pin(gpio);
+    tick(costs.pin_access);
+    pins[gpio].raw &= ~events;
+}
+
+// ============================================================================
+// SDK: Time
+// ============================================================================
+
+uint64_t time_us_64(void)
+{
+    tick(costs.timer_read);
+    return now_ns() / 1000;
+}
+
+uint32_t time_us_32(void)
+{
+    return (uint32_t)time_us_64();
+}
+
+void busy_wait_us_32(uint32_t delay_us)
+{
+    wait_until(now_ns() + (uint64_t)delay_us * 1000, false);
+}
+
+void busy_wait_at_least_cycles(uint32_t minimum_cycles)
+{
+    wait_until(now_ns() + cycles_to_ns(minimum_cycles), false);
+}
+
+void sleep_us(uint64_t us)
+{
+    wait_until(now_ns() + us * 1000, false);
+}
+
+void sleep_ms(uint32_t ms)
+{
+    sleep_us((uint64_t)ms * 1000);
+}
+
+absolute_time_t get_absolute_time(void)
+{
+    return time_us_64();
+}
+
+absolute_time_t make_timeout_time_us(uint64_t us)
+{
+    return time_us_64() + us;
+}
+
+bool best_effort_wfe_or_timeout(absolute_time_t timeout_timestamp)
+{
+    core_t *core = core_of(current);
+    if (core->event)
+    {
+        core->event = false;
+        return false;
+    }
+    wait_until(timeout_timestamp * 1000, true);
+    core->event = false;
+    return now_ns() >= timeout_timestamp * 1000;
+}
+
+// ============================================================================
+// SDK: Processor
+// ============================================================================
+
+void __dmb(void)
+{
+    atomic_thread_fence(memory_order_seq_cst);
+    tick(1);
+}
+
+void __dsb(void)
+{
+    __dmb();
+}
+
+void __isb(void)
+{
+    __dmb();
+}
+
+void __compiler_memory_barrier(void)
+{
+    atomic_signal_fence(memory_order_seq_cst);
+}
+
+void __wfe(void)
+{
+    core_t *core = core_of(current);
+    tick(1);
+    if (core == NULL)
+    {
+        return;
+    }
+    if (core->event)
+    {
+        core->event = false;
+        return;
+    }
+    wait_until(SIM_NEVER, true);
+    core->event = false;
+}
+
+void __sev(void)
+{
+    tick(1);
+    uint64_t at = now_ns();
+    for (int c = 0; c < 2; c++)
+    {
+        cores[c].event = true;
+        if (cores[c].co != NULL && cores[c].co->in_wfe)
+        {
+            wake(cores[c].co, at);
+        }
+    }
+}
+
+uint32_t save_and_disable_interrupts(void)
+{
+    core_t *core = core_of(current);
+    tick(2);
+    if (core == NULL)
+    {
+        return 0;
+    }
+    uint32_t status = core->masked;
+    core->masked = true;
+    return status;
+}
+
+void restore_interrupts(uint32_t status)
+{
+    core_t *core = core_of(current);
+    tick(2);
+    if (core == NULL)
+    {
+        return;
+    }
+    core->masked = status != 0;
+    if (current != NULL)
+    {
+        take_irqs();
+    }
+}
+
+systick_hw_t *sim_systick_hw(void)
+{
+    core_t *core = core_of(current);
+    tick(costs.pin_access);
+
+    uint64_t now = now_ns();
+    if (core->systick.cvr != core->systick_shown)
+    {
+        // Any write clears the counter; it reloads on the next cycle
+        core->systick_base = now;
+    }
+    if (core->systick.csr & 1u)
+    {
+        uint64_t cycles = (now - core->systick_base) * sys_hz / 1000000000ull;
+        uint32_t reload = core->systick.rvr & 0x00FFFFFFu;
+        core->systick.cvr = cycles == 0 ? 0 : reload - (uint32_t)((cycles - 1) % ((uint64_t)reload + 1));
+    }
+    core->systick_shown = core->systick.cvr;
+    return &core->systick;
+}
+
+// ============================================================================
+// SDK: Multicore, Clocks and stdio
+// ============================================================================
+
+static void core1_trampoline(void *arg)
+{
+    void (*entry)(void) = (void (*)(void))arg;
+    entry();
+}
+
+void multicore_launch_core1(void (*entry)(void))
+{
+    tick(costs.sdk_call);
+    spawn("core1", SIM_CORE1, core1_trampoline, (void *)entry, true);
+}
+
+void multicore_reset_core1(void)
+{
+    tick(costs.sdk_call);
+    coroutine_t *co = cores[1].co;
+    if (co == NULL)
+    {
+        return;
+    }
+    if (co == current)
+    {
+        fprintf(stderr, "sim: core 1 reset itself\n");
+        abort();
+    }
+    // Its stack is simply never resumed
+    co->state = CO_DONE;
+    co->watch_pin = -1;
+    cores[1].co = NULL;
+    cores[1].masked = false;
+    cores[1].in_handler = false;
+    cores[1].event = false;
+    memset(&cores[1].systick, 0, sizeof(cores[1].systick));
+    cores[1].systick_shown = 0;
+}
+
+uint get_core_num(void)
+{
+    return (current != NULL && current->role == SIM_CORE1) ? 1 : 0;
+}
+
+bool set_sys_clock_khz(uint32_t freq_khz, bool required)
+{
+    (void)required;
+    tick(costs.sdk_call);
+    sys_hz = freq_khz * 1000;
+    return true;
+}
+
+void vreg_set_voltage(enum vreg_voltage voltage)
+{
+    (void)voltage;
+}
+
+uint32_t clock_get_hz(enum clock_index clk_index)
+{
+    switch (clk_index)
+    {
+    case clk_ref:
+        return 12000000;
+    case clk_usb:
+        return 48000000;
+    default:
+        return sys_hz;
+    }
+}
+
+void stdio_init_all(void)
+{
+}
+
+int getchar_timeout_us(uint32_t timeout_us)
+{
+    (void)timeout_us;
+    return PICO_ERROR_TIMEOUT;
+}
+
+int putchar_raw(int c)
+{
+    return putchar_hook ? putchar_hook(c) : putchar(c);
+}
+
+void stdio_flush(void)
+{
+    fflush(stdout);
+}
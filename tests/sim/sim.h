@@ -0,0 +1,151 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ============================================================================
+// RP2040 Bus Simulator for Host Tests
+// ============================================================================
+//
+// The firmware runs unmodified against the sdk/ headers. Each core and each
+// external device (e.g. a console) is a coroutine with its own simulated
+// clock. Every SDK call costs a few cycles and first lets any coroutine that
+// is behind catch up, so pin reads and writes of all coroutines happen in
+// global time order. Everything runs on one host thread and is deterministic.
+//
+// Only the modelled SDK calls cost time; plain C between them is free, so
+// latencies are lower than on hardware. Compare results with each other
+// rather than with oscilloscope readings.
+
+#define SIM_GPIO_COUNT 30
+
+// Who a coroutine is: a core gets that core's IRQs, SysTick and interrupt
+// mask; an external device only drives and reads pins
+typedef enum
+{
+    SIM_EXTERNAL = -1,
+    SIM_CORE0 = 0,
+    SIM_CORE1 = 1,
+} sim_role_t;
+
+typedef void (*sim_entry_t)(void *arg);
+
+// Level argument of sim_drive() that stops driving the pin
+#define SIM_RELEASE (-1)
+
+// ============================================================================
+// Setup and Scheduling
+// ============================================================================
+
+// Forget all coroutines and return every pin, IRQ and the clock to reset state
+void sim_reset(void);
+
+// Start a coroutine at the current time. sim_run() returns once all
+// coroutines started this way have returned.
+void sim_spawn(const char *name, sim_role_t role, sim_entry_t entry, void *arg);
+
+// Run until all spawned coroutines have returned (true) or limit_us of
+// simulated time has passed / nothing can make progress (false).
+// Core 1 started with multicore_launch_core1() keeps running in the
+// background and is resumed by the next sim_run(); with nothing spawned,
+// sim_run() lets it run for limit_us and returns true.
+bool sim_run(uint32_t limit_us);
+
+// Current simulated time of the calling coroutine (ns)
+uint64_t sim_now_ns(void);
+
+// Move the time seen outside sim_run() forward (ns)
+void sim_advance_ns(uint64_t ns);
+
+// Wait inside a coroutine (interrupts are still taken)
+void sim_delay_ns(uint64_t ns);
+
+// Wait until a pin reaches the level or timeout_ns passes.
+// Returns true with the time of the edge in *at_ns (may be NULL).
+bool sim_wait_level(unsigned int pin, bool level, uint64_t timeout_ns, uint64_t *at_ns);
+
+// True while Core 1 is running (launched and not reset)
+bool sim_core1_running(void);
+
+// ============================================================================
+// Board Wiring and External Drivers
+// ============================================================================
+
+// Wire two GPIOs together (e.g. self-test jumpers)
+void sim_connect(unsigned int a, unsigned int b);
+
+// External pull-up resistor on a pin's net
+void sim_pull_up(unsigned int pin);
+
+// Drive a pin from outside the RP2040 (0, 1 or SIM_RELEASE)
+void sim_drive(unsigned int pin, int level);
+
+// Level of a pin's net
+bool sim_level(unsigned int pin);
+
+// Time of the last level change of a pin's net (ns)
+uint64_t sim_last_change_ns(unsigned int pin);
+
+// Number of times two drivers fought over a net
+uint32_t sim_contention_count(void);
+
+// ============================================================================
+// Pin Inspection
+// ============================================================================
+
+bool sim_pin_output(unsigned int pin);  // Output enabled by the firmware
+bool sim_pin_pull_up(unsigned int pin);
+bool sim_pin_pull_down(unsigned int pin);
+int sim_pin_function(unsigned int pin); // GPIO_FUNC_* value
+
+// ============================================================================
+// Clock and Cost Model
+// ============================================================================
+
+// CPU cycles charged for SDK GPIO accesses, timer reads and other calls
+typedef struct
+{
+    uint32_t pin_access;
+    uint32_t timer_read;
+    uint32_t sdk_call;
+    uint32_t irq_entry;
+} sim_costs_t;
+
+void sim_set_costs(const sim_costs_t *costs);
+uint32_t sim_sys_hz(void);
+
+// Characters sent with putchar_raw() go here (NULL = stdout)
+void sim_set_putchar(int (*fn)(int c));
+
+// ============================================================================
+// Waveform Trace
+// ============================================================================
+
+#define SIM_TRACE_MAX 8
+
+// Stream the level changes of up to SIM_TRACE_MAX pins' nets to a VCD file
+// (1 ns timescale, same layout as tools/psx_vcd.py) for GTKWave. sim_reset()
+// closes it, since time starts over.
+bool sim_trace_open(const char *path, const unsigned int *pins, const char *const *names, int count);
+void sim_trace_close(void);
+
+#endif // SIM_H
@@ -0,0 +1,66 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef TEST_H
+#define TEST_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// Minimal Test Helpers
+// ============================================================================
+
+static int test_failures = 0;
+
+// Record a failure and keep going
+#define CHECK(cond)                                                             \
+    do                                                                          \
+    {                                                                           \
+        if (!(cond))                                                            \
+        {                                                                       \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            test_failures++;                                                    \
+        }                                                                       \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                              \
+    do                                                                          \
+    {                                                                           \
+        long long a_ = (long long)(actual), e_ = (long long)(expected);         \
+        if (a_ != e_)                                                           \
+        {                                                                       \
+            fprintf(stderr, "%s:%d: %s = %lld, expected %lld\n", __FILE__, __LINE__, \
+                    #actual, a_, e_);                                           \
+            test_failures++;                                                    \
+        }                                                                       \
+    } while (0)
+
+// Run one test function and report it
+#define RUN(test)                                                               \
+    do                                                                          \
+    {                                                                           \
+        int before_ = test_failures;                                            \
+        test();                                                                 \
+        printf("%s %s\n", test_failures == before_ ? "ok  " : "FAIL", #test);   \
+    } while (0)
+
+#define TEST_EXIT() (test_failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE)
+
+#endif // TEST_H
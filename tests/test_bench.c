@@ -0,0 +1,168 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Hot-path benchmark on the simulated board: CSV output of every case,
+// idle-bus cases skipped while the console selects us, and Core 1 back on
+// the bus afterwards
+
+#include "test.h"
+#include "sim.h"
+#include "console.h"
+#include "firmware.h"
+#include "config.h"
+#include "bench.h"
+#include "psx_bitbang.h"
+#include "shared_state.h"
+#include "log_queue.h"
+#include <unistd.h>
+
+static const struct
+{
+    const char *name;
+    bool idle_bus;
+} expected_cases[] = {
+    {"psx_wait_clk_rising_idle", true},
+    {"psx_wait_clk_falling_poll", true},
+    {"psx_transfer_byte_abort", true},
+    {"psx_send_ack", true},
+    {"shared_state_write", false},
+    {"shared_state_read", false},
+    {"button_read_byte1", false},
+    {"button_read_byte2", false},
+    {"socd_apply", false},
+    {"socd_resolve_latched", false},
+    {"log_push", false},
+    {"psx_device_dispatch", false},
+};
+
+#define CASE_COUNT (sizeof(expected_cases) / sizeof(expected_cases[0]))
+
+static char output[8192];
+
+static void bench_task(void *arg)
+{
+    bench_run();
+}
+
+// bench_run() on Core 0 with stdout going to output[]
+static void run_bench(void)
+{
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    FILE *capture = tmpfile();
+    dup2(fileno(capture), STDOUT_FILENO);
+
+    sim_spawn("core0", SIM_CORE0, bench_task, NULL);
+    CHECK(sim_run(10000000));
+
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+    rewind(capture);
+    size_t len = fread(output, 1, sizeof(output) - 1, capture);
+    output[len] = '\0';
+    fclose(capture);
+}
+
+// Parse "BENCH,<name>,<iterations>,<min>,<avg>,<max>,<avg ns>"; false if missing
+static bool find_case(const char *name, unsigned long values[5])
+{
+    char key[64];
+    snprintf(key, sizeof(key), "\nBENCH,%s,", name);
+    const char *line = strstr(output, key);
+    if (line == NULL)
+    {
+        return false;
+    }
+    memset(values, 0, 5 * sizeof(values[0]));
+    sscanf(line + strlen(key), "%lu,%lu,%lu,%lu,%lu", &values[0], &values[1], &values[2], &values[3], &values[4]);
+    return true;
+}
+
+static void console_task(void *arg)
+{
+    console_t console = console_default(0);
+    console_poll(&console, arg);
+}
+
+static bool answers(void)
+{
+    console_result_t result;
+    shared_state_write(0, 0xFE, 0xFF);
+    sim_run(1000); // Core 1 relaunched at the end of the run
+    sim_spawn("console", SIM_EXTERNAL, console_task, &result);
+    CHECK(sim_run(100000));
+    return result.len == 5 && result.dat[1] == 0x41 && result.dat[3] == 0xFE && !result.driven_after_sel;
+}
+
+static void test_idle_bus(void)
+{
+    firmware_boot();
+    run_bench();
+
+    CHECK(strstr(output, "BENCH,clk_sys,125000000\n") != NULL);
+    CHECK(strstr(output, "BENCH,case,iterations,min_cycles,avg_cycles,max_cycles,avg_ns\n") != NULL);
+
+    for (size_t i = 0; i < CASE_COUNT; i++)
+    {
+        unsigned long v[5];
+        if (!find_case(expected_cases[i].name, v))
+        {
+            fprintf(stderr, "no line for %s\n", expected_cases[i].name);
+            test_failures++;
+            continue;
+        }
+        CHECK_EQ(v[0], BENCH_ITERATIONS);
+        CHECK(v[1] <= v[2] && v[2] <= v[3]);
+        CHECK_EQ(v[4], v[2] * 1000000000ull / 125000000);
+    }
+
+    // The log_push case leaves nothing behind, and Core 1 is back
+    CHECK_EQ(log_flush(LOG_QUEUE_SIZE), 0);
+    CHECK(sim_core1_running());
+    CHECK(answers());
+}
+
+static void test_console_selecting(void)
+{
+    firmware_boot();
+    const psx_port_pins_t *pins = &psx_port_pins[0];
+    sim_drive(pins->sel, 0);
+    uint32_t contention = sim_contention_count();
+    run_bench();
+
+    // The bus cases never ran; the others did
+    for (size_t i = 0; i < CASE_COUNT; i++)
+    {
+        unsigned long v[5];
+        CHECK(find_case(expected_cases[i].name, v));
+        CHECK_EQ(v[0], expected_cases[i].idle_bus ? 0 : BENCH_ITERATIONS);
+    }
+    CHECK(sim_level(pins->dat) && sim_level(pins->ack));
+    CHECK_EQ(sim_contention_count(), contention);
+
+    sim_drive(pins->sel, 1);
+    CHECK(answers());
+}
+
+int main(void)
+{
+    RUN(test_idle_bus);
+    RUN(test_console_selecting);
+    return TEST_EXIT();
+}
@@ -0,0 +1,163 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Button remap table: which GPIOs may be buttons, and pin setup when the
+// active map changes
+
+#include "test.h"
+#include "sim.h"
+#include "button_input.h"
+#include "config.h"
+#include "hardware/gpio.h"
+
+static bool is_button_input(uint8_t gpio)
+{
+    return sim_pin_function(gpio) == GPIO_FUNC_SIO && !sim_pin_output(gpio) && sim_pin_pull_up(gpio);
+}
+
+static bool is_released(uint8_t gpio)
+{
+    return sim_pin_function(gpio) == GPIO_FUNC_NULL && !sim_pin_pull_up(gpio);
+}
+
+static void test_valid_pins(void)
+{
+    CHECK(button_gpio_valid(BTN_UNASSIGNED));
+    CHECK(button_gpio_valid(BTN_CROSS));
+    CHECK(!button_gpio_valid(NUM_BANK0_GPIOS));
+
+    static const uint8_t bus[] = {PIN_DAT, PIN_CMD, PIN_SEL, PIN_CLK, PIN_ACK, LED_PIN};
+    for (unsigned i = 0; i < sizeof(bus); i++)
+    {
+        CHECK(!button_gpio_valid(bus[i]));
+    }
+
+#if PSX_PORT_COUNT > 1
+    static const uint8_t port2[] = {PIN2_DAT, PIN2_CMD, PIN2_SEL, PIN2_CLK, PIN2_ACK};
+    for (unsigned i = 0; i < sizeof(port2); i++)
+    {
+        CHECK(!button_gpio_valid(port2[i]));
+    }
+    // No self-test in a dual-port build: its two pins outside port 2 are free
+    CHECK(button_gpio_valid(SELFTEST_PIN_SEL));
+    CHECK(button_gpio_valid(SELFTEST_PIN_CLK));
+#else
+    static const uint8_t selftest[] = {SELFTEST_PIN_SEL, SELFTEST_PIN_CLK, SELFTEST_PIN_CMD, SELFTEST_PIN_DAT,
+                                       SELFTEST_PIN_ACK};
+    for (unsigned i = 0; i < sizeof(selftest); i++)
+    {
+        CHECK(!button_gpio_valid(selftest[i]));
+    }
+    CHECK(!button_map_set(0, PSX_BTN_L3, SELFTEST_PIN_DAT));
+#endif
+}
+
+static void test_default_map(void)
+{
+    sim_reset();
+    button_input_init();
+
+    for (int i = 0; i < PSX_BTN_COUNT; i++)
+    {
+        uint8_t gpio = button_map_default.gpio[i];
+        if (gpio != BTN_UNASSIGNED)
+        {
+            CHECK(is_button_input(gpio));
+        }
+    }
+    CHECK_EQ(button_read_all(), 0xFFFF);
+
+    sim_drive(BTN_CROSS, 0);
+    sim_drive(BTN_START, 0);
+    CHECK_EQ(button_read_all(), 0xFFFF & ~(1u << PSX_BTN_CROSS) & ~(1u << PSX_BTN_START));
+    CHECK_EQ(button_read_byte1(), 0xFF & ~(1u << PSX_BTN_START));
+    CHECK_EQ(button_read_byte2(), 0xFF & ~(1u << (PSX_BTN_CROSS - 8)));
+}
+
+static void test_remap_releases_dropped_pin(void)
+{
+    sim_reset();
+    button_input_init();
+
+    CHECK(button_map_set(0, PSX_BTN_CROSS, 23));
+    CHECK(is_button_input(23));
+    CHECK(is_released(BTN_CROSS));
+
+    sim_drive(23, 0);
+    CHECK_EQ(button_read_all(), 0xFFFF & ~(1u << PSX_BTN_CROSS));
+    sim_drive(BTN_CROSS, 0); // Old pin no longer reads as a button
+    CHECK_EQ(button_read_all(), 0xFFFF & ~(1u << PSX_BTN_CROSS));
+    sim_drive(23, SIM_RELEASE);
+    sim_drive(BTN_CROSS, SIM_RELEASE);
+
+    // Unassigning releases the pin too
+    CHECK(button_map_set(0, PSX_BTN_CROSS, BTN_UNASSIGNED));
+    CHECK(is_released(23));
+    CHECK_EQ(button_read_all(), 0xFFFF);
+}
+
+static void test_shared_pin_kept(void)
+{
+    sim_reset();
+    button_input_init();
+
+    // Two buttons on one pin: dropping one keeps the pin configured
+    CHECK(button_map_set(0, PSX_BTN_L3, BTN_SQUARE));
+    CHECK(button_map_set(0, PSX_BTN_SQUARE, 23));
+    CHECK(is_button_input(BTN_SQUARE));
+    sim_drive(BTN_SQUARE, 0);
+    CHECK_EQ(button_read_all(), 0xFFFF & ~(1u << PSX_BTN_L3));
+}
+
+static void test_profile_switch(void)
+{
+    sim_reset();
+    button_input_init();
+
+    button_map_t map = button_map_default;
+    map.gpio[PSX_BTN_TRIANGLE] = 23;
+    map.gpio[PSX_BTN_CIRCLE] = BTN_UNASSIGNED;
+    CHECK(button_map_load(1, &map));
+    CHECK(is_released(23)); // Profile 1 isn't active yet
+
+    CHECK(button_map_select(1));
+    CHECK(is_button_input(23));
+    CHECK(is_released(BTN_TRIANGLE));
+    CHECK(is_released(BTN_CIRCLE));
+    CHECK(is_button_input(BTN_CROSS));
+
+    CHECK(button_map_select(0));
+    CHECK(is_released(23));
+    CHECK(is_button_input(BTN_TRIANGLE));
+    CHECK(is_button_input(BTN_CIRCLE));
+
+    // A map with an invalid pin is refused as a whole
+    map.gpio[PSX_BTN_CROSS] = PIN_SEL;
+    CHECK(!button_map_load(0, &map));
+    CHECK_EQ(button_map_get(0)->gpio[PSX_BTN_TRIANGLE], BTN_TRIANGLE);
+}
+
+int main(void)
+{
+    RUN(test_valid_pins);
+    RUN(test_default_map);
+    RUN(test_remap_releases_dropped_pin);
+    RUN(test_shared_pin_kept);
+    RUN(test_profile_switch);
+    return TEST_EXIT();
+}
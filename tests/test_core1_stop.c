@@ -0,0 +1,209 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Stopping Core 1: the park handshake between transactions, and a plain
+// reset at any point of a transaction leaving the statistics readable
+
+#include "test.h"
+#include "sim.h"
+#include "console.h"
+#include "firmware.h"
+#include "config.h"
+#include "psx_protocol.h"
+#include "psx_bitbang.h"
+#include "pico/multicore.h"
+#include "hardware/sync.h"
+
+#define POLL_GAP_NS 300000
+
+typedef struct
+{
+    int polls;
+    int answered;     // Polls answered with 0x5A
+    uint64_t end_ns;  // SEL rise of the first poll
+} poller_t;
+
+static void poller_task(void *arg)
+{
+    poller_t *poller = arg;
+    console_t console = console_default(0);
+    for (int i = 0; i < poller->polls; i++)
+    {
+        console_result_t result;
+        console_poll(&console, &result);
+        poller->answered += result.len == 5 && result.dat[2] == 0x5A;
+        if (i == 0)
+        {
+            poller->end_ns = result.end_ns;
+        }
+        sim_delay_ns(POLL_GAP_NS);
+    }
+}
+
+// ============================================================================
+// Park Handshake
+// ============================================================================
+
+typedef struct
+{
+    uint64_t stop_at_ns;
+    bool parked;
+    bool bus_driven;
+    psx_stats_t stats;
+} stopper_t;
+
+static void stopper_task(void *arg)
+{
+    stopper_t *stopper = arg;
+    sim_delay_ns(stopper->stop_at_ns - sim_now_ns());
+    stopper->parked = psx_protocol_park(PSX_PARK_TIMEOUT_US);
+    multicore_reset_core1();
+
+    const psx_port_pins_t *pins = &psx_port_pins[0];
+    stopper->bus_driven = sim_pin_output(pins->dat) || sim_pin_output(pins->ack);
+    psx_get_stats(0, &stopper->stats);
+}
+
+static void test_park_between_transactions(void)
+{
+    // Stop requests at several points of the third poll
+    for (uint64_t offset = 0; offset < 250000; offset += 25000)
+    {
+        poller_t poller = {.polls = 6};
+        stopper_t stopper = {.stop_at_ns = 100000 + 2 * POLL_GAP_NS + offset};
+
+        firmware_boot();
+        psx_reset_stats();
+        sim_spawn("console", SIM_EXTERNAL, poller_task, &poller);
+        sim_spawn("stop", SIM_CORE0, stopper_task, &stopper);
+        CHECK(sim_run(50000));
+
+        // Every poll the console saw answered was counted, none cut short
+        CHECK(stopper.parked);
+        CHECK(!stopper.bus_driven);
+        CHECK(poller.answered >= 2 && poller.answered <= 4);
+        CHECK_EQ(stopper.stats.controller_transactions, poller.answered);
+        uint32_t errors = 0;
+        for (int i = 0; i < PSX_ERROR_COUNT; i++)
+        {
+            errors += stopper.stats.errors[i];
+        }
+        CHECK_EQ(errors, 0);
+    }
+}
+
+static void park_alone_task(void *arg)
+{
+    uint64_t *waited_ns = arg;
+    multicore_reset_core1();
+    uint64_t start = sim_now_ns();
+    CHECK(!psx_protocol_park(1000));
+    *waited_ns = sim_now_ns() - start;
+}
+
+static void test_park_without_core1(void)
+{
+    // Nothing answers: times out instead of hanging
+    uint64_t waited_ns = 0;
+    firmware_boot();
+    sim_spawn("park", SIM_CORE0, park_alone_task, &waited_ns);
+    CHECK(sim_run(10000));
+    CHECK(waited_ns >= 1000000 && waited_ns < 1100000);
+}
+
+// ============================================================================
+// Reset Without Parking
+// ============================================================================
+
+typedef struct
+{
+    uint64_t reset_at_ns;
+    void (*restart)(void);
+    bool read_done;
+} resetter_t;
+
+// Restarted Core 1 that never reaches a transaction (e.g. bus idle)
+static void core1_init_only(void)
+{
+    psx_protocol_init();
+    while (1)
+    {
+        __wfe();
+    }
+}
+
+static void resetter_task(void *arg)
+{
+    resetter_t *resetter = arg;
+    sim_delay_ns(resetter->reset_at_ns - sim_now_ns());
+    multicore_reset_core1();
+    multicore_launch_core1(resetter->restart);
+    sim_delay_ns(10000);
+
+    // Must not spin on a sequence left odd by the reset
+    psx_stats_t stats;
+    psx_get_stats(0, &stats);
+    resetter->read_done = true;
+}
+
+// Reset at every 5 ns around the end of the first poll, where Core 1
+// publishes its statistics; returns the reset points that hung the reader
+static int sweep_resets(void (*restart)(void))
+{
+    poller_t probe = {.polls = 1};
+    firmware_boot();
+    sim_spawn("console", SIM_EXTERNAL, poller_task, &probe);
+    CHECK(sim_run(50000));
+    CHECK_EQ(probe.answered, 1);
+
+    int failed = 0;
+    for (uint64_t at = probe.end_ns - 3000; at < probe.end_ns + 5000; at += 5)
+    {
+        poller_t poller = {.polls = 2};
+        resetter_t resetter = {.reset_at_ns = at, .restart = restart};
+
+        firmware_boot();
+        sim_spawn("console", SIM_EXTERNAL, poller_task, &poller);
+        sim_spawn("reset", SIM_CORE0, resetter_task, &resetter);
+        if (!sim_run(5000) || !resetter.read_done)
+        {
+            if (failed++ == 0)
+            {
+                fprintf(stderr, "  reset at %llu ns: statistics read did not return\n", (unsigned long long)at);
+            }
+        }
+    }
+    return failed;
+}
+
+static void test_reset_anywhere(void)
+{
+    // Back to the protocol task, which publishes again at once
+    CHECK_EQ(sweep_resets(core1_entry), 0);
+
+    // Only initialised: the sequence must already be even
+    CHECK_EQ(sweep_resets(core1_init_only), 0);
+}
+
+int main(void)
+{
+    RUN(test_park_between_transactions);
+    RUN(test_park_without_core1);
+    RUN(test_reset_anywhere);
+    return TEST_EXIT();
+}
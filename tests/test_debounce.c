@@ -0,0 +1,158 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Debounce / glitch filter: noisy traces against per-button windows
+
+#include "test.h"
+#include "debounce.h"
+
+#define CROSS_BIT (1u << PSX_BTN_CROSS)
+#define START_BIT (1u << PSX_BTN_START)
+
+// Raw samples of one button as a string, '0' = pressed (LOW) and '1' =
+// released; returns the filtered states in the same form
+static void filter_trace(uint16_t bit, const char *raw, char *filtered)
+{
+    for (int i = 0; raw[i]; i++)
+    {
+        uint16_t word = raw[i] == '0' ? (uint16_t)(0xFFFF & ~bit) : 0xFFFF;
+        filtered[i] = (debounce_update(word) & bit) ? '1' : '0';
+        filtered[i + 1] = '\0';
+    }
+}
+
+static void check_trace(uint8_t window, const char *raw, const char *expected, uint32_t glitches)
+{
+    char filtered[64];
+
+    debounce_init();
+    CHECK(debounce_set_window(PSX_BTN_CROSS, window));
+    filter_trace(CROSS_BIT, raw, filtered);
+    if (strcmp(filtered, expected) != 0)
+    {
+        fprintf(stderr, "  window %u raw %s: got %s, expected %s\n", window, raw, filtered, expected);
+        test_failures++;
+    }
+    CHECK_EQ(debounce_get_glitch_count(), glitches);
+}
+
+static void test_no_filter(void)
+{
+    // Windows 0 and 1 follow the input sample by sample
+    check_trace(0, "1101001", "1101001", 0);
+    check_trace(1, "1101001", "1101001", 0);
+}
+
+static void test_bouncing_press(void)
+{
+    // Contact bounce on press: one spike, then a clean edge per run of three
+    check_trace(3, "11010001111000111000011111", "11111100011110001110000111", 1);
+    // window 3 accepts on the third consecutive differing sample
+    check_trace(3, "1110001", "1111100", 0);
+}
+
+static void test_glitches_rejected(void)
+{
+    // Spikes shorter than the window never reach the output
+    check_trace(4, "1101110011100011111", "1111111111111111111", 3);
+    check_trace(15, "1000000000000001", "1111111111111111", 1);
+    check_trace(15, "10000000000000001", "11111111111111100", 0);
+}
+
+static void test_buttons_independent(void)
+{
+    debounce_init();
+    CHECK(debounce_set_window(PSX_BTN_CROSS, 3));
+    CHECK_EQ(debounce_get_window(PSX_BTN_CROSS), 3);
+    CHECK_EQ(debounce_get_window(PSX_BTN_START), 0);
+
+    // START (no filter) goes through at once while CROSS waits its window
+    uint16_t both = (uint16_t)(0xFFFF & ~(CROSS_BIT | START_BIT));
+    CHECK_EQ(debounce_update(both), 0xFFFF & ~START_BIT);
+    CHECK_EQ(debounce_update(both), 0xFFFF & ~START_BIT);
+    CHECK_EQ(debounce_update(both), both);
+}
+
+static void test_window_change_restarts(void)
+{
+    debounce_init();
+    CHECK(debounce_set_window(PSX_BTN_CROSS, 3));
+    uint16_t pressed = (uint16_t)(0xFFFF & ~CROSS_BIT);
+    debounce_update(pressed);
+    debounce_update(pressed);
+
+    // The pending change starts counting again against the new window
+    CHECK(debounce_set_window(PSX_BTN_CROSS, 2));
+    CHECK_EQ(debounce_update(pressed), 0xFFFF);
+    CHECK_EQ(debounce_update(pressed), pressed);
+
+    CHECK(!debounce_set_window(PSX_BTN_CROSS, DEBOUNCE_WINDOW_MAX + 1));
+    CHECK(!debounce_set_window(PSX_BTN_COUNT, 1));
+}
+
+static void test_all_windows(void)
+{
+    // Every window length accepts after exactly that many samples
+    for (uint8_t window = 1; window <= DEBOUNCE_WINDOW_MAX; window++)
+    {
+        debounce_init();
+        CHECK(debounce_set_window(PSX_BTN_CROSS, window));
+        uint16_t pressed = (uint16_t)(0xFFFF & ~CROSS_BIT);
+        int accepted_at = 0;
+        for (int sample = 1; sample <= 20 && accepted_at == 0; sample++)
+        {
+            if (!(debounce_update(pressed) & CROSS_BIT))
+            {
+                accepted_at = sample;
+            }
+        }
+        CHECK_EQ(accepted_at, window);
+    }
+}
+
+static void test_peek(void)
+{
+    debounce_init();
+    CHECK(debounce_set_window(PSX_BTN_CROSS, 3));
+    uint16_t both = (uint16_t)(0xFFFF & ~(CROSS_BIT | START_BIT));
+
+    // Unfiltered START follows raw at once; CROSS keeps its accepted state
+    CHECK_EQ(debounce_peek(both), 0xFFFF & ~START_BIT);
+
+    // Extra samples don't count towards CROSS's window or its glitches
+    debounce_update(both);
+    for (int i = 0; i < 10; i++)
+    {
+        CHECK_EQ(debounce_peek(both) & CROSS_BIT, CROSS_BIT);
+    }
+    debounce_update(both);
+    CHECK_EQ(debounce_update(both), both);
+    CHECK_EQ(debounce_get_glitch_count(), 0);
+}
+
+int main(void)
+{
+    RUN(test_no_filter);
+    RUN(test_bouncing_press);
+    RUN(test_glitches_rejected);
+    RUN(test_buttons_independent);
+    RUN(test_window_change_restarts);
+    RUN(test_all_windows);
+    RUN(test_peek);
+    return TEST_EXIT();
+}
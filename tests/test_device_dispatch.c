@@ -0,0 +1,140 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Every address byte through the dispatch table over the simulated bus:
+// what each device class does, and how soon Core 1 is ready again
+
+#include "test.h"
+#include "sim.h"
+#include "console.h"
+#include "firmware.h"
+#include "config.h"
+#include "psx_device.h"
+#include "psx_protocol.h"
+#include "shared_state.h"
+
+// Idle time between a transaction and the next SEL falling edge. Dispatch
+// and bus release of every address must fit in it.
+#define NEXT_SEL_GAP_NS 2000
+
+typedef struct
+{
+    console_result_t addressed[256]; // 0x<addr> 0x42 0x00 0x00 0x00
+    console_result_t follow[256];    // Controller poll right after it
+} sweep_t;
+
+static sweep_t sweep;
+
+static void console_task(void *arg)
+{
+    console_t console = console_default(0);
+    for (int addr = 0; addr < 256; addr++)
+    {
+        const uint8_t cmd[] = {(uint8_t)addr, PSX_CMD_POLL, 0x00, 0x00, 0x00};
+        console_exchange(&console, cmd, sizeof(cmd), sizeof(cmd), &sweep.addressed[addr]);
+        sim_delay_ns(NEXT_SEL_GAP_NS);
+        console_poll(&console, &sweep.follow[addr]);
+        sim_delay_ns(20000);
+    }
+}
+
+static bool answered(const console_result_t *result)
+{
+    return result->len == 5 && result->dat[1] == 0x41 && result->dat[2] == 0x5A && !result->driven_after_sel;
+}
+
+static void test_all_addresses(void)
+{
+    firmware_boot();
+    psx_reset_stats();
+    shared_state_write(0, 0xFF, 0xFF);
+
+    sim_spawn("console", SIM_EXTERNAL, console_task, NULL);
+    CHECK(sim_run(1000000));
+
+    uint32_t unknown = 0, ack_max_ns = 0;
+    for (int addr = 0; addr < 256; addr++)
+    {
+        const psx_device_t *device = psx_device_for((uint8_t)addr);
+        const console_result_t *result = &sweep.addressed[addr];
+
+        if (device != NULL && device->action == PSX_DEVICE_RESPOND)
+        {
+            CHECK(answered(result));
+            if (result->ack_delay_ns[0] > ack_max_ns)
+            {
+                ack_max_ns = result->ack_delay_ns[0];
+            }
+        }
+        else
+        {
+            // Nothing else is ACKed or driven, so the console gives up after the address
+            CHECK_EQ(result->len, 1);
+            CHECK(!result->ack[0]);
+            CHECK(!result->driven_after_sel);
+            unknown += device == NULL;
+        }
+
+        // Back in the SEL wait within the gap, whatever the address was
+        if (!answered(&sweep.follow[addr]))
+        {
+            fprintf(stderr, "address 0x%02X: next poll not answered\n", addr);
+            test_failures++;
+        }
+    }
+
+    psx_stats_t stats;
+    psx_get_stats(0, &stats);
+    CHECK_EQ(stats.total_transactions, 512);
+    CHECK_EQ(stats.invalid_transactions, unknown);
+    CHECK_EQ(stats.errors[PSX_ERROR_UNKNOWN_ADDR], unknown);
+    CHECK_EQ(stats.memcard_transactions, 1);
+    CHECK_EQ(stats.controller_transactions, 257);
+    CHECK_EQ(stats.invariant_violations, 0);
+    CHECK_EQ(stats.last_invalid_addr, 0xFE);
+
+    // Address byte to ACK of the emulated device, at 250 kHz
+    printf("     %u unknown addresses, address ACK after %u ns\n", unknown, ack_max_ns);
+    CHECK(ack_max_ns > 0 && ack_max_ns < 10000);
+}
+
+static void test_table_in_ram(void)
+{
+    // Descriptors are writable objects (RAM on the RP2040); a const one is in
+    // read-only data and the store below faults
+    for (int addr = 0; addr < 256; addr++)
+    {
+        psx_device_t *device = (psx_device_t *)psx_device_for((uint8_t)addr);
+        if (device != NULL)
+        {
+            psx_device_action_t action = device->action;
+            device->action = action;
+        }
+    }
+    CHECK_EQ(psx_device_for(PSX_ADDR_CONTROLLER)->action, PSX_DEVICE_RESPOND);
+    CHECK_EQ(psx_device_for(PSX_ADDR_MEMCARD)->action, PSX_DEVICE_LISTEN);
+    CHECK_EQ(psx_device_for(0xFF)->action, PSX_DEVICE_IGNORE);
+    CHECK(psx_device_for(0x02) == NULL);
+}
+
+int main(void)
+{
+    RUN(test_all_addresses);
+    RUN(test_table_in_ram);
+    return TEST_EXIT();
+}
@@ -0,0 +1,160 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Two console ports on one bus loop: each port answers with its own state,
+// and a port selected while the other is being served stays off its bus
+
+#include "test.h"
+#include "sim.h"
+#include "console.h"
+#include "firmware.h"
+#include "psx_protocol.h"
+#include "shared_state.h"
+
+#define MAX_POLLS 8
+
+typedef struct
+{
+    uint8_t port;
+    int count;
+    uint64_t start_ns[MAX_POLLS]; // When to start each poll
+    console_result_t result[MAX_POLLS];
+} script_t;
+
+static void console_task(void *arg)
+{
+    script_t *script = arg;
+    console_t console = console_default(script->port);
+    for (int i = 0; i < script->count; i++)
+    {
+        if (script->start_ns[i] > sim_now_ns())
+        {
+            sim_delay_ns(script->start_ns[i] - sim_now_ns());
+        }
+        console_poll(&console, &script->result[i]);
+    }
+}
+
+static void run_both(script_t *port1, script_t *port2)
+{
+    sim_spawn("console1", SIM_EXTERNAL, console_task, port1);
+    sim_spawn("console2", SIM_EXTERNAL, console_task, port2);
+    CHECK(sim_run(100000));
+}
+
+static uint16_t buttons_of(const console_result_t *result)
+{
+    return (uint16_t)(result->dat[3] | (result->dat[4] << 8));
+}
+
+static bool answered(const console_result_t *result)
+{
+    return result->len == 5 && result->dat[1] == 0x41 && result->dat[2] == 0x5A && !result->driven_after_sel;
+}
+
+static void test_ports_answer_separately(void)
+{
+    firmware_boot();
+    psx_reset_stats();
+    shared_state_write(0, 0xFE, 0xFF);
+    shared_state_write(1, 0xFF, 0xBF);
+
+    // Port 2 polls in the gaps between port 1's polls
+    script_t port1 = {.port = 0, .count = 4};
+    script_t port2 = {.port = 1, .count = 4};
+    for (int i = 0; i < 4; i++)
+    {
+        port1.start_ns[i] = 100000 + (uint64_t)i * 1000000;
+        port2.start_ns[i] = 600000 + (uint64_t)i * 1000000;
+    }
+    run_both(&port1, &port2);
+
+    for (int i = 0; i < 4; i++)
+    {
+        CHECK(answered(&port1.result[i]));
+        CHECK(answered(&port2.result[i]));
+        CHECK_EQ(buttons_of(&port1.result[i]), 0xFFFE);
+        CHECK_EQ(buttons_of(&port2.result[i]), 0xBFFF);
+    }
+    CHECK_EQ(sim_contention_count(), 0);
+
+    psx_stats_t stats1, stats2;
+    psx_get_stats(0, &stats1);
+    psx_get_stats(1, &stats2);
+    CHECK_EQ(stats1.controller_transactions, 4);
+    CHECK_EQ(stats2.controller_transactions, 4);
+    CHECK_EQ(stats1.overlapped_transactions, 0);
+    CHECK_EQ(stats2.overlapped_transactions, 0);
+}
+
+static void test_overlapping_select(void)
+{
+    firmware_boot();
+    psx_reset_stats();
+
+    // Port 2 selects 50 µs into port 1's poll: port 1 keeps the bus, port 2
+    // gets no ACK and its lines are never driven
+    script_t port1 = {.port = 0, .count = 2, .start_ns = {100000, 1100000}};
+    script_t port2 = {.port = 1, .count = 2, .start_ns = {150000, 1600000}};
+    run_both(&port1, &port2);
+
+    CHECK(answered(&port1.result[0]));
+    CHECK_EQ(port2.result[0].len, 1);
+    CHECK_EQ(port2.result[0].dat[0], 0xFF);
+    CHECK(!port2.result[0].ack[0]);
+    CHECK(!port2.result[0].driven_after_sel);
+    CHECK_EQ(sim_contention_count(), 0);
+
+    // Both ports are served normally afterwards
+    CHECK(answered(&port1.result[1]));
+    CHECK(answered(&port2.result[1]));
+
+    psx_stats_t stats1, stats2;
+    psx_get_stats(0, &stats1);
+    psx_get_stats(1, &stats2);
+    CHECK_EQ(stats1.controller_transactions, 2);
+    CHECK_EQ(stats2.controller_transactions, 1);
+}
+
+static void test_simultaneous_select(void)
+{
+    firmware_boot();
+    psx_reset_stats();
+
+    // Same instant: port 1 wins, port 2 is counted as overlapped
+    script_t port1 = {.port = 0, .count = 1, .start_ns = {100000}};
+    script_t port2 = {.port = 1, .count = 1, .start_ns = {100000}};
+    run_both(&port1, &port2);
+
+    CHECK(answered(&port1.result[0]));
+    CHECK(!port2.result[0].ack[0]);
+    CHECK_EQ(sim_contention_count(), 0);
+
+    psx_stats_t stats2;
+    psx_get_stats(1, &stats2);
+    CHECK_EQ(stats2.overlapped_transactions, 1);
+    CHECK_EQ(stats2.controller_transactions, 0);
+}
+
+int main(void)
+{
+    RUN(test_ports_answer_separately);
+    RUN(test_overlapping_select);
+    RUN(test_simultaneous_select);
+    return TEST_EXIT();
+}
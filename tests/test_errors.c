@@ -0,0 +1,253 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Aborted transactions counted at their failure site: each broken exchange
+// adds to exactly one psx_error_t counter (and to timeout_errors only when SEL
+// stayed LOW), and the next poll is answered
+
+#include "test.h"
+#include "sim.h"
+#include "console.h"
+#include "firmware.h"
+#include "psx_protocol.h"
+#include "psx_bitbang.h"
+#include "shared_state.h"
+
+#define HALF_NS 2000 // 250 kHz
+#define STALL_NS 300000
+
+static const psx_port_pins_t *pins;
+
+// Clock the low `bits` bits of a byte like console.c does
+static void clock_bits(uint8_t value, int bits)
+{
+    for (int bit = 0; bit < bits; bit++)
+    {
+        sim_drive(pins->clk, 0);
+        sim_drive(pins->cmd, (value >> bit) & 1);
+        sim_delay_ns(HALF_NS);
+        sim_drive(pins->clk, 1);
+        sim_delay_ns(HALF_NS);
+    }
+    sim_drive(pins->cmd, 1);
+}
+
+// SEL LOW, then the address byte and its ACK
+static void address(void)
+{
+    sim_drive(pins->sel, 0);
+    sim_delay_ns(20000);
+    clock_bits(0x01, 8);
+    CHECK(sim_wait_level(pins->ack, 0, 100000, NULL));
+    CHECK(sim_wait_level(pins->ack, 1, 100000, NULL));
+    sim_delay_ns(10000);
+}
+
+// Drop SEL after a partial byte, at once or after the device timed out
+static void end_early(bool stall)
+{
+    if (stall)
+    {
+        sim_delay_ns(STALL_NS);
+    }
+    sim_drive(pins->sel, 1);
+}
+
+static void false_select(void)
+{
+    sim_drive(pins->sel, 0);
+    sim_delay_ns(600);
+    sim_drive(pins->sel, 1);
+}
+
+static void address_partial(bool stall)
+{
+    sim_drive(pins->sel, 0);
+    sim_delay_ns(20000);
+    clock_bits(0x01, 3);
+    end_early(stall);
+}
+
+static void address_aborted(void)
+{
+    address_partial(false);
+}
+
+static void address_stalled(void)
+{
+    address_partial(true);
+}
+
+static void command_partial(bool stall)
+{
+    address();
+    clock_bits(PSX_CMD_POLL, 3);
+    end_early(stall);
+}
+
+static void command_aborted(void)
+{
+    command_partial(false);
+}
+
+static void command_stalled(void)
+{
+    command_partial(true);
+}
+
+static void exchange(const uint8_t *cmd, uint8_t abort_after, uint32_t sel_hold_ns)
+{
+    console_t console = console_default(0);
+    console.sel_hold_ns = sel_hold_ns;
+    console_result_t result;
+    console_exchange(&console, cmd, 5, abort_after, &result);
+}
+
+static const uint8_t poll_cmd[5] = {0x01, PSX_CMD_POLL, 0x00, 0x00, 0x00};
+
+// SEL rising 500 ns after a byte comes before the device checks it; 3 us
+// after, it comes during the ACK
+static void address_ack(void)
+{
+    exchange(poll_cmd, 1, 500);
+}
+
+static void after_command(void)
+{
+    exchange(poll_cmd, 2, 500);
+}
+
+static void poll_byte3(void)
+{
+    exchange(poll_cmd, 2, 3000);
+}
+
+static void poll_byte4(void)
+{
+    exchange(poll_cmd, 3, 3000);
+}
+
+static void poll_byte5(void)
+{
+    exchange(poll_cmd, 4, 3000);
+}
+
+static void unknown_cmd(void)
+{
+    static const uint8_t cmd[5] = {0x01, 0x43, 0x00, 0x00, 0x00};
+    exchange(cmd, 5, 500);
+}
+
+static void unknown_addr(void)
+{
+    static const uint8_t cmd[5] = {0x55, PSX_CMD_POLL, 0x00, 0x00, 0x00};
+    exchange(cmd, 5, 500);
+}
+
+typedef struct
+{
+    const char *name;
+    void (*broken)(void);
+    psx_error_t site;
+    uint32_t timeouts;
+    bool answered; // The poll after it
+} scenario_t;
+
+static void scenario_task(void *arg)
+{
+    scenario_t *scenario = arg;
+    scenario->broken();
+    sim_delay_ns(100000);
+
+    console_t console = console_default(0);
+    console_result_t result;
+    console_poll(&console, &result);
+    scenario->answered = result.len == 5 && result.dat[1] == 0x41 && result.dat[2] == 0x5A && result.ack[3] &&
+                         !result.driven_after_sel;
+}
+
+static void test_error_sites(void)
+{
+    scenario_t scenarios[] = {
+        {"false select", false_select, PSX_ERROR_FALSE_SELECT, 0, false},
+        {"address aborted", address_aborted, PSX_ERROR_ADDRESS, 0, false},
+        {"address stalled", address_stalled, PSX_ERROR_ADDRESS, 1, false},
+        {"address ACK", address_ack, PSX_ERROR_ADDRESS_ACK, 0, false},
+        {"command aborted", command_aborted, PSX_ERROR_COMMAND, 0, false},
+        {"command stalled", command_stalled, PSX_ERROR_COMMAND, 1, false},
+        {"after command", after_command, PSX_ERROR_AFTER_COMMAND, 0, false},
+        {"poll byte 3", poll_byte3, PSX_ERROR_POLL_BYTE3, 0, false},
+        {"poll byte 4", poll_byte4, PSX_ERROR_POLL_BYTE4, 0, false},
+        {"poll byte 5", poll_byte5, PSX_ERROR_POLL_BYTE5, 0, false},
+        {"unknown command", unknown_cmd, PSX_ERROR_UNKNOWN_CMD, 0, false},
+        {"unknown address", unknown_addr, PSX_ERROR_UNKNOWN_ADDR, 0, false},
+    };
+
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++)
+    {
+        scenario_t *scenario = &scenarios[i];
+        firmware_boot();
+        pins = &psx_port_pins[0];
+        shared_state_write(0, 0xFF, 0xFF);
+        CHECK(sim_run(1000));
+        psx_reset_stats();
+
+        sim_spawn("console", SIM_EXTERNAL, scenario_task, scenario);
+        CHECK(sim_run(2000));
+
+        psx_stats_t stats;
+        psx_get_stats(0, &stats);
+        int failures = test_failures;
+        for (int site = 0; site < PSX_ERROR_COUNT; site++)
+        {
+            CHECK_EQ(stats.errors[site], site == (int)scenario->site);
+        }
+        CHECK_EQ(stats.timeout_errors, scenario->timeouts);
+        CHECK(scenario->answered);
+        if (test_failures != failures)
+        {
+            printf("     in \"%s\"\n", scenario->name);
+        }
+    }
+}
+
+// The invalid command and address are kept for the debug output
+static void test_last_invalid(void)
+{
+    scenario_t scenario = {"unknown command", unknown_cmd, PSX_ERROR_UNKNOWN_CMD, 0, false};
+    firmware_boot();
+    pins = &psx_port_pins[0];
+    shared_state_write(0, 0xFF, 0xFF);
+    sim_spawn("console", SIM_EXTERNAL, scenario_task, &scenario);
+    CHECK(sim_run(2000));
+    scenario.broken = unknown_addr;
+    sim_spawn("console", SIM_EXTERNAL, scenario_task, &scenario);
+    CHECK(sim_run(2000));
+
+    psx_stats_t stats;
+    psx_get_stats(0, &stats);
+    CHECK_EQ(stats.last_invalid_cmd, 0x43);
+    CHECK_EQ(stats.last_invalid_addr, 0x55);
+}
+
+int main(void)
+{
+    RUN(test_error_sites);
+    RUN(test_last_invalid);
+    return TEST_EXIT();
+}
@@ -0,0 +1,347 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Binary host link: frames encoded as a host would send them, fed byte by
+// byte, and device frames captured from putchar_raw
+
+#include "test.h"
+#include "sim.h"
+#include "console.h"
+#include "firmware.h"
+#include "host_link.h"
+#include "persona.h"
+#include "pico/time.h"
+
+// ============================================================================
+// Host Side
+// ============================================================================
+
+static uint16_t host_seq = 1;
+
+static uint8_t crc8(const uint8_t *data, int len)
+{
+    uint8_t crc = 0;
+    for (int i = 0; i < len; i++)
+    {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// Encode a frame with an explicit sequence number, returns its length
+static int encode(uint8_t *out, uint8_t type, uint16_t seq, const uint8_t *payload, uint8_t len)
+{
+    out[0] = HOST_LINK_SYNC;
+    out[1] = type;
+    out[2] = len;
+    out[3] = (uint8_t)seq;
+    out[4] = (uint8_t)(seq >> 8);
+    memset(&out[5], 0, 4);
+    memcpy(&out[HOST_LINK_HEADER_LEN], payload, len);
+    out[HOST_LINK_HEADER_LEN + len] = crc8(&out[1], HOST_LINK_HEADER_LEN - 1 + len);
+    return HOST_LINK_HEADER_LEN + len + 1;
+}
+
+// Feed bytes, returns how many the parser consumed
+static int feed(const uint8_t *bytes, int len)
+{
+    int consumed = 0;
+    for (int i = 0; i < len; i++)
+    {
+        consumed += host_link_feed(bytes[i]);
+    }
+    return consumed;
+}
+
+static void send_frame_seq(uint8_t type, uint16_t seq, const uint8_t *payload, uint8_t len)
+{
+    uint8_t frame[HOST_LINK_HEADER_LEN + HOST_LINK_MAX_PAYLOAD + 1];
+    int frame_len = encode(frame, type, seq, payload, len);
+    CHECK_EQ(feed(frame, frame_len), frame_len);
+}
+
+static void send_frame(uint8_t type, const uint8_t *payload, uint8_t len)
+{
+    send_frame_seq(type, host_seq++, payload, len);
+}
+
+static host_link_stats_t stats_now(void)
+{
+    host_link_stats_t stats;
+    host_link_get_stats(&stats);
+    return stats;
+}
+
+// Device -> host bytes
+static uint8_t captured[512];
+static int captured_len = 0;
+
+static int capture(int c)
+{
+    if (captured_len < (int)sizeof(captured))
+    {
+        captured[captured_len++] = (uint8_t)c;
+    }
+    return c;
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+static void test_input_frame(void)
+{
+    host_link_stats_t before = stats_now();
+    uint8_t input[] = {0xFE, 0xBF};
+    send_frame(HOST_FRAME_INPUT, input, sizeof(input));
+
+    CHECK_EQ(stats_now().frames_accepted, before.frames_accepted + 1);
+    CHECK(host_link_take_input());
+    CHECK(!host_link_take_input());
+    CHECK_EQ(host_link_buttons(0, time_us_32()), 0xBFFE);
+
+    // Released once the host goes quiet
+    sim_advance_ns((uint64_t)(HOST_INPUT_TIMEOUT_US + 1) * 1000);
+    CHECK_EQ(host_link_buttons(0, time_us_32()), 0xFFFF);
+}
+
+static void test_sequence(void)
+{
+    uint8_t input[] = {0xFF, 0xFF};
+    send_frame(HOST_FRAME_INPUT, input, sizeof(input)); // Within the sequence timeout
+    host_link_stats_t before = stats_now();
+
+    // Duplicate and older frames are stale
+    send_frame_seq(HOST_FRAME_INPUT, (uint16_t)(host_seq - 1), input, sizeof(input));
+    send_frame_seq(HOST_FRAME_INPUT, (uint16_t)(host_seq - 5), input, sizeof(input));
+    CHECK_EQ(stats_now().frames_stale, before.frames_stale + 2);
+
+    // A jump of 4 loses 3
+    host_seq += 3;
+    send_frame(HOST_FRAME_INPUT, input, sizeof(input));
+    CHECK_EQ(stats_now().frames_lost, before.frames_lost + 3);
+    CHECK_EQ(stats_now().last_seq, (uint16_t)(host_seq - 1));
+
+    // Half the sequence space ahead is still newer, and 65535 -> 0 wraps
+    before = stats_now();
+    host_seq = 0x7FF0;
+    send_frame(HOST_FRAME_INPUT, input, sizeof(input));
+    host_seq = 0xF000;
+    send_frame(HOST_FRAME_INPUT, input, sizeof(input));
+    host_seq = 0xFFFF;
+    send_frame(HOST_FRAME_INPUT, input, sizeof(input));
+    send_frame(HOST_FRAME_INPUT, input, sizeof(input));
+    CHECK_EQ(host_seq, 1);
+    CHECK_EQ(stats_now().frames_accepted, before.frames_accepted + 4);
+    CHECK_EQ(stats_now().frames_stale, before.frames_stale);
+    CHECK_EQ(stats_now().last_seq, 0);
+}
+
+static void test_host_restart(void)
+{
+    uint8_t input[] = {0xEF, 0xFF};
+    host_seq = 0x4000;
+    send_frame(HOST_FRAME_INPUT, input, sizeof(input));
+
+    // Restarted right away: still stale
+    host_link_stats_t before = stats_now();
+    host_seq = 0;
+    send_frame(HOST_FRAME_INPUT, input, sizeof(input));
+    CHECK_EQ(stats_now().frames_stale, before.frames_stale + 1);
+
+    // Once the old stream has gone quiet, the new one starts over without
+    // counting the jump back as lost frames
+    sim_advance_ns((uint64_t)(HOST_INPUT_TIMEOUT_US + 1) * 1000);
+    before = stats_now();
+    host_link_take_input();
+    send_frame(HOST_FRAME_INPUT, input, sizeof(input));
+    send_frame(HOST_FRAME_INPUT, input, sizeof(input));
+    CHECK_EQ(stats_now().frames_accepted, before.frames_accepted + 2);
+    CHECK_EQ(stats_now().frames_stale, before.frames_stale);
+    CHECK_EQ(stats_now().frames_lost, before.frames_lost);
+    CHECK_EQ(stats_now().last_seq, 2);
+    CHECK(host_link_take_input());
+    CHECK_EQ(host_link_buttons(0, time_us_32()), 0xFFEF);
+}
+
+static void test_bad_frames(void)
+{
+    uint8_t frame[HOST_LINK_HEADER_LEN + HOST_LINK_MAX_PAYLOAD + 1];
+    uint8_t input[] = {0x00, 0x00};
+    host_link_stats_t before = stats_now();
+    host_link_take_input();
+
+    // Corrupted payload
+    int len = encode(frame, HOST_FRAME_INPUT, host_seq++, input, sizeof(input));
+    frame[HOST_LINK_HEADER_LEN] ^= 0x01;
+    feed(frame, len);
+    CHECK_EQ(stats_now().crc_errors, before.crc_errors + 1);
+
+    // Wrong payload length, port out of range, unknown type
+    send_frame(HOST_FRAME_INJECT, input, sizeof(input));
+    uint8_t other_port[] = {0x00, 0x00, PSX_PORT_COUNT};
+    send_frame(HOST_FRAME_INPUT, other_port, sizeof(other_port));
+    send_frame(0x7F, input, sizeof(input));
+    CHECK_EQ(stats_now().bad_frames, before.bad_frames + 3);
+
+    // Length byte over the limit ends the frame at once
+    uint8_t oversize[] = {HOST_LINK_SYNC, HOST_FRAME_INPUT, HOST_LINK_MAX_PAYLOAD + 1};
+    CHECK_EQ(feed(oversize, sizeof(oversize)), 3);
+    CHECK_EQ(stats_now().bad_frames, before.bad_frames + 4);
+    CHECK(!host_link_feed('s'));
+
+    CHECK_EQ(stats_now().frames_accepted, before.frames_accepted);
+    CHECK(!host_link_take_input());
+}
+
+static void test_text_and_timeout(void)
+{
+    // Text bytes pass through to the command parser
+    const char *text = "stats\r";
+    CHECK_EQ(feed((const uint8_t *)text, (int)strlen(text)), 0);
+
+    // A frame cut off mid-way is dropped after the byte gap timeout
+    host_link_stats_t before = stats_now();
+    uint8_t frame[HOST_LINK_HEADER_LEN + HOST_LINK_MAX_PAYLOAD + 1];
+    uint8_t input[] = {0x00, 0x00};
+    int len = encode(frame, HOST_FRAME_INPUT, host_seq++, input, sizeof(input));
+    feed(frame, len - 4);
+    sim_advance_ns((uint64_t)(HOST_LINK_FRAME_TIMEOUT_US + 1) * 1000);
+    CHECK(!host_link_feed('h'));
+    CHECK_EQ(stats_now().bad_frames, before.bad_frames + 1);
+
+    // The next whole frame still gets through
+    send_frame(HOST_FRAME_INPUT, input, sizeof(input));
+    CHECK_EQ(stats_now().frames_accepted, before.frames_accepted + 1);
+    CHECK(host_link_take_input());
+}
+
+static void test_axes_frame(void)
+{
+    uint8_t axes[PERSONA_AXES];
+    uint8_t payload[] = {0x10, 0x20, 0x30, 0x40};
+    send_frame(HOST_FRAME_AXES, payload, sizeof(payload));
+
+    CHECK(host_link_axes(0, time_us_32(), axes));
+    CHECK_EQ(axes[0], 0x10);
+    CHECK_EQ(axes[3], 0x40);
+    CHECK(host_link_take_input());
+
+    sim_advance_ns((uint64_t)(HOST_INPUT_TIMEOUT_US + 1) * 1000);
+    CHECK(!host_link_axes(0, time_us_32(), axes));
+}
+
+static void test_device_frames(void)
+{
+    captured_len = 0;
+    sim_set_putchar(capture);
+
+    uint8_t payload[] = {1, 2, 3};
+    host_link_send(HOST_FRAME_SNIFF, payload, sizeof(payload));
+    host_link_send(HOST_FRAME_SNIFF, payload, 0);
+    host_link_send(HOST_FRAME_SNIFF, payload, HOST_LINK_MAX_PAYLOAD + 1); // Not sent
+    sim_set_putchar(NULL);
+
+    // Two frames, valid CRC, consecutive sequence numbers
+    int first_len = HOST_LINK_HEADER_LEN + 3 + 1;
+    CHECK_EQ(captured_len, first_len + HOST_LINK_HEADER_LEN + 1);
+    CHECK_EQ(captured[0], HOST_LINK_SYNC);
+    CHECK_EQ(captured[1], HOST_FRAME_SNIFF);
+    CHECK_EQ(captured[2], 3);
+    CHECK_EQ(captured[HOST_LINK_HEADER_LEN + 2], 3);
+    CHECK_EQ(crc8(&captured[1], first_len - 2), captured[first_len - 1]);
+    uint16_t seq = (uint16_t)(captured[3] | (captured[4] << 8));
+    uint16_t next = (uint16_t)(captured[first_len + 3] | (captured[first_len + 4] << 8));
+    CHECK_EQ(next, (uint16_t)(seq + 1));
+    CHECK_EQ(crc8(&captured[first_len + 1], HOST_LINK_HEADER_LEN - 1), captured[captured_len - 1]);
+}
+
+static void console_task(void *arg)
+{
+    console_t console = console_default(0);
+    console_result_t result;
+    console_poll(&console, &result);
+    CHECK_EQ(result.dat[2], 0x5A);
+}
+
+// Poll the bus once and decode the poll event frame that follows
+static bool poll_event(uint32_t *poll, uint8_t *flags)
+{
+    sim_spawn("console", SIM_EXTERNAL, console_task, NULL);
+    CHECK(sim_run(10000));
+
+    captured_len = 0;
+    sim_set_putchar(capture);
+    host_link_task();
+    sim_set_putchar(NULL);
+    if (captured_len != HOST_LINK_HEADER_LEN + 10 + 1 || captured[1] != HOST_FRAME_POLL_EVENT)
+    {
+        return false;
+    }
+
+    const uint8_t *payload = &captured[HOST_LINK_HEADER_LEN];
+    *poll = (uint32_t)(payload[0] | (payload[1] << 8) | (payload[2] << 16) | ((uint32_t)payload[3] << 24));
+    *flags = payload[8];
+    return true;
+}
+
+static void test_poll_events(void)
+{
+    uint32_t poll;
+    uint8_t flags;
+
+    firmware_boot();
+    host_link_set_poll_events(true);
+    CHECK(poll_event(&poll, &flags));
+    CHECK_EQ(poll, 1);
+    CHECK_EQ(flags, 0);
+
+    // Nothing new since the last report
+    captured_len = 0;
+    sim_set_putchar(capture);
+    host_link_task();
+    sim_set_putchar(NULL);
+    CHECK_EQ(captured_len, 0);
+
+    // An inject frame for the next poll is flagged on its event
+    uint8_t inject[] = {2, 0, 0, 0, 0xFE, 0xFF};
+    send_frame(HOST_FRAME_INJECT, inject, sizeof(inject));
+    CHECK(poll_event(&poll, &flags));
+    CHECK_EQ(poll, 2);
+    CHECK_EQ(flags, HOST_POLL_FLAG_INJECTED);
+
+    host_link_set_poll_events(false);
+    CHECK(!poll_event(&poll, &flags));
+}
+
+int main(void)
+{
+    RUN(test_input_frame);
+    RUN(test_sequence);
+    RUN(test_host_restart);
+    RUN(test_bad_frames);
+    RUN(test_text_and_timeout);
+    RUN(test_axes_frame);
+    RUN(test_device_frames);
+    RUN(test_poll_events);
+    return TEST_EXIT();
+}
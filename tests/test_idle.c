@@ -0,0 +1,134 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Core 1 sleeping in WFE between transactions: polls still answered, one
+// wake-up per poll, other events counted as spurious, idle time and wake
+// latency accounted
+
+#include "test.h"
+#include "sim.h"
+#include "console.h"
+#include "firmware.h"
+#include "config.h"
+#include "psx_protocol.h"
+#include "shared_state.h"
+#include "hardware/sync.h"
+
+#define POLLS 10
+#define POLL_PERIOD_NS 500000
+
+typedef struct
+{
+    int events;   // __sev() calls before each poll
+    int answered; // Polls answered with the digital pad ID
+} idle_run_t;
+
+static void poll_task(void *arg)
+{
+    idle_run_t *run = arg;
+    console_t console = console_default(0);
+    for (int i = 0; i < POLLS; i++)
+    {
+        for (int e = 0; e < run->events; e++)
+        {
+            sim_delay_ns(POLL_PERIOD_NS / (run->events + 1));
+            __sev();
+        }
+        sim_delay_ns(POLL_PERIOD_NS / (run->events + 1));
+
+        console_result_t result;
+        console_poll(&console, &result);
+        if (result.len == 5 && result.dat[1] == 0x41 && result.dat[2] == 0x5A && !result.driven_after_sel)
+        {
+            run->answered++;
+        }
+    }
+}
+
+static void run_polls(idle_run_t *run, psx_idle_stats_t *stats)
+{
+    firmware_boot();
+    shared_state_write(0, 0xFF, 0xFF);
+    CHECK(sim_run(1000));
+    psx_reset_stats();
+
+    sim_spawn("console", SIM_EXTERNAL, poll_task, run);
+    CHECK(sim_run(POLLS * POLL_PERIOD_NS / 1000 + 10000));
+    psx_get_idle_stats(stats);
+}
+
+static uint32_t hist_sum(const psx_idle_stats_t *stats)
+{
+    uint32_t sum = 0;
+    for (int i = 0; i < PSX_WAKE_BUCKETS; i++)
+    {
+        sum += stats->wake_hist[i];
+    }
+    return sum;
+}
+
+static void test_one_wake_per_poll(void)
+{
+    idle_run_t run = {0};
+    psx_idle_stats_t stats;
+    run_polls(&run, &stats);
+
+    printf("     idle %llu of %llu us, wake %u..%u ns\n", (unsigned long long)stats.idle_us,
+           (unsigned long long)stats.elapsed_us, stats.wake_min_ns, stats.wake_max_ns);
+    CHECK_EQ(run.answered, POLLS);
+    CHECK_EQ(stats.wakeups, POLLS);
+    CHECK_EQ(stats.spurious, 0);
+    CHECK_EQ(hist_sum(&stats), stats.wakeups);
+
+    // A poll takes about 200 us of the 500 us period at 250 kHz
+    CHECK(stats.elapsed_us >= (POLLS - 1) * POLL_PERIOD_NS / 1000);
+    CHECK(stats.idle_us > stats.elapsed_us / 2 && stats.idle_us < stats.elapsed_us);
+
+    // The wake-up is part of the SEL settle time, not added to it
+    CHECK(stats.wake_min_ns > 0);
+    CHECK(stats.wake_min_ns <= stats.wake_max_ns);
+    CHECK(stats.wake_max_ns < PSX_SEL_SETTLE_NS);
+
+    // Every poll wakes the same way here, so all land in one bucket
+    static const uint32_t bucket_ns[PSX_WAKE_BUCKETS - 1] = {250, 500, 1000, 2000};
+    int bucket = 0;
+    while (bucket < PSX_WAKE_BUCKETS - 1 && stats.wake_min_ns >= bucket_ns[bucket])
+    {
+        bucket++;
+    }
+    CHECK_EQ(stats.wake_hist[bucket], POLLS);
+}
+
+static void test_spurious_events(void)
+{
+    idle_run_t run = {.events = 3};
+    psx_idle_stats_t stats;
+    run_polls(&run, &stats);
+
+    CHECK_EQ(run.answered, POLLS);
+    CHECK_EQ(stats.wakeups, POLLS);
+    CHECK_EQ(stats.spurious, 3 * POLLS);
+    CHECK_EQ(hist_sum(&stats), POLLS);
+}
+
+int main(void)
+{
+    RUN(test_one_wake_per_poll);
+    RUN(test_spurious_events);
+    return TEST_EXIT();
+}
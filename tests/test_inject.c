@@ -0,0 +1,217 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Poll-synchronised injection against a simulated console: entries land on
+// their poll, and a poll the console cuts short is neither numbered nor
+// counted
+
+#include "test.h"
+#include "sim.h"
+#include "console.h"
+#include "firmware.h"
+#include "inject.h"
+#include "psx_protocol.h"
+#include "shared_state.h"
+#include "pico/multicore.h"
+#include "hardware/sync.h"
+
+#define MAX_POLLS 16
+
+// Before each poll: bytes to clock (5 = full poll)
+typedef struct
+{
+    int count;
+    uint8_t clock[MAX_POLLS];
+    uint16_t seen[MAX_POLLS];
+    uint64_t end_ns[MAX_POLLS];
+} script_t;
+
+static void console_task(void *arg)
+{
+    script_t *script = arg;
+    console_t console = console_default(0);
+    static const uint8_t poll[] = {0x01, 0x42, 0x00, 0x00, 0x00};
+
+    for (int i = 0; i < script->count; i++)
+    {
+        uint8_t clock = script->clock[i] ? script->clock[i] : 5;
+        console_result_t result;
+        console_exchange(&console, poll, 5, clock, &result);
+        script->seen[i] = (uint16_t)(result.dat[3] | (result.dat[4] << 8));
+        script->end_ns[i] = result.end_ns;
+        sim_delay_ns(300000);
+    }
+}
+
+static void run_script(script_t *script)
+{
+    sim_spawn("console", SIM_EXTERNAL, console_task, script);
+    CHECK(sim_run(100000));
+}
+
+static inject_stats_t stats_now(void)
+{
+    inject_stats_t stats;
+    inject_get_stats(&stats);
+    return stats;
+}
+
+static void test_lands_on_poll(void)
+{
+    firmware_boot();
+    CHECK(inject_push(2, 0xFFFE));
+    CHECK(inject_push(4, 0xBFFF));
+
+    script_t script = {.count = 5};
+    run_script(&script);
+
+    CHECK_EQ(script.seen[0], 0xFFFF);
+    CHECK_EQ(script.seen[1], 0xFFFE);
+    CHECK_EQ(script.seen[2], 0xFFFF);
+    CHECK_EQ(script.seen[3], 0xBFFF);
+    CHECK_EQ(script.seen[4], 0xFFFF);
+
+    inject_stats_t stats = stats_now();
+    CHECK_EQ(stats.polls, 5);
+    CHECK_EQ(stats.delivered, 2);
+    CHECK_EQ(stats.late, 0);
+    CHECK_EQ(stats.queued, 0);
+
+    uint32_t poll, time_us;
+    bool injected;
+    CHECK(inject_poll_event(&poll, &time_us, &injected));
+    CHECK_EQ(poll, 5);
+    CHECK(!injected);
+    CHECK(!inject_poll_event(&poll, &time_us, &injected));
+}
+
+static void test_cut_short_poll(void)
+{
+    // The console gives up after each byte of the frame in turn
+    for (uint8_t clock = 3; clock <= 4; clock++)
+    {
+        firmware_boot();
+        CHECK(inject_push(2, 0xFFFE));
+
+        script_t script = {.count = 3};
+        script.clock[1] = clock;
+        run_script(&script);
+
+        // Not counted as delivered: the entry goes out on the next full poll
+        CHECK_EQ(script.seen[2], 0xFFFE);
+        inject_stats_t stats = stats_now();
+        CHECK_EQ(stats.polls, 2);
+        CHECK_EQ(stats.delivered, 1);
+        CHECK_EQ(stats.queued, 0);
+
+        uint32_t poll, time_us;
+        bool injected;
+        inject_read_last_poll(&poll, &time_us, &injected);
+        CHECK_EQ(poll, 2);
+        CHECK(injected);
+    }
+}
+
+static void test_late_and_overflow(void)
+{
+    firmware_boot();
+    script_t first = {.count = 3};
+    run_script(&first);
+
+    // Poll 2 has passed; poll 5 is still ahead
+    CHECK(inject_push(2, 0x0000));
+    CHECK(inject_push(5, 0xFFF0));
+    script_t second = {.count = 2};
+    run_script(&second);
+    CHECK_EQ(second.seen[0], 0xFFFF);
+    CHECK_EQ(second.seen[1], 0xFFF0);
+    CHECK_EQ(stats_now().late, 1);
+    CHECK_EQ(stats_now().delivered, 1);
+
+    for (uint32_t i = 0; i < INJECT_QUEUE_SIZE; i++)
+    {
+        CHECK(inject_push(100 + i, 0xFFFF));
+    }
+    CHECK(!inject_push(200, 0xFFFF));
+    CHECK_EQ(stats_now().overflows, 1);
+    CHECK_EQ(stats_now().queued, INJECT_QUEUE_SIZE);
+}
+
+// ============================================================================
+// Core 1 Reset During Publication
+// ============================================================================
+
+typedef struct
+{
+    uint64_t reset_at_ns;
+    bool read_done;
+} resetter_t;
+
+// Restarted Core 1 that is not polled again
+static void core1_idle(void)
+{
+    psx_protocol_init();
+    inject_core1_start();
+    while (1)
+    {
+        __wfe();
+    }
+}
+
+static void resetter_task(void *arg)
+{
+    resetter_t *resetter = arg;
+    sim_delay_ns(resetter->reset_at_ns - sim_now_ns());
+    multicore_reset_core1();
+    multicore_launch_core1(core1_idle);
+    sim_delay_ns(10000);
+
+    uint32_t poll, time_us;
+    bool injected;
+    inject_read_last_poll(&poll, &time_us, &injected);
+    resetter->read_done = true;
+}
+
+static void test_reset_during_publication(void)
+{
+    script_t probe = {.count = 1};
+    firmware_boot();
+    run_script(&probe);
+
+    // Every 5 ns around the end of the poll, where it is published
+    int failed = 0;
+    for (uint64_t at = probe.end_ns[0] - 3000; at < probe.end_ns[0] + 3000; at += 5)
+    {
+        script_t script = {.count = 1};
+        resetter_t resetter = {.reset_at_ns = at};
+        firmware_boot();
+        sim_spawn("console", SIM_EXTERNAL, console_task, &script);
+        sim_spawn("reset", SIM_CORE0, resetter_task, &resetter);
+        failed += !sim_run(5000) || !resetter.read_done;
+    }
+    CHECK_EQ(failed, 0);
+}
+
+int main(void)
+{
+    RUN(test_lands_on_poll);
+    RUN(test_cut_short_poll);
+    RUN(test_late_and_overflow);
+    RUN(test_reset_during_publication);
+    return TEST_EXIT();
+}
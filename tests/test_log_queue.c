@@ -0,0 +1,221 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Deferred log queue: messages printed in order, a full queue dropping and
+// counting, log_discard, and Core 1 pushing while Core 0 flushes
+
+#include "test.h"
+#include "sim.h"
+#include "config.h"
+#include "log_queue.h"
+#include "pico/stdlib.h"
+#include <string.h>
+#include <unistd.h>
+
+// Captured stdout
+static char output[512 * 1024];
+
+static int saved_stdout = -1;
+static FILE *capture = NULL;
+
+static void capture_begin(void)
+{
+    fflush(stdout);
+    saved_stdout = dup(STDOUT_FILENO);
+    capture = tmpfile();
+    dup2(fileno(capture), STDOUT_FILENO);
+}
+
+static void capture_end(void)
+{
+    fflush(stdout);
+    dup2(saved_stdout, STDOUT_FILENO);
+    close(saved_stdout);
+    rewind(capture);
+    size_t len = fread(output, 1, sizeof(output) - 1, capture);
+    output[len] = '\0';
+    fclose(capture);
+}
+
+static int count(const char *text)
+{
+    int found = 0;
+    for (const char *at = strstr(output, text); at != NULL; at = strstr(at + 1, text))
+    {
+        found++;
+    }
+    return found;
+}
+
+// Empty the queue and report earlier drops, so each test starts clean
+static void start(void)
+{
+    sim_reset();
+    capture_begin();
+    log_flush(LOG_QUEUE_SIZE);
+    capture_end();
+}
+
+// Only messages without a string argument: host pointers don't fit in a uint32_t
+static void push_locked(uint32_t seq)
+{
+    LOG_PUSH(LOG_ACK_TUNE_LOCKED, seq, seq ^ 0xFFFF, seq % 100);
+}
+
+static void test_order(void)
+{
+    start();
+    LOG_PUSH(LOG_ACK_TUNE_START, 0);
+    push_locked(7);
+    LOG_PUSH(LOG_ACK_TUNE_RESTART, 0);
+
+    capture_begin();
+    uint32_t first = log_flush(2);
+    uint32_t second = log_flush(LOG_QUEUE_SIZE);
+    uint32_t third = log_flush(LOG_QUEUE_SIZE);
+    capture_end();
+
+    CHECK_EQ(first, 2);
+    CHECK_EQ(second, 1);
+    CHECK_EQ(third, 0);
+    CHECK(strcmp(output, "[ACK-TUNE] Starting auto-tune...\n"
+                         "[ACK-TUNE] LOCKED: PULSE=7 us, WAIT=65528 us (7%)\n"
+                         "[ACK-TUNE] No good settings, restarting...\n") == 0);
+}
+
+static void test_full_queue(void)
+{
+    start();
+    uint32_t dropped = log_get_dropped();
+    for (uint32_t seq = 0; seq < LOG_QUEUE_SIZE + 3; seq++)
+    {
+        push_locked(seq);
+    }
+    CHECK_EQ(log_get_dropped() - dropped, 3);
+
+    // The oldest entries are kept, the newest dropped, and the drops reported once
+    capture_begin();
+    CHECK_EQ(log_flush(LOG_QUEUE_SIZE * 2), LOG_QUEUE_SIZE);
+    log_flush(LOG_QUEUE_SIZE);
+    capture_end();
+    CHECK_EQ(count("[ACK-TUNE] LOCKED"), LOG_QUEUE_SIZE);
+    CHECK(strstr(output, "PULSE=0 us") != NULL);
+    CHECK(strstr(output, "PULSE=31 us") != NULL);
+    CHECK(strstr(output, "PULSE=32 us") == NULL);
+    CHECK_EQ(count("[LOG] 3 messages dropped (queue full)\n"), 1);
+
+    // Room again once flushed
+    push_locked(100);
+    CHECK_EQ(log_get_dropped() - dropped, 3);
+    capture_begin();
+    CHECK_EQ(log_flush(LOG_QUEUE_SIZE), 1);
+    capture_end();
+    CHECK(strstr(output, "PULSE=100 us") != NULL);
+}
+
+static void test_discard(void)
+{
+    start();
+    for (uint32_t seq = 0; seq < 5; seq++)
+    {
+        push_locked(seq);
+    }
+    log_discard();
+
+    capture_begin();
+    CHECK_EQ(log_flush(LOG_QUEUE_SIZE), 0);
+    capture_end();
+    CHECK_EQ(output[0], '\0');
+}
+
+// ============================================================================
+// Both Cores
+// ============================================================================
+
+#define PUSHES 5000
+
+static void producer_task(void *arg)
+{
+    // Bursts faster than the consumer drains, so some are dropped
+    for (uint32_t seq = 0; seq < PUSHES; seq++)
+    {
+        push_locked(seq);
+        busy_wait_us_32(seq % 64 < 48 ? 1 : 20);
+    }
+}
+
+static void consumer_task(void *arg)
+{
+    uint32_t *printed = arg;
+    uint64_t end = time_us_64() + PUSHES * 10;
+    while (time_us_64() < end)
+    {
+        *printed += log_flush(4);
+        busy_wait_us_32(10);
+    }
+    *printed += log_flush(LOG_QUEUE_SIZE);
+}
+
+static void test_two_cores(void)
+{
+    start();
+    uint32_t dropped = log_get_dropped();
+    uint32_t printed = 0;
+
+    capture_begin();
+    sim_spawn("core1", SIM_CORE1, producer_task, NULL);
+    sim_spawn("core0", SIM_CORE0, consumer_task, &printed);
+    bool done = sim_run(PUSHES * 20);
+    capture_end();
+    CHECK(done);
+
+    // Every message either printed whole and in order, or counted as dropped
+    uint32_t lost = log_get_dropped() - dropped;
+    printf("     %u printed, %u dropped\n", printed, lost);
+    CHECK(lost > 0);
+    CHECK_EQ(printed + lost, PUSHES);
+
+    uint32_t lines = 0, skipped = 0;
+    long last = -1;
+    bool coherent = true;
+    for (const char *at = strstr(output, "LOCKED: "); at != NULL; at = strstr(at + 1, "LOCKED: "))
+    {
+        unsigned long pulse, wait, percent;
+        if (sscanf(at, "LOCKED: PULSE=%lu us, WAIT=%lu us (%lu%%)", &pulse, &wait, &percent) != 3 ||
+            (long)pulse <= last || wait != (pulse ^ 0xFFFF) || percent != pulse % 100)
+        {
+            coherent = false;
+            break;
+        }
+        skipped += (uint32_t)(pulse - (unsigned long)(last + 1));
+        last = (long)pulse;
+        lines++;
+    }
+    CHECK(coherent);
+    CHECK_EQ(lines, printed);
+    CHECK_EQ(skipped + (PUSHES - 1 - (uint32_t)last), lost);
+}
+
+int main(void)
+{
+    RUN(test_order);
+    RUN(test_full_queue);
+    RUN(test_discard);
+    RUN(test_two_cores);
+    return TEST_EXIT();
+}
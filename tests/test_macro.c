@@ -0,0 +1,217 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Macro record/playback through the simulated bus, and start/stop requests
+// handed from Core 0 to Core 1
+
+#include "test.h"
+#include "sim.h"
+#include "console.h"
+#include "firmware.h"
+#include "shared_state.h"
+#include "macro.h"
+
+#define MAX_POLLS 32
+
+typedef enum
+{
+    ACT_NONE = 0,
+    ACT_RECORD,
+    ACT_PLAY,
+    ACT_STOP
+} action_t;
+
+// Before each poll: live button word and an optional Core 0 request
+typedef struct
+{
+    int count;
+    uint16_t live[MAX_POLLS];
+    action_t action[MAX_POLLS];
+    uint16_t seen[MAX_POLLS]; // Button word answered by the pad
+} script_t;
+
+static void console_task(void *arg)
+{
+    script_t *script = arg;
+    console_t console = console_default(0);
+
+    for (int i = 0; i < script->count; i++)
+    {
+        switch (script->action[i])
+        {
+        case ACT_RECORD:
+            macro_record_start();
+            break;
+        case ACT_PLAY:
+            CHECK(macro_play_start());
+            break;
+        case ACT_STOP:
+            macro_stop();
+            break;
+        default:
+            break;
+        }
+
+        shared_state_write(0, (uint8_t)(script->live[i] & 0xFF), (uint8_t)(script->live[i] >> 8));
+        console_result_t result;
+        console_poll(&console, &result);
+        CHECK_EQ(result.dat[2], 0x5A);
+        script->seen[i] = (uint16_t)(result.dat[3] | (result.dat[4] << 8));
+        sim_delay_ns(200000);
+    }
+}
+
+static void run_script(script_t *script)
+{
+    sim_spawn("console", SIM_EXTERNAL, console_task, script);
+    CHECK(sim_run(100000));
+}
+
+static void test_record_and_play(void)
+{
+    static const uint16_t recorded[] = {0xFFFF, 0xBFFF, 0xBFFF, 0xBFFF, 0xFFEF, 0xFFFF};
+    script_t script = {0};
+
+    firmware_boot();
+    script.count = 6 + 1 + 6 + 1;
+    script.action[0] = ACT_RECORD;
+    for (int i = 0; i < 6; i++)
+    {
+        script.live[i] = recorded[i];
+    }
+    script.action[6] = ACT_STOP;
+    script.live[6] = 0x0000;
+    script.action[7] = ACT_PLAY;
+    for (int i = 7; i < script.count; i++)
+    {
+        script.live[i] = 0xFFFF; // Pad untouched during playback
+    }
+    run_script(&script);
+
+    // Recorded as runs, one frame per poll
+    uint16_t count;
+    const macro_entry_t *entries = macro_get_entries(&count);
+    CHECK_EQ(count, 4);
+    CHECK_EQ(entries[1].buttons, 0xBFFF);
+    CHECK_EQ(entries[1].polls, 3);
+    CHECK_EQ(macro_get_length(), 6);
+
+    // The stop poll already passed live input through; playback is frame-exact
+    CHECK_EQ(script.seen[6], 0x0000);
+    for (int i = 0; i < 6; i++)
+    {
+        CHECK_EQ(script.seen[7 + i], recorded[i]);
+    }
+    CHECK_EQ(script.seen[13], 0xFFFF);
+    CHECK_EQ(macro_get_state(), MACRO_IDLE);
+}
+
+static void test_requests_before_poll(void)
+{
+    static const macro_entry_t saved[] = {{0xFFFE, 2}, {0xFFFF, 1}};
+
+    firmware_boot();
+    CHECK(macro_load(saved, 2));
+
+    // Record then stop before Core 1 polls: the saved macro is untouched
+    macro_record_start();
+    CHECK_EQ(macro_get_state(), MACRO_RECORDING);
+    CHECK(!macro_load(saved, 1));
+    CHECK(!macro_play_start());
+    macro_stop();
+    CHECK_EQ(macro_get_state(), MACRO_IDLE);
+    CHECK(!macro_load(saved, 1)); // Stop not yet taken by Core 1
+
+    script_t script = {0};
+    script.count = 2;
+    script.live[0] = script.live[1] = 0x7FFF;
+    run_script(&script);
+
+    uint16_t count;
+    macro_get_entries(&count);
+    CHECK_EQ(count, 2);
+    CHECK_EQ(script.seen[0], 0x7FFF);
+    CHECK(macro_load(saved, 1));
+}
+
+static void test_stop_during_playback(void)
+{
+    static const macro_entry_t saved[] = {{0xFFFE, 10}};
+
+    firmware_boot();
+    CHECK(macro_load(saved, 1));
+
+    script_t script = {0};
+    script.count = 5;
+    script.action[0] = ACT_PLAY;
+    script.action[3] = ACT_STOP;
+    for (int i = 0; i < script.count; i++)
+    {
+        script.live[i] = 0xFFFF;
+    }
+    run_script(&script);
+
+    CHECK_EQ(script.seen[0], 0xFFFE);
+    CHECK_EQ(script.seen[2], 0xFFFE);
+    CHECK_EQ(script.seen[3], 0xFFFF);
+    CHECK_EQ(macro_get_state(), MACRO_IDLE);
+}
+
+static void test_trigger(void)
+{
+    static const macro_entry_t saved[] = {{0xFFFE, 100}};
+
+    firmware_boot();
+    CHECK(macro_load(saved, 1));
+    macro_set_trigger(PSX_BTN_SELECT);
+
+    // The press edge starts playback and the trigger never reaches the console
+    uint16_t pressed = 0xFFFE;
+    CHECK_EQ(macro_process_sample(pressed), 0xFFFF);
+    CHECK_EQ(macro_get_state(), MACRO_PLAYING);
+    CHECK_EQ(macro_process_sample(pressed), 0xFFFF);
+    CHECK_EQ(macro_get_state(), MACRO_PLAYING);
+
+    // Next press stops it, even before Core 1 took the play request
+    macro_process_sample(0xFFFF);
+    macro_process_sample(pressed);
+    CHECK_EQ(macro_get_state(), MACRO_IDLE);
+}
+
+static void test_overflow(void)
+{
+    firmware_boot();
+    macro_record_start();
+    for (int i = 0; i <= MACRO_MAX_ENTRIES; i++)
+    {
+        macro_on_poll((uint16_t)(i & 1 ? 0xFFFF : 0xFFFE));
+    }
+    CHECK(macro_overflowed());
+    CHECK_EQ(macro_get_state(), MACRO_IDLE);
+    CHECK_EQ(macro_get_length(), MACRO_MAX_ENTRIES);
+}
+
+int main(void)
+{
+    RUN(test_record_and_play);
+    RUN(test_requests_before_poll);
+    RUN(test_stop_during_playback);
+    RUN(test_trigger);
+    RUN(test_overflow);
+    return TEST_EXIT();
+}
@@ -0,0 +1,193 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Persona poll frames: the bytes each persona builds from the pad, host axes
+// and host motion, and host axes updated from another thread while frames
+// are built
+
+#include "test.h"
+#include "firmware.h"
+#include "persona.h"
+#include "button_input.h"
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define RELEASED 0xFFFF
+#define PRESS(b) ((uint16_t)(RELEASED & ~(1u << (b))))
+
+static uint8_t frame[1 + PERSONA_PAYLOAD_MAX];
+
+// ID byte and frame length of one poll of port 0
+static uint8_t poll(uint16_t buttons, uint8_t *len)
+{
+    uint8_t id = persona_begin(0);
+    *len = persona_poll_frame(0, buttons, frame);
+    return id;
+}
+
+static void test_digital(void)
+{
+    firmware_init();
+    uint8_t len;
+    CHECK_EQ(poll(PRESS(PSX_BTN_CROSS), &len), 0x41);
+    CHECK_EQ(len, 3);
+    CHECK_EQ(frame[0], 0x5A);
+    CHECK_EQ(frame[1], 0xFF);
+    CHECK_EQ(frame[2], 0xBF);
+}
+
+static void test_mouse_dpad(void)
+{
+    firmware_init();
+    CHECK(persona_set(0, PERSONA_MOUSE));
+    uint8_t len;
+    CHECK_EQ(poll(PRESS(PSX_BTN_RIGHT) & PRESS(PSX_BTN_UP), &len), 0x12);
+    CHECK_EQ(len, 5);
+    CHECK_EQ(frame[1], 0xFF); // Only L1/R1 exist on a mouse
+    CHECK_EQ(frame[2], 0xFC); // Bits 0-1 always 0, like a Sony mouse
+    CHECK_EQ((int8_t)frame[3], PERSONA_MOUSE_DPAD_STEP);
+    CHECK_EQ((int8_t)frame[4], -PERSONA_MOUSE_DPAD_STEP);
+
+    poll(PRESS(PSX_BTN_R1), &len);
+    CHECK_EQ(frame[2], 0xF4);
+    CHECK_EQ(frame[3], 0);
+    CHECK_EQ(frame[4], 0);
+}
+
+static void test_mouse_host_motion(void)
+{
+    firmware_init();
+    CHECK(persona_set(0, PERSONA_MOUSE));
+    uint8_t len;
+    poll(RELEASED, &len); // Latch the persona
+
+    // More than one byte: split over polls, the D-pad waits until it is sent
+    persona_add_motion(0, 300, -5);
+    uint16_t held = PRESS(PSX_BTN_LEFT) & PRESS(PSX_BTN_DOWN);
+    poll(held, &len);
+    CHECK_EQ((int8_t)frame[3], 127);
+    CHECK_EQ((int8_t)frame[4], -5);
+    poll(held, &len);
+    CHECK_EQ((int8_t)frame[3], 127);
+    CHECK_EQ((int8_t)frame[4], 0); // Y sent, X still pending: no D-pad on Y either
+    poll(held, &len);
+    CHECK_EQ((int8_t)frame[3], 46);
+    CHECK_EQ((int8_t)frame[4], 0);
+    poll(held, &len);
+    CHECK_EQ((int8_t)frame[3], -PERSONA_MOUSE_DPAD_STEP);
+    CHECK_EQ((int8_t)frame[4], PERSONA_MOUSE_DPAD_STEP);
+
+    // Motion added while another persona answers is dropped on the switch back
+    CHECK(persona_set(0, PERSONA_DIGITAL));
+    poll(RELEASED, &len);
+    persona_add_motion(0, 10, 10);
+    CHECK(persona_set(0, PERSONA_MOUSE));
+    poll(RELEASED, &len);
+    CHECK_EQ(frame[3], 0);
+    CHECK_EQ(frame[4], 0);
+}
+
+static void test_negcon(void)
+{
+    firmware_init();
+    CHECK(persona_set(0, PERSONA_NEGCON));
+    uint8_t len;
+
+    // Rest values without host input, buttons to full scale
+    CHECK_EQ(poll(RELEASED, &len), 0x23);
+    CHECK_EQ(len, 7);
+    CHECK_EQ(frame[3], 0x80);
+    CHECK_EQ(frame[4], 0x00);
+    poll(PRESS(PSX_BTN_L2) & PRESS(PSX_BTN_CROSS), &len);
+    CHECK_EQ(frame[3], 0x00);
+    CHECK_EQ(frame[4], 0xFF);
+
+    // Host axes, overridden by a held button, and gone again with NULL
+    const uint8_t axes[PERSONA_AXES] = {0x10, 0x20, 0x30, 0x40};
+    persona_set_axes(0, axes);
+    poll(RELEASED, &len);
+    CHECK_EQ(frame[3], 0x10);
+    CHECK_EQ(frame[4], 0x20);
+    CHECK_EQ(frame[5], 0x30);
+    CHECK_EQ(frame[6], 0x40);
+    poll(PRESS(PSX_BTN_R2), &len);
+    CHECK_EQ(frame[3], 0xFF);
+    persona_set_axes(0, NULL);
+    poll(RELEASED, &len);
+    CHECK_EQ(frame[3], 0x80);
+    CHECK_EQ(frame[6], 0x00);
+}
+
+// ============================================================================
+// Axes From Another Thread
+// ============================================================================
+
+#define AXES_UPDATES 1000000
+
+static atomic_bool writer_done;
+
+// Core 0 stand-in: every update sets all axes to one value, or clears them
+static void *axes_writer(void *arg)
+{
+    for (uint32_t i = 1; i <= AXES_UPDATES; i++)
+    {
+        uint8_t value = (uint8_t)(i | 1u);
+        const uint8_t axes[PERSONA_AXES] = {value, value, value, value};
+        persona_set_axes(0, (i & 7) == 0 ? NULL : axes);
+    }
+    atomic_store(&writer_done, true);
+    return NULL;
+}
+
+static void test_axes_not_torn(void)
+{
+    firmware_init();
+    CHECK(persona_set(0, PERSONA_NEGCON));
+    uint8_t len;
+    poll(RELEASED, &len);
+
+    atomic_store(&writer_done, false);
+    pthread_t thread;
+    pthread_create(&thread, NULL, axes_writer, NULL);
+
+    // Either the rest values or four equal host values, never a mix
+    uint32_t frames = 0, torn = 0, host = 0;
+    while (!atomic_load(&writer_done))
+    {
+        persona_poll_frame(0, RELEASED, frame);
+        frames++;
+        bool rest = frame[3] == 0x80 && frame[4] == 0 && frame[5] == 0 && frame[6] == 0;
+        bool equal = frame[3] == frame[4] && frame[4] == frame[5] && frame[5] == frame[6];
+        torn += !rest && !equal;
+        host += !rest;
+    }
+    pthread_join(thread, NULL);
+
+    printf("     %u frames, %u with host axes, %u torn\n", frames, host, torn);
+    CHECK_EQ(torn, 0);
+}
+
+int main(void)
+{
+    RUN(test_digital);
+    RUN(test_mouse_dpad);
+    RUN(test_mouse_host_motion);
+    RUN(test_negcon);
+    RUN(test_axes_not_torn);
+    return TEST_EXIT();
+}
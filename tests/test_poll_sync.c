@@ -0,0 +1,129 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Phase-locked sampling: sample age at each console poll, with Core 0's
+// tasks stepped on their scheduler periods against a drifting console clock
+
+#include "test.h"
+#include "config.h"
+#include "poll_sync.h"
+
+// Console polls every period_ns (not a whole number of µs) from phase_us.
+// Every SCHED_PSYNC_PERIOD_US the psync task sees the latest poll and takes
+// its extra sample when due; every BUTTON_POLL_INTERVAL_US a fixed sample.
+static void simulate(uint32_t margin_us, uint64_t period_ns, uint32_t phase_us, uint32_t seconds,
+                     poll_sync_stats_t *stats)
+{
+    poll_sync_init();
+    CHECK(poll_sync_set_margin(margin_us));
+
+    uint32_t polls = 0;
+    uint64_t next_poll_ns = (uint64_t)phase_us * 1000;
+    uint32_t last_poll_time = 0;
+    bool reset = false;
+
+    // Time 0 is never a sample or poll time (0 means "none" in the history)
+    for (uint32_t now = 1; now < seconds * 1000000u; now++)
+    {
+        while (next_poll_ns <= (uint64_t)now * 1000)
+        {
+            polls++;
+            last_poll_time = (uint32_t)(next_poll_ns / 1000);
+            next_poll_ns += period_ns;
+        }
+
+        if (now % SCHED_PSYNC_PERIOD_US == 0)
+        {
+            poll_sync_update(polls, last_poll_time);
+            if (poll_sync_sample_due(now))
+            {
+                poll_sync_on_sample(now);
+            }
+        }
+        if (now % BUTTON_POLL_INTERVAL_US == 0)
+        {
+            poll_sync_on_sample(now);
+        }
+
+        // Ages count from one second in, well after locking
+        if (!reset && now == 1000000)
+        {
+            poll_sync_reset_stats();
+            reset = true;
+        }
+    }
+    poll_sync_get_stats(stats);
+}
+
+static void test_fixed_rate_only(void)
+{
+    // Without the extra sample the age is spread over the whole 1 ms
+    poll_sync_stats_t stats;
+    simulate(0, 16683333, 123, 3, &stats);
+    CHECK(stats.age_count > 100);
+    CHECK(stats.age_max > 900);
+    CHECK(stats.age_min < 100);
+    CHECK(stats.age_stddev > 200);
+}
+
+static void test_age_bounded_by_task_period(void)
+{
+    // The extra sample lands on the first psync run at or after poll - margin:
+    // its age at the poll is margin - [0, SCHED_PSYNC_PERIOD_US). A fixed-rate
+    // sample in between only makes it younger.
+    static const uint32_t margins[] = {100, 200, 500};
+    for (size_t i = 0; i < sizeof(margins) / sizeof(margins[0]); i++)
+    {
+        poll_sync_stats_t stats;
+        simulate(margins[i], 16683333, 321, 3, &stats);
+        CHECK(stats.locked);
+        CHECK(stats.age_count > 100);
+        CHECK(stats.age_max <= margins[i]);
+    }
+}
+
+static void test_tracks_drift(void)
+{
+    // PAL frame rate and a console clock 200 ppm slow
+    poll_sync_stats_t stats;
+    simulate(200, 20000000 + 4000, 77, 4, &stats);
+    CHECK(stats.locked);
+    CHECK_EQ(stats.relocks, 1);
+    CHECK(stats.age_max <= 200);
+    CHECK(stats.phase_err_max <= 2);
+}
+
+static void test_margin_below_task_period(void)
+{
+    // The lead cannot be finer than the task period: with margin 20 the
+    // sample may come up to 30 µs after the poll and the older fixed-rate
+    // (or previous) sample is what the console gets
+    poll_sync_stats_t stats;
+    simulate(20, 16683333, 321, 3, &stats);
+    CHECK(stats.locked);
+    CHECK(stats.age_max > SCHED_PSYNC_PERIOD_US);
+}
+
+int main(void)
+{
+    RUN(test_fixed_rate_only);
+    RUN(test_age_bounded_by_task_period);
+    RUN(test_tracks_drift);
+    RUN(test_margin_below_task_period);
+    return TEST_EXIT();
+}
@@ -0,0 +1,231 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Core 0 deadline scheduler: priority then earliest deadline, one task per
+// pass, sleeping until the next deadline, overruns, skipped periods and the
+// statistics reset
+
+#include "test.h"
+#include "sim.h"
+#include "sched.h"
+#include "pico/stdlib.h"
+#include <string.h>
+
+// Run order as task letters, and how long each task takes
+static char order[64];
+static int order_len;
+static uint32_t exec_us[3];
+
+static void record(char name, int index)
+{
+    if (order_len < (int)sizeof(order) - 1)
+    {
+        order[order_len++] = name;
+    }
+    busy_wait_us_32(exec_us[index]);
+}
+
+static void run_a(uint32_t now)
+{
+    record('A', 0);
+}
+
+static void run_b(uint32_t now)
+{
+    record('B', 1);
+}
+
+static void run_c(uint32_t now)
+{
+    record('C', 2);
+}
+
+static void clear(void)
+{
+    memset(order, 0, sizeof(order));
+    order_len = 0;
+    memset(exec_us, 0, sizeof(exec_us));
+}
+
+// Scheduler calls need a core (time and WFE): run the scenario on Core 0
+static void run_on_core0(sim_entry_t scenario, uint32_t limit_us)
+{
+    sim_reset();
+    sim_spawn("core0", SIM_CORE0, scenario, NULL);
+    CHECK(sim_run(limit_us));
+}
+
+static uint32_t total_runs(const sched_task_t *tasks, int count)
+{
+    uint32_t runs = 0;
+    for (int i = 0; i < count; i++)
+    {
+        runs += tasks[i].runs;
+    }
+    return runs;
+}
+
+// ============================================================================
+// Order
+// ============================================================================
+
+static void priority_scenario(void *arg)
+{
+    sched_task_t tasks[] = {
+        SCHED_TASK("a", run_a, 1000, 100, 2),
+        SCHED_TASK("b", run_b, 1000, 100, 0),
+        SCHED_TASK("c", run_c, 1000, 100, 1),
+    };
+    sched_init(tasks, 3);
+
+    // All due at once: one task per pass, highest priority first
+    for (int pass = 1; pass <= 3; pass++)
+    {
+        sched_run();
+        CHECK_EQ(total_runs(tasks, 3), pass);
+    }
+    CHECK(strcmp(order, "BCA") == 0);
+}
+
+static void test_priority_order(void)
+{
+    clear();
+    run_on_core0(priority_scenario, 1000);
+}
+
+static void deadline_scenario(void *arg)
+{
+    sched_task_t tasks[] = {
+        SCHED_TASK("a", run_a, 1000, 100, 1),
+        SCHED_TASK("b", run_b, 1000, 100, 1),
+        SCHED_TASK("c", run_c, 1000, 100, 0),
+    };
+    sched_init(tasks, 3);
+
+    // Equal priorities: the earlier deadline first, whatever the table order
+    busy_wait_us_32(500);
+    uint32_t now = time_us_32();
+    tasks[0].next_due = now - 50;
+    tasks[1].next_due = now - 200;
+    tasks[2].next_due = now + 100; // Higher priority but not due yet
+    sched_run();
+    sched_run();
+    CHECK(strcmp(order, "BA") == 0);
+
+    // Nothing due: the pass sleeps until the earliest deadline, then C runs
+    sched_run();
+    CHECK_EQ(order_len, 2);
+    CHECK(time_us_32() >= now + 100);
+    sched_run();
+    CHECK(strcmp(order, "BAC") == 0);
+    CHECK(tasks[2].max_late_us < 10);
+}
+
+static void test_deadline_order(void)
+{
+    clear();
+    run_on_core0(deadline_scenario, 2000);
+}
+
+// ============================================================================
+// Timing
+// ============================================================================
+
+// Fast: 1 ms period, priority 0. Slow: runs 500 us against a 400 us budget.
+static sched_task_t mix[2];
+
+static void mix_scenario(void *arg)
+{
+    sched_task_t tasks[] = {
+        SCHED_TASK("fast", run_a, 1000, 100, 0),
+        SCHED_TASK("slow", run_b, 3000, 400, 1),
+    };
+    memcpy(mix, tasks, sizeof(mix));
+    exec_us[0] = 20;
+    exec_us[1] = 500;
+    sched_init(mix, 2);
+
+    // The slow task starts just before the fast one is due
+    mix[1].next_due += 900;
+    while (time_us_32() < 30000)
+    {
+        sched_run();
+    }
+}
+
+static void test_slow_task(void)
+{
+    clear();
+    run_on_core0(mix_scenario, 40000);
+
+    // Every period of both ran; the slow task overran each time but delayed
+    // the fast one by at most one of its own runs
+    printf("     fast late by up to %u us\n", mix[0].max_late_us);
+    CHECK(mix[0].runs >= 29 && mix[0].runs <= 31);
+    CHECK(mix[1].runs >= 9 && mix[1].runs <= 10);
+    CHECK_EQ(mix[0].skipped + mix[1].skipped, 0);
+    CHECK_EQ(mix[0].overruns, 0);
+    CHECK_EQ(mix[1].overruns, mix[1].runs);
+    CHECK(mix[1].max_exec_us >= 500 && mix[1].max_exec_us < 510);
+    CHECK(mix[0].max_late_us >= 350 && mix[0].max_late_us <= 510);
+}
+
+static sched_task_t skip_task;
+
+static void skip_scenario(void *arg)
+{
+    skip_task = (sched_task_t)SCHED_TASK("skip", run_a, 100, 50, 0);
+    exec_us[0] = 350;
+    sched_init(&skip_task, 1);
+    uint32_t start = skip_task.next_due;
+
+    // A 350 us run of a 100 us period misses three deadlines: fixed rate,
+    // not run back to back to catch up
+    sched_run();
+    CHECK_EQ(skip_task.skipped, 3);
+    CHECK_EQ(skip_task.next_due, start + 400);
+    CHECK_EQ(skip_task.overruns, 1);
+
+    sched_run();
+    CHECK_EQ(skip_task.runs, 1); // Slept until start + 400
+    sched_run();
+    CHECK_EQ(skip_task.runs, 2);
+    CHECK_EQ(skip_task.skipped, 6);
+    CHECK_EQ(skip_task.next_due, start + 800);
+
+    // The statistics reset keeps the deadline
+    sched_reset_stats();
+    CHECK_EQ(skip_task.runs + skip_task.skipped + skip_task.overruns, 0);
+    CHECK_EQ(skip_task.max_exec_us + skip_task.max_late_us, 0);
+    CHECK_EQ(skip_task.next_due, start + 800);
+}
+
+static void test_skipped_periods(void)
+{
+    clear();
+    run_on_core0(skip_scenario, 2000);
+}
+
+int main(void)
+{
+    RUN(test_priority_order);
+    RUN(test_deadline_order);
+    RUN(test_slow_task);
+    RUN(test_skipped_periods);
+    return TEST_EXIT();
+}
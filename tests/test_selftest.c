@@ -0,0 +1,236 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Loopback self-test on the simulated board: Core 0 plays the console on
+// the SELFTEST_PIN_* pins, jumpered to the port 1 bus pins, against Core 1
+
+#include "test.h"
+#include "sim.h"
+#include "firmware.h"
+#include "config.h"
+#include "selftest.h"
+#include "persona.h"
+#include "console.h"
+#include "hardware/clocks.h"
+#include "hardware/gpio.h"
+#include "pico/multicore.h"
+#include <unistd.h>
+
+// Jumpers of the self-test; skip one with skip_pin
+static void wire(unsigned int skip_pin)
+{
+    static const unsigned int jumpers[][2] = {
+        {SELFTEST_PIN_SEL, PIN_SEL}, {SELFTEST_PIN_CLK, PIN_CLK}, {SELFTEST_PIN_CMD, PIN_CMD},
+        {SELFTEST_PIN_DAT, PIN_DAT}, {SELFTEST_PIN_ACK, PIN_ACK},
+    };
+
+    // firmware_boot() has a console driving SEL, CLK and CMD: unplug it
+    sim_drive(PIN_SEL, SIM_RELEASE);
+    sim_drive(PIN_CLK, SIM_RELEASE);
+    sim_drive(PIN_CMD, SIM_RELEASE);
+    for (size_t i = 0; i < sizeof(jumpers) / sizeof(jumpers[0]); i++)
+    {
+        if (jumpers[i][1] != skip_pin)
+        {
+            sim_connect(jumpers[i][0], jumpers[i][1]);
+        }
+    }
+}
+
+// ============================================================================
+// Reports (Core 0 coroutine, printed output captured)
+// ============================================================================
+
+static char output[4096];
+
+static void report_task(void *arg)
+{
+    uint32_t clock_khz = *(uint32_t *)arg;
+    if (clock_khz == UINT32_MAX)
+    {
+        selftest_clock_report();
+    }
+    else
+    {
+        selftest_report(clock_khz);
+    }
+}
+
+// Run a report with stdout going to output[]
+static void run_report(uint32_t clock_khz)
+{
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    FILE *capture = tmpfile();
+    dup2(fileno(capture), STDOUT_FILENO);
+
+    sim_spawn("core0", SIM_CORE0, report_task, &clock_khz);
+    CHECK(sim_run(10000000));
+
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+    rewind(capture);
+    size_t len = fread(output, 1, sizeof(output) - 1, capture);
+    output[len] = '\0';
+    fclose(capture);
+}
+
+static void test_missing_jumper(void)
+{
+    firmware_boot();
+    wire(PIN_ACK);
+    run_report(250);
+    CHECK(strstr(output, "No connection: GPIO 7 -> GPIO 8 (ACK)") != NULL);
+    CHECK(strstr(output, "passed") == NULL);
+
+    firmware_boot();
+    wire(PIN_CLK);
+    run_report(250);
+    CHECK(strstr(output, "No connection: GPIO 1 -> GPIO 6 (CLK)") != NULL);
+}
+
+static void test_report(void)
+{
+    firmware_boot();
+    wire(0xFF);
+    run_report(250);
+    CHECK(strstr(output, "Highest fully passing clock: 250 kHz") != NULL);
+    CHECK(strstr(output, "No connection") == NULL);
+}
+
+static void test_clock_sweep_restores_clock(void)
+{
+    firmware_boot();
+    wire(0xFF);
+    run_report(UINT32_MAX);
+    CHECK(strstr(output, "Restored 125 MHz") != NULL);
+    CHECK_EQ(clock_get_hz(clk_sys), SYS_CLOCK_KHZ * 1000u);
+}
+
+static void restart_core1_task(void *arg)
+{
+    core1_stop();
+    set_sys_clock_khz(*(uint32_t *)arg, true);
+    multicore_launch_core1(core1_entry);
+}
+
+static void settle_poll_task(void *arg)
+{
+    // First CLK rising edge 700 ns past PSX_SEL_SETTLE_NS: only caught if
+    // Core 1's settle time is counted in cycles of the clock it runs at now
+    console_t console = console_default(0);
+    console.clock_khz = 1000;
+    console.sel_setup_ns = PSX_SEL_SETTLE_NS + 200;
+    console_connect(&console);
+    console_poll(&console, arg);
+}
+
+// Core 1 converts the SEL settle time to cycles of clk_sys when it starts:
+// with Core 1 started at the last sweep step's clock, the settle time must
+// follow the restored clock instead of doubling
+static void test_clock_sweep_settle_time(void)
+{
+    firmware_boot();
+    uint32_t khz = 250000;
+    sim_spawn("core0", SIM_CORE0, restart_core1_task, &khz);
+    CHECK(sim_run(1000));
+    wire(0xFF);
+    run_report(UINT32_MAX);
+
+    sim_run(100); // Core 1 was started again by the report
+
+    console_result_t result = {0};
+    sim_spawn("console", SIM_EXTERNAL, settle_poll_task, &result);
+    sim_run(1000);
+    CHECK_EQ(result.len, 5);
+    CHECK_EQ(result.dat[1], 0x41);
+    CHECK_EQ(result.dat[2], 0x5A);
+}
+
+// ============================================================================
+// One Run (results checked field by field)
+// ============================================================================
+
+typedef struct
+{
+    uint32_t clock_khz;
+    bool wired;
+    selftest_result_t result;
+} run_t;
+
+static void run_task(void *arg)
+{
+    run_t *run = arg;
+
+    // What selftest_report() sets up before a run
+    const unsigned int outputs[] = {SELFTEST_PIN_SEL, SELFTEST_PIN_CLK, SELFTEST_PIN_CMD};
+    for (size_t i = 0; i < sizeof(outputs) / sizeof(outputs[0]); i++)
+    {
+        gpio_init(outputs[i]);
+        gpio_put(outputs[i], 1);
+        gpio_set_dir(outputs[i], GPIO_OUT);
+    }
+    gpio_init(SELFTEST_PIN_DAT);
+    gpio_pull_up(SELFTEST_PIN_DAT);
+    gpio_init(SELFTEST_PIN_ACK);
+    gpio_pull_up(SELFTEST_PIN_ACK);
+
+    run->wired = selftest_check_wiring();
+    selftest_run(run->clock_khz, &run->result);
+}
+
+static void test_run_results(void)
+{
+    static const uint32_t rates[] = {250, 500};
+    for (size_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++)
+    {
+        firmware_boot();
+        wire(0xFF);
+        persona_set(0, PERSONA_MOUSE);
+
+        run_t run = {.clock_khz = rates[i]};
+        sim_spawn("core0", SIM_CORE0, run_task, &run);
+        CHECK(sim_run(10000000));
+
+        const selftest_result_t *r = &run.result;
+        CHECK(run.wired);
+        CHECK_EQ(r->clock_khz, rates[i]);
+        CHECK_EQ(r->transactions, SELFTEST_TRANSACTIONS);
+        CHECK_EQ(r->passed, SELFTEST_TRANSACTIONS);
+        CHECK_EQ(r->byte_errors, 0);
+        CHECK_EQ(r->ack_missing, 0);
+        CHECK_EQ(r->ack_after_last, 0);
+        CHECK(r->ack_delay_min_ns > 0 && r->ack_delay_min_ns <= r->ack_delay_max_ns);
+        CHECK(r->ack_width_min_ns > 0 && r->ack_width_min_ns <= r->ack_width_max_ns);
+        CHECK(r->dat_latency_max_ns > 0 && r->dat_latency_max_ns < 500000 / rates[i]);
+
+        // The test answers as a digital pad and puts the persona back
+        CHECK_EQ(persona_get(0), PERSONA_MOUSE);
+    }
+}
+
+int main(void)
+{
+    RUN(test_missing_jumper);
+    RUN(test_run_results);
+    RUN(test_report);
+    RUN(test_clock_sweep_restores_clock);
+    RUN(test_clock_sweep_settle_time);
+    return TEST_EXIT();
+}
@@ -0,0 +1,129 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Sequence lock under two real threads: a writer updating a multi-word
+// snapshot and a reader that must never see a mix of two updates
+
+#include "test.h"
+#include "seqlock.h"
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define WORDS 16
+#define UPDATES 2000000
+
+static volatile uint32_t seq = 0;
+static volatile uint32_t data[WORDS];
+static atomic_bool writer_done;
+
+static void *writer(void *arg)
+{
+    for (uint32_t value = 1; value <= UPDATES; value++)
+    {
+        seqlock_write_begin(&seq);
+        for (int i = 0; i < WORDS; i++)
+        {
+            data[i] = value;
+        }
+        seqlock_write_end(&seq);
+    }
+    atomic_store(&writer_done, true);
+    return NULL;
+}
+
+// Consistent copy, returns the number of retries
+static uint32_t read_copy(uint32_t *copy)
+{
+    uint32_t retries = 0;
+    uint32_t start;
+    do
+    {
+        retries++;
+        start = seqlock_read_begin(&seq);
+        for (int i = 0; i < WORDS; i++)
+        {
+            copy[i] = data[i];
+        }
+    } while (seqlock_read_retry(&seq, start));
+    return retries - 1;
+}
+
+static void test_two_threads(void)
+{
+    pthread_t thread;
+    uint32_t torn = 0;
+    uint32_t reads = 0;
+    uint32_t retries = 0;
+    uint32_t last = 0;
+    bool backwards = false;
+
+    atomic_store(&writer_done, false);
+    CHECK_EQ(pthread_create(&thread, NULL, writer, NULL), 0);
+
+    while (!atomic_load(&writer_done))
+    {
+        uint32_t copy[WORDS];
+        retries += read_copy(copy);
+        reads++;
+        for (int i = 1; i < WORDS; i++)
+        {
+            if (copy[i] != copy[0])
+            {
+                torn++;
+                break;
+            }
+        }
+        backwards |= copy[0] < last;
+        last = copy[0];
+    }
+    pthread_join(thread, NULL);
+
+    printf("  %u reads, %u retries\n", reads, retries);
+    CHECK(reads > 0);
+    CHECK_EQ(torn, 0);
+    CHECK(!backwards);
+    CHECK_EQ(seq, 2u * UPDATES);
+}
+
+static void test_recover_after_abandoned_write(void)
+{
+    // Writer stopped between begin and end: readers would spin
+    seq = 6;
+    seqlock_write_begin(&seq);
+    CHECK(seqlock_read_retry(&seq, seqlock_read_begin(&seq)));
+
+    // Restarted writer makes it readable, and the next update still works
+    seqlock_recover(&seq);
+    CHECK_EQ(seq, 8);
+    CHECK(!seqlock_read_retry(&seq, seqlock_read_begin(&seq)));
+    seqlock_write_begin(&seq);
+    CHECK_EQ(seq, 9);
+    seqlock_write_end(&seq);
+    CHECK_EQ(seq, 10);
+
+    // Nothing to do on an even sequence
+    seqlock_recover(&seq);
+    CHECK_EQ(seq, 10);
+}
+
+int main(void)
+{
+    RUN(test_two_threads);
+    RUN(test_recover_after_abandoned_write);
+    return TEST_EXIT();
+}
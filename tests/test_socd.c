@@ -0,0 +1,174 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SOCD cleaner: timestamped direction sequences through every mode
+
+#include "test.h"
+#include "socd.h"
+
+#define UP 0x10
+#define RIGHT 0x20
+#define DOWN 0x40
+#define LEFT 0x80
+
+// PSX byte 1 with the given directions pressed (0 = pressed)
+#define PRESS(dirs) ((uint8_t)(0xFF & ~(dirs)))
+
+typedef struct
+{
+    uint32_t now_us;
+    uint8_t held;     // Directions physically held
+    uint8_t reported; // Directions the console should see
+} step_t;
+
+static void run_steps(socd_mode_t mode, const step_t *steps, int count)
+{
+    CHECK(socd_set_mode(mode));
+    for (int i = 0; i < count; i++)
+    {
+        uint8_t out = socd_apply(PRESS(steps[i].held), steps[i].now_us);
+        uint8_t want = PRESS(steps[i].reported);
+        if (out != want)
+        {
+            fprintf(stderr, "  %s step %d: got %02X, expected %02X\n", socd_mode_name(mode), i, out, want);
+            test_failures++;
+        }
+    }
+}
+
+static void test_off(void)
+{
+    static const step_t steps[] = {
+        {0, LEFT | RIGHT, LEFT | RIGHT},
+        {1000, UP | DOWN | LEFT, UP | DOWN | LEFT},
+    };
+    run_steps(SOCD_MODE_OFF, steps, 2);
+    CHECK_EQ(socd_resolve_latched(PRESS(LEFT | RIGHT), PRESS(0)), PRESS(LEFT | RIGHT));
+}
+
+static void test_neutral(void)
+{
+    static const step_t steps[] = {
+        {0, LEFT, LEFT},
+        {1000, LEFT | RIGHT, 0},
+        {2000, LEFT | RIGHT | UP, UP},
+        {3000, UP | DOWN | RIGHT, RIGHT},
+        {4000, RIGHT, RIGHT},
+    };
+    run_steps(SOCD_MODE_NEUTRAL, steps, 5);
+}
+
+static void test_last_win(void)
+{
+    static const step_t steps[] = {
+        {0, LEFT, LEFT},
+        {1000, LEFT | RIGHT, RIGHT},        // RIGHT is newer
+        {2000, LEFT | RIGHT, RIGHT},        // Holding doesn't change the order
+        {3000, LEFT, LEFT},                 // RIGHT let go: LEFT comes back
+        {4000, LEFT | RIGHT, RIGHT},        // RIGHT pressed again wins again
+        {5000, 0, 0},
+        {6000, UP | DOWN, 0},               // Same sample: neutral
+        {7000, UP | DOWN, 0},
+        {8000, DOWN, DOWN},
+        {9000, UP | DOWN, UP},
+    };
+    run_steps(SOCD_MODE_LAST_WIN, steps, 10);
+}
+
+static void test_first_win(void)
+{
+    static const step_t steps[] = {
+        {0, LEFT, LEFT},
+        {1000, LEFT | RIGHT, LEFT},  // LEFT was held first
+        {2000, RIGHT, RIGHT},        // LEFT let go
+        {3000, LEFT | RIGHT, RIGHT}, // Now RIGHT is the older press
+        {4000, UP | DOWN, 0},        // Same sample: neutral
+    };
+    run_steps(SOCD_MODE_FIRST_WIN, steps, 5);
+}
+
+static void test_up_priority(void)
+{
+    static const step_t steps[] = {
+        {0, DOWN, DOWN},
+        {1000, UP | DOWN, UP},
+        {2000, LEFT | RIGHT, 0},
+        {3000, UP | DOWN | LEFT | RIGHT, UP},
+    };
+    run_steps(SOCD_MODE_UP_PRIORITY, steps, 4);
+}
+
+static void test_timestamp_wrap(void)
+{
+    // time_us_32() wraps every ~71 minutes; order must survive it
+    static const step_t steps[] = {
+        {0xFFFFFF00u, LEFT, LEFT},
+        {0x00000100u, LEFT | RIGHT, RIGHT},
+    };
+    run_steps(SOCD_MODE_LAST_WIN, steps, 2);
+}
+
+static void test_mode_change_resets_order(void)
+{
+    CHECK(socd_set_mode(SOCD_MODE_LAST_WIN));
+    socd_apply(PRESS(LEFT), 0);
+    socd_apply(PRESS(LEFT | RIGHT), 1000);
+
+    // After a mode change both directions count as pressed in the same sample
+    CHECK(socd_set_mode(SOCD_MODE_LAST_WIN));
+    CHECK_EQ(socd_apply(PRESS(LEFT | RIGHT), 2000), PRESS(0));
+    CHECK(!socd_set_mode(SOCD_MODE_COUNT));
+}
+
+static void test_latched(void)
+{
+    CHECK(socd_set_mode(SOCD_MODE_LAST_WIN));
+
+    // LEFT and RIGHT latched from different samples: the current sample decides
+    CHECK_EQ(socd_resolve_latched(PRESS(LEFT | RIGHT | UP), PRESS(RIGHT)), PRESS(RIGHT | UP));
+    CHECK_EQ(socd_resolve_latched(PRESS(LEFT | RIGHT), PRESS(0)), PRESS(0));
+    // One direction per axis is kept as latched
+    CHECK_EQ(socd_resolve_latched(PRESS(LEFT | DOWN), PRESS(0)), PRESS(LEFT | DOWN));
+    CHECK_EQ(socd_resolve_latched(PRESS(UP | DOWN), PRESS(DOWN)), PRESS(DOWN));
+}
+
+static void test_names(void)
+{
+    for (int mode = 0; mode < SOCD_MODE_COUNT; mode++)
+    {
+        CHECK_EQ(socd_parse_mode(socd_mode_name((socd_mode_t)mode)), mode);
+    }
+    CHECK_EQ(socd_parse_mode("sideways"), SOCD_MODE_COUNT);
+}
+
+int main(void)
+{
+    socd_init();
+    CHECK_EQ(socd_get_mode(), SOCD_MODE_NEUTRAL);
+
+    RUN(test_off);
+    RUN(test_neutral);
+    RUN(test_last_win);
+    RUN(test_first_win);
+    RUN(test_up_priority);
+    RUN(test_timestamp_wrap);
+    RUN(test_mode_change_resets_order);
+    RUN(test_latched);
+    RUN(test_names);
+    return TEST_EXIT();
+}
@@ -0,0 +1,243 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// CLK edge timeouts learned from the bus: their values after a few polls,
+// how fast a stalled console is noticed, the back-off after a longer pause
+// than learned, and SEL releases not counted as timeouts
+
+#include "test.h"
+#include "sim.h"
+#include "console.h"
+#include "firmware.h"
+#include "config.h"
+#include "psx_bitbang.h"
+#include "shared_state.h"
+
+#define HALF_NS 2000 // 250 kHz
+
+static const psx_port_pins_t *pins;
+
+// Timeout counts survive a reboot of the simulated board: compare to these
+static uint32_t counted_at_boot[PSX_TIMEOUT_STAGE_COUNT];
+
+// Timeouts of a stage since boot_warm()
+static uint32_t timeouts(psx_timeout_stage_t stage)
+{
+    return psx_timing_get_timeouts(0, stage) - counted_at_boot[stage];
+}
+
+// Clock the low `bits` bits of a byte like console.c does
+static void clock_bits(uint8_t value, int bits)
+{
+    for (int bit = 0; bit < bits; bit++)
+    {
+        sim_drive(pins->clk, 0);
+        sim_drive(pins->cmd, (value >> bit) & 1);
+        sim_delay_ns(HALF_NS);
+        sim_drive(pins->clk, 1);
+        sim_delay_ns(HALF_NS);
+    }
+    sim_drive(pins->cmd, 1);
+}
+
+static bool answered(const console_result_t *result)
+{
+    return result->len == 5 && result->dat[1] == 0x41 && result->dat[2] == 0x5A && !result->driven_after_sel;
+}
+
+// Polls at 250 kHz so the period and gap estimates settle
+static void warm_up(void *arg)
+{
+    console_t console = console_default(0);
+    for (int i = 0; i < 20; i++)
+    {
+        console_result_t result;
+        console_poll(&console, &result);
+        sim_delay_ns(100000);
+    }
+}
+
+static void boot_warm(void)
+{
+    firmware_boot();
+    for (int stage = 0; stage < PSX_TIMEOUT_STAGE_COUNT; stage++)
+    {
+        counted_at_boot[stage] = psx_timing_get_timeouts(0, (psx_timeout_stage_t)stage);
+    }
+    pins = &psx_port_pins[0];
+    shared_state_write(0, 0xFF, 0xFF);
+    sim_spawn("console", SIM_EXTERNAL, warm_up, NULL);
+    CHECK(sim_run(100000));
+}
+
+static void test_learned_values(void)
+{
+    boot_warm();
+
+    // 7 periods of 4 us over 4 periods + slack, capped at the profile limit
+    uint32_t intra = psx_timing_get_timeout_us(0, PSX_TIMEOUT_INTRA_BYTE);
+    uint32_t inter = psx_timing_get_timeout_us(0, PSX_TIMEOUT_INTER_BYTE);
+    uint32_t gap = psx_timing_get_gap_us(0);
+    printf("     intra %u us, inter %u us (gap %u us), address %u us\n", intra, inter, gap,
+           psx_timing_get_timeout_us(0, PSX_TIMEOUT_ADDRESS));
+    CHECK(intra >= 4 * PSX_TIMEOUT_INTRA_PERIODS && intra <= 4 * PSX_TIMEOUT_INTRA_PERIODS + PSX_TIMEOUT_SLACK_US + 1);
+    CHECK(gap > 0 && inter >= gap * PSX_TIMEOUT_INTER_FACTOR && inter < PSX_CLK_TIMEOUT_US);
+    CHECK_EQ(psx_timing_get_timeout_us(0, PSX_TIMEOUT_ADDRESS), PSX_CLK_TIMEOUT_US);
+    for (int stage = 0; stage < PSX_TIMEOUT_STAGE_COUNT; stage++)
+    {
+        CHECK_EQ(timeouts((psx_timeout_stage_t)stage), 0);
+    }
+}
+
+// ============================================================================
+// Stalled Console
+// ============================================================================
+
+typedef struct
+{
+    uint64_t noticed_ns; // Last CLK edge to the timeout being counted (0 = never)
+    console_result_t next;
+} stall_t;
+
+// Address byte, then three bits of the command byte and no more with SEL LOW
+static void stall_task(void *arg)
+{
+    stall_t *stall = arg;
+    uint32_t before = timeouts(PSX_TIMEOUT_INTRA_BYTE);
+
+    sim_drive(pins->sel, 0);
+    sim_delay_ns(20000);
+    clock_bits(PSX_ADDR_CONTROLLER, 8);
+    sim_wait_level(pins->ack, 0, 100000, NULL);
+    sim_wait_level(pins->ack, 1, 100000, NULL);
+    sim_delay_ns(10000);
+    clock_bits(PSX_CMD_POLL, 3);
+
+    uint64_t stopped = sim_now_ns();
+    while (sim_now_ns() - stopped < 1000000)
+    {
+        if (timeouts(PSX_TIMEOUT_INTRA_BYTE) != before)
+        {
+            stall->noticed_ns = sim_now_ns() - stopped;
+            break;
+        }
+        sim_delay_ns(250);
+    }
+    sim_drive(pins->sel, 1);
+
+    // The next poll is served normally
+    sim_delay_ns(50000);
+    console_t console = console_default(0);
+    console_poll(&console, &stall->next);
+}
+
+static void test_stalled_console(void)
+{
+    boot_warm();
+    uint32_t intra = psx_timing_get_timeout_us(0, PSX_TIMEOUT_INTRA_BYTE);
+
+    stall_t stall = {0};
+    sim_spawn("console", SIM_EXTERNAL, stall_task, &stall);
+    CHECK(sim_run(10000000));
+
+    printf("     stall noticed after %llu ns (intra-byte timeout %u us, profile %u us)\n",
+           (unsigned long long)stall.noticed_ns, intra, PSX_CLK_TIMEOUT_US);
+    CHECK(stall.noticed_ns > 0);
+    CHECK(stall.noticed_ns <= (intra + 2) * 1000ull);
+    CHECK(answered(&stall.next));
+}
+
+// ============================================================================
+// Longer Pause Than Learned
+// ============================================================================
+
+typedef struct
+{
+    uint32_t gap_ns;
+    console_result_t result[3];
+} pause_t;
+
+static void pause_task(void *arg)
+{
+    pause_t *pause = arg;
+    console_t console = console_default(0);
+    console.byte_gap_ns = pause->gap_ns;
+    for (int i = 0; i < 3; i++)
+    {
+        console_poll(&console, &pause->result[i]);
+        sim_delay_ns(100000);
+    }
+}
+
+static void test_backoff(void)
+{
+    boot_warm();
+    uint32_t inter = psx_timing_get_timeout_us(0, PSX_TIMEOUT_INTER_BYTE);
+
+    // Beyond the learned limit but within the profile's
+    pause_t pause = {.gap_ns = (inter + 20) * 1000};
+    CHECK(inter + 20 < PSX_CLK_TIMEOUT_US);
+    sim_spawn("console", SIM_EXTERNAL, pause_task, &pause);
+    CHECK(sim_run(10000000));
+
+    // One timeout, then the estimate is back at the profile limit and the
+    // console's pace is learned without tripping again
+    printf("     learned %u us, console pauses %u us: polls %s/%s/%s\n", inter, inter + 20,
+           answered(&pause.result[0]) ? "ok" : "cut", answered(&pause.result[1]) ? "ok" : "cut",
+           answered(&pause.result[2]) ? "ok" : "cut");
+    CHECK_EQ(timeouts(PSX_TIMEOUT_INTER_BYTE), 1);
+    CHECK(!answered(&pause.result[0]));
+    CHECK(answered(&pause.result[1]));
+    CHECK(answered(&pause.result[2]));
+}
+
+// ============================================================================
+// SEL Releases
+// ============================================================================
+
+static void abort_task(void *arg)
+{
+    console_t console = console_default(0);
+    static const uint8_t poll[] = {0x01, 0x42, 0x00, 0x00, 0x00};
+    for (uint8_t abort_after = 1; abort_after < sizeof(poll); abort_after++)
+    {
+        console_result_t result;
+        console_exchange(&console, poll, sizeof(poll), abort_after, &result);
+        sim_delay_ns(100000);
+    }
+}
+
+static void test_abort_not_counted(void)
+{
+    boot_warm();
+    sim_spawn("console", SIM_EXTERNAL, abort_task, NULL);
+    CHECK(sim_run(10000000));
+    for (int stage = 0; stage < PSX_TIMEOUT_STAGE_COUNT; stage++)
+    {
+        CHECK_EQ(timeouts((psx_timeout_stage_t)stage), 0);
+    }
+}
+
+int main(void)
+{
+    RUN(test_learned_values);
+    RUN(test_stalled_console);
+    RUN(test_backoff);
+    RUN(test_abort_not_counted);
+    return TEST_EXIT();
+}
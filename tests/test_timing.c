@@ -0,0 +1,191 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Bus speed detection over the simulated bus at several console clock
+// rates: which profile is picked, that it stays put at 750 kHz, and the
+// ACK auto-tune sweep on a PS1
+
+#include "test.h"
+#include "sim.h"
+#include "console.h"
+#include "firmware.h"
+#include "config.h"
+#include "psx_bitbang.h"
+#include "shared_state.h"
+
+#define MAX_RATES 4
+
+typedef struct
+{
+    uint32_t khz[MAX_RATES]; // Rates used in turn, one per poll
+    int rates;
+    int polls;
+    int answered_late;      // Polls answered in the second half
+    uint32_t switches;      // Profile switches during the run
+    uint32_t switches_late; // In the second half
+} script_t;
+
+static void console_task(void *arg)
+{
+    script_t *script = arg;
+    console_t console = console_default(0);
+    uint32_t switches_half = 0;
+
+    for (int i = 0; i < script->polls; i++)
+    {
+        if (i == script->polls / 2)
+        {
+            switches_half = psx_timing_get_switches(0);
+        }
+        console.clock_khz = script->khz[i % script->rates];
+        console_result_t result;
+        console_poll(&console, &result);
+        if (result.len == 5 && result.dat[1] == 0x41 && result.dat[2] == 0x5A && result.dat[3] == 0xFF)
+        {
+            script->answered_late += i >= script->polls / 2;
+        }
+        sim_delay_ns(100000);
+    }
+    script->switches_late = psx_timing_get_switches(0) - switches_half;
+}
+
+static void run(script_t *script)
+{
+    firmware_boot();
+    shared_state_write(0, 0xFF, 0xFF);
+    uint32_t switches = psx_timing_get_switches(0);
+    sim_spawn("console", SIM_EXTERNAL, console_task, script);
+    CHECK(sim_run(10000000));
+    script->switches = psx_timing_get_switches(0) - switches;
+}
+
+static void test_ps1_profile_is_fixed_timing(void)
+{
+    firmware_boot();
+    const psx_timing_profile_t *profile = psx_timing_get_profile(0);
+    CHECK_EQ(profile->min_khz, 0);
+    CHECK_EQ(profile->clk_timeout_us, PSX_CLK_TIMEOUT_US);
+    CHECK_EQ(profile->ack_delay_us, ACK_PRE_DELAY_US);
+    CHECK_EQ(profile->ack_pulse_us, ACK_PULSE_WIDTH_US);
+    CHECK_EQ(profile->ack_post_wait_us, ACK_POST_WAIT_US);
+}
+
+// One speed per run; the profile settles in the first half and every poll
+// of the second half is answered
+static void test_rates(void)
+{
+    static const struct
+    {
+        uint32_t khz;
+        uint32_t min_khz; // Profile expected
+    } cases[] = {{250, 0}, {500, 375}, {750, 750}, {1000, 750}};
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        script_t script = {.khz = {cases[i].khz}, .rates = 1, .polls = 200};
+        run(&script);
+        printf("     %4u kHz: %s (%u kHz measured), %u switches\n", cases[i].khz, psx_timing_get_profile(0)->name,
+               psx_timing_get_clock_khz(0), script.switches);
+        CHECK_EQ(psx_timing_get_profile(0)->min_khz, cases[i].min_khz);
+        CHECK_EQ(script.switches_late, 0);
+        CHECK_EQ(script.answered_late, script.polls / 2);
+    }
+}
+
+// Around 750 kHz the measurement alternates between two readings either
+// side of the Fast threshold; the profile must reach Fast and stay there
+static void test_near_boundary(void)
+{
+    static const uint32_t khz[] = {720, 735, 750, 765, 790, 800};
+    for (size_t i = 0; i < sizeof(khz) / sizeof(khz[0]); i++)
+    {
+        script_t script = {.khz = {khz[i]}, .rates = 1, .polls = 200};
+        run(&script);
+        printf("     %4u kHz: %s, %u switches\n", khz[i], psx_timing_get_profile(0)->name, script.switches);
+        CHECK_EQ(psx_timing_get_profile(0)->min_khz, 750);
+        CHECK(script.switches <= 2); // PS1 -> PS2 -> Fast at most
+        CHECK_EQ(script.switches_late, 0);
+        CHECK_EQ(script.answered_late, script.polls / 2);
+    }
+
+    // A console whose clock wanders across the threshold poll by poll
+    script_t script = {.khz = {700, 760, 790, 740}, .rates = 4, .polls = 200};
+    run(&script);
+    printf("     700-790 kHz: %s, %u switches\n", psx_timing_get_profile(0)->name, script.switches);
+    CHECK_EQ(psx_timing_get_profile(0)->min_khz, 750);
+    CHECK(script.switches <= 2);
+    CHECK_EQ(script.answered_late, script.polls / 2);
+}
+
+// ACK auto-tune on a PS1: every pulse width from the widest down is tried,
+// each with every post-ACK wait, before it locks
+typedef struct
+{
+    bool tried[ACK_PULSE_WIDTH_MAX + 1][ACK_POST_WAIT_MAX + 1];
+    bool locked;
+} sweep_t;
+
+static void sweep_task(void *arg)
+{
+    sweep_t *sweep = arg;
+    console_t console = console_default(0);
+    for (int i = 0; i < 1000 && !psx_ack_is_tuning_complete(0); i++)
+    {
+        uint32_t pulse = psx_ack_get_pulse_width(0);
+        uint32_t wait = psx_ack_get_post_wait(0);
+        if (pulse <= ACK_PULSE_WIDTH_MAX && wait <= ACK_POST_WAIT_MAX)
+        {
+            sweep->tried[pulse][wait] = true;
+        }
+        console_result_t result;
+        console_poll(&console, &result);
+        sim_delay_ns(100000);
+    }
+    sweep->locked = psx_ack_is_tuning_complete(0);
+}
+
+static void test_ps1_tune_sweep(void)
+{
+    sweep_t sweep = {0};
+    firmware_boot();
+    shared_state_write(0, 0xFF, 0xFF);
+    sim_spawn("console", SIM_EXTERNAL, sweep_task, &sweep);
+    CHECK(sim_run(1000000));
+
+    CHECK_EQ(psx_timing_get_profile(0)->min_khz, 0);
+    CHECK(sweep.locked);
+    int missing = 0;
+    for (int pulse = ACK_PULSE_WIDTH_MIN; pulse <= ACK_PULSE_WIDTH_MAX; pulse += ACK_PULSE_WIDTH_STEP)
+    {
+        for (int wait = ACK_POST_WAIT_MIN; wait <= ACK_POST_WAIT_MAX; wait += ACK_POST_WAIT_STEP)
+        {
+            missing += !sweep.tried[pulse][wait];
+        }
+    }
+    CHECK_EQ(missing, 0);
+    CHECK(sweep.tried[ACK_PULSE_WIDTH_MAX][ACK_POST_WAIT_MIN]);
+}
+
+int main(void)
+{
+    RUN(test_ps1_profile_is_fixed_timing);
+    RUN(test_rates);
+    RUN(test_near_boundary);
+    RUN(test_ps1_tune_sweep);
+    return TEST_EXIT();
+}
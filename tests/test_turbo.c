@@ -0,0 +1,165 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Turbo phase pattern as seen by a console polling over the simulated bus
+
+#include "test.h"
+#include "sim.h"
+#include "console.h"
+#include "firmware.h"
+#include "shared_state.h"
+#include "turbo.h"
+
+#define CROSS_BIT (1u << PSX_BTN_CROSS)
+#define MAX_POLLS 16
+
+// One console transaction: command byte and the pad's CROSS state before it
+typedef struct
+{
+    uint8_t cmd;
+    bool cross_held;
+} step_t;
+
+typedef struct
+{
+    const step_t *steps;
+    int count;
+    bool cross_seen[MAX_POLLS]; // CROSS pressed in the poll answer
+    bool answered[MAX_POLLS];   // 0x5A ID byte returned
+} script_t;
+
+static void console_task(void *arg)
+{
+    script_t *script = arg;
+    console_t console = console_default(0);
+
+    for (int i = 0; i < script->count; i++)
+    {
+        // Live input as the button task would publish it (CROSS = btn2 bit 6)
+        uint16_t buttons = script->steps[i].cross_held ? (uint16_t)(0xFFFF & ~CROSS_BIT) : 0xFFFF;
+        shared_state_write(0, (uint8_t)(buttons & 0xFF), (uint8_t)(buttons >> 8));
+
+        uint8_t cmd[5] = {0x01, script->steps[i].cmd, 0x00, 0x00, 0x00};
+        console_result_t result;
+        console_exchange(&console, cmd, sizeof(cmd), sizeof(cmd), &result);
+        script->answered[i] = result.len == 5 && result.dat[2] == 0x5A;
+        uint16_t seen = (uint16_t)(result.dat[3] | (result.dat[4] << 8));
+        script->cross_seen[i] = !(seen & CROSS_BIT);
+
+        // Idle bus between transactions
+        sim_delay_ns(200000);
+    }
+}
+
+static void run_script(script_t *script, uint16_t mask, uint8_t rate)
+{
+    firmware_boot();
+    turbo_set_mask(mask);
+    CHECK(turbo_set_rate(rate));
+    sim_spawn("console", SIM_EXTERNAL, console_task, script);
+    CHECK(sim_run(100000));
+}
+
+static void check_pattern(const script_t *script, const char *expected)
+{
+    // expected: 'P' pressed, 'r' released, '-' not a poll
+    for (int i = 0; i < script->count; i++)
+    {
+        if (expected[i] == '-')
+        {
+            continue;
+        }
+        CHECK(script->answered[i]);
+        if (script->cross_seen[i] != (expected[i] == 'P'))
+        {
+            fprintf(stderr, "  poll %d: CROSS %s, expected %s\n", i, script->cross_seen[i] ? "pressed" : "released",
+                    expected[i] == 'P' ? "pressed" : "released");
+            test_failures++;
+        }
+    }
+}
+
+static void test_rate_two(void)
+{
+    static const step_t steps[] = {
+        {0x42, true}, {0x42, true}, {0x42, true}, {0x42, true}, {0x42, true}, {0x42, true},
+    };
+    script_t script = {.steps = steps, .count = 6};
+    run_script(&script, CROSS_BIT, 2);
+    check_pattern(&script, "PPrrPP");
+}
+
+static void test_rate_one_and_max(void)
+{
+    static const step_t steps[] = {
+        {0x42, true}, {0x42, true}, {0x42, true}, {0x42, true},
+    };
+    script_t fast = {.steps = steps, .count = 4};
+    run_script(&fast, CROSS_BIT, TURBO_RATE_MIN);
+    check_pattern(&fast, "PrPr");
+
+    script_t slow = {.steps = steps, .count = 4};
+    run_script(&slow, CROSS_BIT, TURBO_RATE_MAX);
+    check_pattern(&slow, "PPPP");
+
+    CHECK(!turbo_set_rate(0));
+    CHECK(!turbo_set_rate(TURBO_RATE_MAX + 1));
+}
+
+static void test_release_restarts(void)
+{
+    // Letting go mid-pattern starts the next press with a pressed phase
+    static const step_t steps[] = {
+        {0x42, true}, {0x42, true}, {0x42, true}, {0x42, false}, {0x42, true}, {0x42, true}, {0x42, true},
+    };
+    script_t script = {.steps = steps, .count = 7};
+    run_script(&script, CROSS_BIT, 2);
+    check_pattern(&script, "PPrrPPr");
+}
+
+static void test_other_commands_hold_phase(void)
+{
+    // 0x43 transactions between polls do not advance the pattern
+    static const step_t steps[] = {
+        {0x42, true}, {0x43, true}, {0x43, true}, {0x42, true}, {0x43, true}, {0x42, true}, {0x42, true},
+    };
+    script_t script = {.steps = steps, .count = 7};
+    run_script(&script, CROSS_BIT, 2);
+    check_pattern(&script, "P--P-rr");
+}
+
+static void test_not_turbo_button(void)
+{
+    // Buttons outside the mask pass through held
+    static const step_t steps[] = {
+        {0x42, true}, {0x42, true}, {0x42, true}, {0x42, true},
+    };
+    script_t script = {.steps = steps, .count = 4};
+    run_script(&script, 1u << PSX_BTN_SQUARE, 1);
+    check_pattern(&script, "PPPP");
+}
+
+int main(void)
+{
+    RUN(test_rate_two);
+    RUN(test_rate_one_and_max);
+    RUN(test_release_restarts);
+    RUN(test_other_commands_hold_phase);
+    RUN(test_not_turbo_button);
+    return TEST_EXIT();
+}
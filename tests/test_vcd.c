@@ -0,0 +1,196 @@
+/*
+ * PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+ * Copyright (C) 2024-2025 ntsklab
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Waveform trace of the simulated bus: a poll written as VCD and read back,
+// its edges counted, in order, and the bytes decoded from the levels
+
+#include "test.h"
+#include "sim.h"
+#include "console.h"
+#include "firmware.h"
+#include "psx_bitbang.h"
+#include "shared_state.h"
+#include <string.h>
+#include <unistd.h>
+
+#define VCD_PATH "test_vcd.vcd"
+
+enum
+{
+    SEL,
+    CLK,
+    CMD,
+    DAT,
+    ACK,
+    SIGNALS
+};
+
+static const char *const names[SIGNALS] = {"SEL", "CLK", "CMD", "DAT", "ACK"};
+
+static void poll_task(void *arg)
+{
+    console_t console = console_default(0);
+    sim_delay_ns(10000); // After the levels at the trace start
+    console_poll(&console, arg);
+    sim_delay_ns(20000);
+}
+
+typedef struct
+{
+    bool header_ok;
+    bool time_ordered;
+    int changes[SIGNALS];
+    int bytes;
+    uint8_t cmd[8];
+    uint8_t dat[8];
+    uint64_t sel_fall, sel_rise, first_clk, last_clk;
+} waveform_t;
+
+// Read the VCD back like a viewer would: levels over time, bits sampled on
+// CLK rising edges while SEL is LOW
+static void read_vcd(waveform_t *wave)
+{
+    memset(wave, 0, sizeof(*wave));
+    wave->time_ordered = true;
+    FILE *f = fopen(VCD_PATH, "r");
+    CHECK(f != NULL);
+    if (f == NULL)
+    {
+        return;
+    }
+
+    char line[128];
+    int vars = 0;
+    bool defined = false, initial = true;
+    int stamps = 0;
+    bool level[SIGNALS] = {0};
+    int bit = 0;
+    uint64_t time = 0;
+    while (fgets(line, sizeof(line), f))
+    {
+        if (!defined)
+        {
+            char code, name[16];
+            if (sscanf(line, "$var wire 1 %c %15s $end", &code, name) == 2)
+            {
+                vars += code == 33 + vars && strcmp(name, names[vars]) == 0;
+            }
+            defined = strncmp(line, "$enddefinitions", 15) == 0;
+            wave->header_ok = vars == SIGNALS && defined;
+            continue;
+        }
+        if (line[0] == '#')
+        {
+            unsigned long long at = strtoull(line + 1, NULL, 10);
+            if (at < time)
+            {
+                wave->time_ordered = false;
+            }
+            initial = stamps++ == 0;
+            time = at;
+            continue;
+        }
+
+        int signal = line[1] - 33;
+        if ((line[0] != '0' && line[0] != '1') || signal < 0 || signal >= SIGNALS)
+        {
+            continue;
+        }
+        bool value = line[0] == '1';
+        level[signal] = value;
+        if (initial)
+        {
+            continue; // Levels when the trace opened
+        }
+        wave->changes[signal]++;
+
+        if (signal == SEL)
+        {
+            *(value ? &wave->sel_rise : &wave->sel_fall) = time;
+        }
+        if (signal == CLK && !wave->first_clk)
+        {
+            wave->first_clk = time;
+        }
+        if (signal == CLK && value && !level[SEL] && wave->bytes < 8)
+        {
+            wave->last_clk = time;
+            wave->cmd[wave->bytes] |= (uint8_t)(level[CMD] << bit);
+            wave->dat[wave->bytes] |= (uint8_t)(level[DAT] << bit);
+            if (++bit == 8)
+            {
+                bit = 0;
+                wave->bytes++;
+            }
+        }
+    }
+    fclose(f);
+}
+
+static void test_poll_waveform(void)
+{
+    firmware_boot();
+    shared_state_write(0, 0xFE, 0x7F);
+    CHECK(firmware_trace_port(0, VCD_PATH));
+
+    console_result_t result;
+    sim_spawn("console", SIM_EXTERNAL, poll_task, &result);
+    CHECK(sim_run(1000));
+    sim_trace_close();
+
+    waveform_t wave;
+    read_vcd(&wave);
+    CHECK(wave.header_ok);
+    CHECK(wave.time_ordered);
+
+    // One SEL period around 5 bytes of 8 clocks, 4 ACK pulses (none after the last byte)
+    CHECK_EQ(wave.changes[SEL], 2);
+    CHECK_EQ(wave.changes[CLK], 5 * 8 * 2);
+    CHECK_EQ(wave.changes[ACK], 4 * 2);
+    CHECK(wave.sel_fall < wave.first_clk && wave.last_clk < wave.sel_rise);
+
+    static const uint8_t cmd[5] = {0x01, 0x42, 0x00, 0x00, 0x00};
+    static const uint8_t dat[5] = {0xFF, 0x41, 0x5A, 0xFE, 0x7F};
+    CHECK_EQ(wave.bytes, 5);
+    CHECK(memcmp(wave.cmd, cmd, 5) == 0);
+    CHECK(memcmp(wave.dat, dat, 5) == 0);
+    CHECK(memcmp(result.dat, dat, 5) == 0);
+    remove(VCD_PATH);
+}
+
+// Time starts over on a reset, so it ends the trace
+static void test_reset_closes(void)
+{
+    firmware_boot();
+    CHECK(firmware_trace_port(0, VCD_PATH));
+    firmware_boot();
+    sim_drive(psx_port_pins[0].sel, 0);
+
+    waveform_t wave;
+    read_vcd(&wave);
+    CHECK(wave.header_ok);
+    CHECK_EQ(wave.changes[SEL], 0);
+    remove(VCD_PATH);
+}
+
+int main(void)
+{
+    RUN(test_poll_waveform);
+    RUN(test_reset_closes);
+    return TEST_EXIT();
+}
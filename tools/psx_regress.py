@@ -0,0 +1,168 @@
+#!/usr/bin/env python3
+#
+# PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+# Copyright (C) 2024-2025 ntsklab
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+"""Compare recorded bus sessions against golden captures.
+
+Corpus layout: one directory, two raw sniffer streams per session
+
+    <session>.golden.bin   reference (official pad, or a known-good build)
+    <session>.bin          capture of the build under test, same game input
+
+Transactions are compared in order. For each session the runner reports
+DAT byte mismatches, missing or extra ACKs, and ACK placement regressions
+(delay after the byte beyond the golden maximum plus a tolerance). If the
+console sends a different CMD stream the session is reported as diverged
+from that transaction on, since the two recordings stopped being comparable.
+
+Sessions are checked in parallel, one process per core.
+
+    psx_regress.py corpus/ --ack-tolerance 1
+
+This compares two hardware captures. To check a build without hardware,
+export the golden capture with `psx_sniff.py --session` and replay it on
+the host with tests/replay/psx_replay, which also reports the CLK-edge-to-
+DAT latency a byte-level capture can't show.
+"""
+
+import argparse
+import multiprocessing
+import os
+import sys
+
+import psx_sniff
+
+MAX_LISTED = 5  # Mismatches printed per session
+
+
+class Result:
+    __slots__ = ("name", "compared", "mismatches", "ack_missing", "ack_extra",
+                 "ack_late", "golden_ack_max", "ack_max", "diverged", "length_delta", "details")
+
+    def __init__(self, name):
+        self.name = name
+        self.compared = 0
+        self.mismatches = 0
+        self.ack_missing = 0
+        self.ack_extra = 0
+        self.ack_late = 0
+        self.golden_ack_max = 0
+        self.ack_max = 0
+        self.diverged = None  # Transaction index where CMD streams differ
+        self.length_delta = 0
+        self.details = []
+
+    @property
+    def failed(self):
+        return bool(self.mismatches or self.ack_missing or self.ack_extra or self.ack_late
+                    or self.diverged is not None)
+
+    def note(self, text):
+        if len(self.details) < MAX_LISTED:
+            self.details.append(text)
+
+
+def load(path):
+    return list(psx_sniff.iter_transactions(psx_sniff.read_file(path)))
+
+
+def compare_session(job):
+    name, golden_path, capture_path, ack_tolerance = job
+    result = Result(name)
+    golden = load(golden_path)
+    capture = load(capture_path)
+    result.length_delta = len(capture) - len(golden)
+
+    # Golden ACK placement bounds the allowed delay
+    for transaction in golden:
+        for ack in transaction.ack:
+            if ack is not None:
+                result.golden_ack_max = max(result.golden_ack_max, ack)
+    ack_limit = result.golden_ack_max + ack_tolerance
+
+    for index, (want, got) in enumerate(zip(golden, capture)):
+        if bytes(want.cmd) != bytes(got.cmd):
+            result.diverged = index
+            result.note(f"#{index}: CMD diverged {want.cmd.hex()} vs {got.cmd.hex()}")
+            break
+
+        result.compared += 1
+        for pos, (want_dat, got_dat) in enumerate(zip(want.dat, got.dat)):
+            if want_dat != got_dat:
+                result.mismatches += 1
+                result.note(f"#{index} byte {pos}: DAT {got_dat:02X}, expected {want_dat:02X}")
+
+        for pos, (want_ack, got_ack) in enumerate(zip(want.ack, got.ack)):
+            if want_ack is not None and got_ack is None:
+                result.ack_missing += 1
+                result.note(f"#{index} byte {pos}: ACK missing")
+            elif want_ack is None and got_ack is not None:
+                result.ack_extra += 1
+                result.note(f"#{index} byte {pos}: unexpected ACK")
+            elif got_ack is not None:
+                result.ack_max = max(result.ack_max, got_ack)
+                if got_ack > ack_limit:
+                    result.ack_late += 1
+                    result.note(f"#{index} byte {pos}: ACK after {got_ack} us (limit {ack_limit})")
+
+    return result
+
+
+def find_sessions(corpus):
+    for entry in sorted(os.listdir(corpus)):
+        if entry.endswith(".golden.bin"):
+            name = entry[: -len(".golden.bin")]
+            capture = os.path.join(corpus, name + ".bin")
+            if os.path.exists(capture):
+                yield name, os.path.join(corpus, entry), capture
+            else:
+                print(f"{name}: no capture, skipped", file=sys.stderr)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("corpus", help="directory of <session>.golden.bin / <session>.bin pairs")
+    parser.add_argument("--ack-tolerance", type=int, default=1,
+                        help="µs an ACK may trail the golden maximum delay")
+    parser.add_argument("-j", "--jobs", type=int, default=os.cpu_count(), help="worker processes")
+    args = parser.parse_args()
+
+    jobs = [(name, golden, capture, args.ack_tolerance)
+            for name, golden, capture in find_sessions(args.corpus)]
+    if not jobs:
+        parser.error("no sessions found")
+
+    failed = 0
+    with multiprocessing.Pool(args.jobs) as pool:
+        for result in pool.imap_unordered(compare_session, jobs):
+            status = "FAIL" if result.failed else "ok"
+            print(f"{status:4}  {result.name}: {result.compared} transactions, "
+                  f"{result.mismatches} DAT mismatches, ACK missing {result.ack_missing} / "
+                  f"extra {result.ack_extra} / late {result.ack_late}, "
+                  f"ACK max {result.ack_max} us (golden {result.golden_ack_max} us)")
+            if result.length_delta:
+                print(f"      length differs by {result.length_delta:+d} transactions")
+            for detail in result.details:
+                print(f"      {detail}")
+            failed += result.failed
+
+    print(f"\n{len(jobs) - failed}/{len(jobs)} sessions passed")
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,218 @@
+#!/usr/bin/env python3
+#
+# PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+# Copyright (C) 2024-2025 ntsklab
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+"""Decode passive bus captures streamed by the `sniff on` command.
+
+The device sends HOST_FRAME_SNIFF (0x82) frames over the USB serial link,
+interleaved with ordinary console text. This tool picks the frames out of
+the byte stream, checks their CRC and groups the records into transactions
+(one SEL LOW period each).
+
+    psx_sniff.py --port /dev/ttyACM0 --save boot.bin   # live, keep raw stream
+    psx_sniff.py boot.bin                              # decode a saved stream
+    psx_sniff.py boot.bin --session boot.session       # replay input for tests/
+
+A session file is what tests/replay/psx_replay plays back against the
+firmware on the host simulator: the console's CMD bytes with the captured
+DAT bytes and ACKs as the expected answer. The capture doesn't carry the
+CLK rate, so give it with --clock-khz.
+"""
+
+import argparse
+import struct
+import sys
+
+SYNC = 0xA5
+HEADER_LEN = 9
+MAX_PAYLOAD = 64
+FRAME_SNIFF = 0x82
+
+FLAG_START = 0x01
+FLAG_ACK = 0x02
+FLAG_OVERFLOW = 0x04
+
+RECORD = struct.Struct("<IBBBB")  # time_us, cmd, dat, ack_delay, flags
+
+
+def crc8(data):
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def iter_frames(chunks):
+    """Yield (type, seq, payload) for every valid frame in a byte stream."""
+    buf = bytearray()
+    for chunk in chunks:
+        buf += chunk
+        yield from _parse(buf, final=False)
+    yield from _parse(buf, final=True)
+
+
+def _parse(buf, final):
+    while True:
+        start = buf.find(SYNC)
+        if start < 0:
+            buf.clear()
+            return
+        del buf[:start]
+        if len(buf) < 3:
+            return
+        frame_len = HEADER_LEN + buf[2] + 1
+        if buf[2] > MAX_PAYLOAD:
+            del buf[:1]  # Text byte that looked like a sync - resynchronise
+            continue
+        if len(buf) < frame_len:
+            if not final:
+                return
+            del buf[:1]  # Stream ended inside a false frame
+            continue
+        frame = bytes(buf[:frame_len])
+        if crc8(frame[1:-1]) != frame[-1]:
+            del buf[:1]
+            continue
+        del buf[:frame_len]
+        seq = frame[3] | (frame[4] << 8)
+        yield frame[1], seq, frame[HEADER_LEN:-1]
+
+
+def iter_records(chunks):
+    """Yield (time_us, cmd, dat, ack_delay, flags) capture records."""
+    for frame_type, _seq, payload in iter_frames(chunks):
+        if frame_type != FRAME_SNIFF:
+            continue
+        for offset in range(0, len(payload) - RECORD.size + 1, RECORD.size):
+            yield RECORD.unpack_from(payload, offset)
+
+
+class Transaction:
+    """All bytes exchanged during one SEL LOW period."""
+
+    __slots__ = ("time_us", "times", "cmd", "dat", "ack", "overflow")
+
+    def __init__(self, time_us):
+        self.time_us = time_us
+        self.times = []  # Completion time of each byte in µs
+        self.cmd = bytearray()
+        self.dat = bytearray()
+        self.ack = []  # ACK delay per byte in µs, None if no ACK
+        self.overflow = False
+
+    def __str__(self):
+        pairs = " ".join(f"{c:02X}/{d:02X}" for c, d in zip(self.cmd, self.dat))
+        acks = " ".join("-" if a is None else str(a) for a in self.ack)
+        note = "  [records dropped before]" if self.overflow else ""
+        return f"{self.time_us:10d}  {pairs}  ack(us): {acks}{note}"
+
+
+def iter_transactions(chunks):
+    """Group capture records into transactions (32-bit timestamps unwrapped)."""
+    current = None
+    wraps = 0
+    last_time = None
+    for time_us, cmd, dat, ack_delay, flags in iter_records(chunks):
+        if last_time is not None and time_us < last_time:
+            wraps += 1
+        last_time = time_us
+        if flags & FLAG_START or current is None:
+            if current is not None:
+                yield current
+            current = Transaction(time_us + (wraps << 32))
+        current.times.append(time_us + (wraps << 32))
+        current.cmd.append(cmd)
+        current.dat.append(dat)
+        current.ack.append(ack_delay if flags & FLAG_ACK else None)
+        current.overflow |= bool(flags & FLAG_OVERFLOW)
+    if current is not None:
+        yield current
+
+
+def write_session(transactions, out, clock_khz, gap_us):
+    """Write transactions as a replay session (times relative to the first)."""
+    out.write(f"clock_khz {clock_khz}\n")
+    out.write(f"gap_us {gap_us}\n")
+    start = None
+    for transaction in transactions:
+        if start is None:
+            start = transaction.time_us
+        if transaction.overflow:
+            out.write("# records dropped before this transaction\n")
+        cmd = " ".join(f"{c:02X}" for c in transaction.cmd)
+        dat = " ".join(f"{d:02X}" for d in transaction.dat)
+        acks = "".join("-" if a is None else "+" for a in transaction.ack)
+        out.write(f"{transaction.time_us - start} {cmd} | {dat} | {acks}\n")
+
+
+def read_file(path):
+    with open(path, "rb") as f:
+        while chunk := f.read(65536):
+            yield chunk
+
+
+def read_serial(port, save):
+    import serial  # pyserial, only needed for live capture
+
+    with serial.Serial(port, 115200, timeout=0.1) as link:
+        link.write(b"sniff on\n")
+        try:
+            while True:
+                chunk = link.read(4096)
+                if save:
+                    save.write(chunk)
+                yield chunk
+        except KeyboardInterrupt:
+            link.write(b"sniff off\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("capture", nargs="?", help="saved raw stream to decode")
+    parser.add_argument("--port", help="serial port of the Pico for live capture")
+    parser.add_argument("--save", help="write the raw stream to this file (live capture)")
+    parser.add_argument("--session", help="write a replay session for tests/replay instead of printing")
+    parser.add_argument("--clock-khz", type=int, default=250, help="CLK rate of the capture (--session)")
+    parser.add_argument("--gap-us", type=int, default=10, help="ACK to next byte gap to replay (--session)")
+    args = parser.parse_args()
+
+    if args.port:
+        save = open(args.save, "wb") if args.save else None
+        chunks = read_serial(args.port, save)
+    elif args.capture:
+        chunks = read_file(args.capture)
+    else:
+        parser.error("give a capture file or --port")
+
+    if args.session:
+        with open(args.session, "w") as out:
+            write_session(iter_transactions(chunks), out, args.clock_khz, args.gap_us)
+        return
+
+    try:
+        for transaction in iter_transactions(chunks):
+            print(transaction)
+    except BrokenPipeError:
+        pass
+    finally:
+        sys.stdout.flush()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,148 @@
+#!/usr/bin/env python3
+#
+# PSX Controller Bit-Banging Simulator for Raspberry Pi Pico
+# Copyright (C) 2024-2025 ntsklab
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+"""Export PSX bus activity as a Value Change Dump for GTKWave.
+
+VcdWriter streams value changes straight to the output file, so a whole
+game boot can be exported without holding edges in memory. Any edge source
+can drive it; this script feeds it from sniffer captures (see psx_sniff.py).
+The host simulator writes the same layout from its real edges (PSX_VCD=<file>,
+see tests/sim/sim.c).
+
+The sniffer records bytes, not edges, so the waveform is rebuilt: each
+byte's 8 clock cycles end at its recorded completion time, CMD/DAT change
+on CLK falling edges, and ACK is drawn at the recorded delay. CLK period
+and ACK width are not captured and come from the command line.
+
+    psx_vcd.py boot.bin -o boot.vcd --clk-khz 250
+"""
+
+import argparse
+import sys
+
+import psx_sniff
+
+SIGNALS = ("SEL", "CLK", "CMD", "DAT", "ACK")
+SEL, CLK, CMD, DAT, ACK = range(len(SIGNALS))
+
+
+class VcdWriter:
+    """Streaming VCD writer for 1-bit signals. Times must not go backwards."""
+
+    def __init__(self, out, signals, timescale="1ns", module="psx"):
+        self._out = out
+        self._time = None
+        self._values = [None] * len(signals)
+
+        # Change lines are prebuilt so emitting an edge allocates nothing
+        ids = [chr(33 + i) for i in range(len(signals))]
+        self._lines = [(f"0{code}\n", f"1{code}\n") for code in ids]
+
+        out.write(f"$timescale {timescale} $end\n")
+        out.write(f"$scope module {module} $end\n")
+        for name, code in zip(signals, ids):
+            out.write(f"$var wire 1 {code} {name} $end\n")
+        out.write("$upscope $end\n$enddefinitions $end\n")
+
+    def change(self, time, signal, value):
+        if self._values[signal] == value:
+            return
+        if time != self._time:
+            if self._time is not None and time < self._time:
+                time = self._time  # Clamp reconstruction overlap
+            else:
+                self._out.write(f"#{time}\n")
+                self._time = time
+        self._values[signal] = value
+        self._out.write(self._lines[signal][value])
+
+    def close(self, time=None):
+        if time is not None and (self._time is None or time > self._time):
+            self._out.write(f"#{time}\n")
+        self._out.flush()
+
+
+def write_transaction(vcd, transaction, period_ns, ack_width_ns, next_start_ns):
+    half = period_ns // 2
+    first_start = transaction.times[0] * 1000 - 8 * period_ns
+
+    vcd.change(first_start - period_ns, SEL, 0)
+    for index, end_us in enumerate(transaction.times):
+        end = end_us * 1000
+        start = end - 8 * period_ns
+        cmd = transaction.cmd[index]
+        dat = transaction.dat[index]
+
+        # LSB first: lines change on CLK falling, sampled on CLK rising
+        for bit in range(8):
+            fall = start + bit * period_ns
+            vcd.change(fall, CLK, 0)
+            vcd.change(fall, CMD, (cmd >> bit) & 1)
+            vcd.change(fall, DAT, (dat >> bit) & 1)
+            vcd.change(fall + half, CLK, 1)
+
+        # Lines idle HIGH between bytes
+        vcd.change(end + half, CMD, 1)
+        vcd.change(end + half, DAT, 1)
+
+        ack = transaction.ack[index]
+        if ack is not None:
+            vcd.change(end + ack * 1000, ACK, 0)
+            vcd.change(end + ack * 1000 + ack_width_ns, ACK, 1)
+
+    sel_rise = transaction.times[-1] * 1000 + 2 * period_ns
+    if next_start_ns is not None:
+        sel_rise = min(sel_rise, next_start_ns)
+    vcd.change(sel_rise, SEL, 1)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("capture", help="raw stream saved by psx_sniff.py --save")
+    parser.add_argument("-o", "--output", help="VCD file (default: stdout)")
+    parser.add_argument("--clk-khz", type=int, default=250, help="bus clock used for reconstruction")
+    parser.add_argument("--ack-width", type=float, default=2.0, help="ACK pulse width in µs")
+    args = parser.parse_args()
+
+    period_ns = 1000000 // args.clk_khz
+    ack_width_ns = int(args.ack_width * 1000)
+    out = open(args.output, "w", buffering=1 << 20) if args.output else sys.stdout
+
+    vcd = VcdWriter(out, SIGNALS)
+    for signal in range(len(SIGNALS)):
+        vcd.change(0, signal, 1)
+
+    # One transaction of lookahead so SEL never rises after the next one starts
+    pending = None
+    for transaction in psx_sniff.iter_transactions(psx_sniff.read_file(args.capture)):
+        if pending is not None:
+            next_start = transaction.times[0] * 1000 - 9 * period_ns
+            write_transaction(vcd, pending, period_ns, ack_width_ns, next_start)
+        pending = transaction
+    if pending is not None:
+        write_transaction(vcd, pending, period_ns, ack_width_ns, None)
+        vcd.close(pending.times[-1] * 1000 + 10 * period_ns)
+    else:
+        vcd.close()
+
+    if out is not sys.stdout:
+        out.close()
+
+
+if __name__ == "__main__":
+    main()